@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Compare two JSON result files written by cpa_bench --json.
+
+For every benchmark present in both files, the median time per operation of the current results is compared to the baseline.
+A change is only reported as a regression or an improvement if it exceeds the threshold and the combined standard deviation of
+both measurements, so that noisy benchmarks are not flagged.
+
+With --metric, a hardware counter recorded by cpa_bench --perf, like cycles or divider_active, is compared instead. Counters
+have no recorded variance, so only the threshold applies to them.
+
+Usage: compare.py [--threshold PERCENT] [--metric NAME] [--fail-on-regression] BASELINE CURRENT
+"""
+
+import argparse
+import json
+import math
+import sys
+
+
+def load(path):
+    with open(path) as file:
+        return {benchmark["name"]: benchmark for benchmark in json.load(file)["benchmarks"]}
+
+
+def metric(benchmark, name):
+    if name == "ns_per_op":
+        return benchmark["ns_per_op"], benchmark["stddev"]
+    value = benchmark.get("counters", {}).get(name)
+    return (value, 0.0) if value is not None else (None, None)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare cpa_bench results against a baseline")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=5.0, help="minimum relative change in percent (default: 5)")
+    parser.add_argument("--metric", default="ns_per_op", help="ns_per_op or the name of a hardware counter")
+    parser.add_argument("--fail-on-regression", action="store_true", help="exit with status 1 if a benchmark regressed")
+    arguments = parser.parse_args()
+
+    baseline = load(arguments.baseline)
+    current = load(arguments.current)
+    regressions = 0
+
+    print("{:<40} {:>12} {:>12} {:>9}  {}".format("benchmark", "baseline", "current", "change", "verdict"))
+
+    for name, result in current.items():
+        after, after_noise = metric(result, arguments.metric)
+        if after is None:
+            continue
+
+        before, before_noise = metric(baseline[name], arguments.metric) if name in baseline else (None, None)
+        if before is None:
+            print("{:<40} {:>12} {:>12.3f} {:>9}  new".format(name, "-", after, "-"))
+            continue
+
+        change = 100.0 * (after - before) / before if before else 0.0
+        noise = math.hypot(before_noise, after_noise)
+
+        verdict = ""
+        if abs(change) > arguments.threshold and abs(after - before) > 2 * noise:
+            verdict = "REGRESSION" if change > 0 else "improvement"
+            regressions += change > 0
+
+        print("{:<40} {:>12.3f} {:>12.3f} {:>+8.1f}%  {}".format(name, before, after, change, verdict))
+
+    for name in baseline:
+        before, _ = metric(baseline[name], arguments.metric)
+        if name not in current and before is not None:
+            print("{:<40} {:>12.3f} {:>12} {:>9}  missing".format(name, before, "-", "-"))
+
+    if regressions:
+        print("\n{} benchmark(s) regressed".format(regressions))
+
+    return 1 if regressions and arguments.fail_on_regression else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Measure the compile time cost of the CPA headers.
+
+For every public header, a translation unit including only that header is compiled, and the following is reported:
+
+  * the best wall clock time of --runs front end passes (-fsyntax-only)
+  * the number of lines after preprocessing
+  * the number of template instantiations, counted from the tree dump of GCC or the time trace of Clang
+
+The probe translation unit, which uses the common operations for the common representation types, is additionally compiled to
+an object file with and without CPA_EXTERN_TEMPLATES, to show how much code generation the explicit instantiations save.
+
+With --baseline, the line and instantiation counts are compared to a JSON file previously written with --json. Since they are
+deterministic, unlike the timings, any growth beyond --tolerance is reported as a regression and makes the script fail.
+
+Usage: compile_time.py [--compiler CXX] [--include DIR] [--probe FILE] [--runs N] [--json FILE] [--baseline FILE]
+                       [--tolerance PERCENT] [HEADER...]
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+FLAGS = ["-std=c++14", "-pedantic", "-Wall", "-Wextra", "-O0"]
+GCC_INSTANTIATION = re.compile(r"^;; Function .*\[with ")
+CLANG_INSTANTIATION = re.compile(r'"name":\s*"Instantiate(Class|Function)"')
+
+
+def is_clang(compiler):
+    output = subprocess.run([compiler, "--version"], stdout=subprocess.PIPE, universal_newlines=True).stdout
+    return "clang" in output
+
+
+def compile(compiler, arguments, cwd):
+    process = subprocess.run([compiler] + arguments, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                             universal_newlines=True)
+    if process.returncode:
+        sys.exit("compilation failed: {}\n{}".format(" ".join(arguments), process.stderr))
+    return process.stdout
+
+
+def best_time(compiler, arguments, cwd, runs):
+    best = float("inf")
+    for _ in range(runs):
+        start = time.perf_counter()
+        compile(compiler, arguments, cwd)
+        best = min(best, time.perf_counter() - start)
+    return best
+
+
+def instantiations(compiler, clang, arguments, cwd):
+    if clang:
+        compile(compiler, arguments + ["-ftime-trace", "-ftime-trace-granularity=0", "-c", "-o", "trace.o"], cwd)
+        with open(os.path.join(cwd, "trace.json")) as trace:
+            return len(CLANG_INSTANTIATION.findall(trace.read()))
+
+    compile(compiler, arguments + ["-fsyntax-only", "-fdump-tree-original=dump.txt"], cwd)
+    with open(os.path.join(cwd, "dump.txt")) as dump:
+        return sum(1 for line in dump if GCC_INSTANTIATION.match(line))
+
+
+def measure(compiler, clang, source, include, runs, definitions=()):
+    with tempfile.TemporaryDirectory() as directory:
+        with open(os.path.join(directory, "trace.cpp"), "w") as file:
+            file.write(source)
+
+        arguments = FLAGS + ["-I" + include] + ["-D" + definition for definition in definitions] + ["trace.cpp"]
+        preprocessed = compile(compiler, arguments + ["-E", "-P"], directory)
+
+        return {
+            "seconds": round(best_time(compiler, arguments + ["-fsyntax-only"], directory, runs), 4),
+            "lines": preprocessed.count("\n"),
+            "instantiations": instantiations(compiler, clang, arguments, directory),
+        }
+
+
+def measure_object(compiler, source, include, runs, definitions=()):
+    with tempfile.TemporaryDirectory() as directory:
+        arguments = FLAGS + ["-I" + include] + ["-D" + definition for definition in definitions]
+        arguments += ["-c", os.path.abspath(source), "-o", "probe.o"]
+        seconds = best_time(compiler, arguments, directory, runs)
+        return {"object_seconds": round(seconds, 4), "object_bytes": os.path.getsize(os.path.join(directory, "probe.o"))}
+
+
+def compare(baseline, current, tolerance):
+    regressions = 0
+    print("\n{:<40} {:>14} {:>14} {:>9}  {}".format("measurement", "baseline", "current", "change", "verdict"))
+
+    for name, result in sorted(current.items()):
+        for metric in ("lines", "instantiations", "object_bytes"):
+            if metric not in result or metric not in baseline.get(name, {}):
+                continue
+
+            before = baseline[name][metric]
+            after = result[metric]
+            change = 100.0 * (after - before) / before if before else 0.0
+            verdict = "REGRESSION" if change > tolerance else "improvement" if change < -tolerance else ""
+            regressions += verdict == "REGRESSION"
+
+            print("{:<40} {:>14} {:>14} {:>+8.1f}%  {}".format(name + " " + metric, before, after, change, verdict))
+
+    if regressions:
+        print("\n{} measurement(s) regressed".format(regressions))
+
+    return regressions
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+    parser = argparse.ArgumentParser(description="Measure the compile time cost of the CPA headers")
+    parser.add_argument("headers", nargs="*", help="the headers to measure (default: all public headers)")
+    parser.add_argument("--compiler", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--include", default=os.path.join(root, "include"))
+    parser.add_argument("--probe", default=os.path.join(root, "bench", "compile_time_probe.cpp"))
+    parser.add_argument("--runs", type=int, default=3, help="number of timed compilations, of which the best is reported")
+    parser.add_argument("--json", help="write the results to this file")
+    parser.add_argument("--baseline", help="compare the results against this file written with --json")
+    parser.add_argument("--tolerance", type=float, default=1.0, help="allowed growth in percent (default: 1)")
+    arguments = parser.parse_args()
+
+    clang = is_clang(arguments.compiler)
+    headers = arguments.headers or sorted(os.path.basename(path) for path in glob.glob(os.path.join(arguments.include, "*.h")))
+    results = {}
+
+    print("{:<40} {:>10} {:>10} {:>15}".format("translation unit", "seconds", "lines", "instantiations"))
+
+    for header in headers:
+        result = measure(arguments.compiler, clang, "#include <{}>\n".format(header), arguments.include, arguments.runs)
+        results[header] = result
+        print("{:<40} {:>10.3f} {:>10} {:>15}".format(header, result["seconds"], result["lines"], result["instantiations"]))
+
+    with open(arguments.probe) as probe:
+        source = probe.read()
+
+    for name, definitions in (("probe", ()), ("probe (extern templates)", ("CPA_EXTERN_TEMPLATES",))):
+        result = measure(arguments.compiler, clang, source, arguments.include, arguments.runs, definitions)
+        result.update(measure_object(arguments.compiler, arguments.probe, arguments.include, arguments.runs, definitions))
+        results[name] = result
+        print("{:<40} {:>10.3f} {:>10} {:>15}   object: {:.3f} s, {} bytes".format(
+            name, result["seconds"], result["lines"], result["instantiations"], result["object_seconds"],
+            result["object_bytes"]))
+
+    if arguments.json:
+        with open(arguments.json, "w") as file:
+            json.dump({"compiler": arguments.compiler, "clang": clang, "results": results}, file, indent=2, sort_keys=True)
+
+    if arguments.baseline:
+        with open(arguments.baseline) as file:
+            if compare(json.load(file)["results"], results, arguments.tolerance):
+                return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
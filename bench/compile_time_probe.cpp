@@ -0,0 +1,35 @@
+#include <numeric.h>
+#include <rational.h>
+
+/*
+ * A translation unit using the common operations for the common representation types, as a typical user of the library
+ * would. compile_time.py measures it with and without CPA_EXTERN_TEMPLATES.
+ */
+
+namespace
+  {
+  template<typename Rep>
+  bool exercise(cpa::basic_rational<Rep> lhs, cpa::basic_rational<Rep> const & rhs)
+    {
+    auto const sum = lhs + rhs;
+    auto const difference = lhs - rhs;
+    auto const product = lhs * rhs;
+    auto const quotient = lhs / rhs;
+
+    lhs += rhs;
+    lhs -= rhs;
+    lhs *= rhs;
+    lhs /= rhs;
+
+    return cpa::gcd(lhs.numerator(), rhs.denominator()) > cpa::lcm(rhs.numerator(), lhs.denominator()) ||
+           sum == difference || product != quotient || sum < product || difference > quotient || lhs <= rhs || lhs >= sum;
+    }
+  }
+
+int main()
+  {
+  return exercise(cpa::basic_rational<int>{1, 2}, cpa::basic_rational<int>{1, 3}) +
+         exercise(cpa::basic_rational<long>{1, 2}, cpa::basic_rational<long>{1, 3}) +
+         exercise(cpa::basic_rational<long long>{1, 2}, cpa::basic_rational<long long>{1, 3}) +
+         exercise(cpa::basic_rational<unsigned long>{1, 2}, cpa::basic_rational<unsigned long>{1, 3});
+  }
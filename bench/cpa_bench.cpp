@@ -0,0 +1,353 @@
+#include "harness.h"
+
+#include <algorithm.h>
+#include <numeric.h>
+#include <rational.h>
+#include <rational_vector.h>
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Micro-benchmarks of the GCD, LCM, reduction, expansion, arithmetic and comparison kernels of the library.
+ *
+ * Every kernel is measured for every width of the representation type. Random inputs are drawn from a fixed seed, so that all
+ * runs measure the same inputs. The adversarial inputs for the GCD are pairs of consecutive Fibonacci numbers, which need the
+ * largest number of steps in the Euclidean algorithm. Scalar benchmarks apply the kernel to one pair of elements at a time,
+ * while batch benchmarks use the range overloads, which process whole batches of elements.
+ *
+ * With --perf, the hardware performance counters are reported per kernel execution as well. The divider event is only known
+ * for Intel processors, but any raw event can be counted in its place with --divider-event.
+ *
+ * Usage: cpa_bench [--list] [--repetitions N] [--min-time SECONDS] [--json FILE] [--perf] [--divider-event RAW] [FILTER...]
+ */
+
+namespace
+  {
+  constexpr std::size_t input_size = 4096;
+  constexpr std::size_t fibonacci_pairs = 8;
+
+  template<typename Rep>
+  using magnitude_t = cpa::__cpa_make_unsigned_t<Rep>;
+
+  template<typename Rep>
+  constexpr int digits() noexcept
+    {
+    return static_cast<int>(sizeof(Rep) * 8 - 1);
+    }
+
+  template<typename Rep>
+  constexpr magnitude_t<Rep> max_magnitude() noexcept
+    {
+    return static_cast<magnitude_t<Rep>>(~magnitude_t<Rep>{0}) >> 1;
+    }
+
+  /*
+   * Draw count values with a random sign and a magnitude of at most bits bits. Values of zero are replaced by one.
+   */
+  template<typename Rep>
+  std::vector<Rep> random_values(std::mt19937_64 & engine, int const bits, bool const negative = true)
+    {
+    auto values = std::vector<Rep>(input_size);
+
+    for(auto & value : values)
+      {
+      auto magnitude = static_cast<magnitude_t<Rep>>(engine());
+
+      if(sizeof(Rep) > sizeof(std::uint64_t))
+        {
+        magnitude = static_cast<magnitude_t<Rep>>((magnitude << (sizeof(Rep) * 4)) ^ engine());
+        }
+
+      magnitude = static_cast<magnitude_t<Rep>>(magnitude >> (sizeof(Rep) * 8 - static_cast<std::size_t>(bits)));
+      value = static_cast<Rep>(magnitude ? magnitude : 1);
+
+      if(negative && engine() & 1)
+        {
+        value = static_cast<Rep>(-value);
+        }
+      }
+
+    return values;
+    }
+
+  /*
+   * Fill two arrays with the largest pairs of consecutive Fibonacci numbers representable by Rep.
+   */
+  template<typename Rep>
+  void fibonacci_values(std::vector<Rep> & larger, std::vector<Rep> & smaller)
+    {
+    auto sequence = std::vector<magnitude_t<Rep>>{1, 1};
+
+    while(max_magnitude<Rep>() - sequence.back() >= sequence[sequence.size() - 2])
+      {
+      sequence.push_back(static_cast<magnitude_t<Rep>>(sequence.back() + sequence[sequence.size() - 2]));
+      }
+
+    larger.resize(input_size);
+    smaller.resize(input_size);
+
+    for(std::size_t index{}; index < input_size; ++index)
+      {
+      auto const position = sequence.size() - 1 - index % fibonacci_pairs;
+      larger[index] = static_cast<Rep>(sequence[position]);
+      smaller[index] = static_cast<Rep>(sequence[position - 1]);
+      }
+    }
+
+  template<typename Rep>
+  std::vector<cpa::basic_rational<Rep>> rationals(std::vector<Rep> const & numerators, std::vector<Rep> const & denominators)
+    {
+    auto values = std::vector<cpa::basic_rational<Rep>>{};
+    values.reserve(numerators.size());
+
+    for(std::size_t index{}; index < numerators.size(); ++index)
+      {
+      values.emplace_back(numerators[index], denominators[index]);
+      }
+
+    return values;
+    }
+
+  template<typename Rep>
+  std::vector<Rep> multiply(std::vector<Rep> const & lhs, std::vector<Rep> const & rhs)
+    {
+    auto products = std::vector<Rep>(lhs.size());
+
+    for(std::size_t index{}; index < lhs.size(); ++index)
+      {
+      products[index] = static_cast<Rep>(lhs[index] * rhs[index]);
+      }
+
+    return products;
+    }
+
+  /*
+   * The largest prime representable by Rep, which is used as the modulus of the modular inversion benchmarks.
+   */
+  template<typename Rep>
+  Rep largest_prime() noexcept
+    {
+    switch(sizeof(Rep))
+      {
+      case 1: return static_cast<Rep>(127);
+      case 2: return static_cast<Rep>(32749);
+      case 4: return static_cast<Rep>(2147483647);
+      case 8: return static_cast<Rep>(9223372036854775783u);
+      default: return static_cast<Rep>(max_magnitude<Rep>());
+      }
+    }
+
+  /*
+   * Inputs for the benchmarks of a single representation type. They are shared between the benchmarks and live until the end
+   * of the program.
+   */
+  template<typename Rep>
+  struct inputs
+    {
+    explicit inputs(std::mt19937_64 & engine)
+      : random_lhs{random_values<Rep>(engine, digits<Rep>())},
+        random_rhs{random_values<Rep>(engine, digits<Rep>())},
+        half_lhs{random_values<Rep>(engine, digits<Rep>() / 2)},
+        half_rhs{random_values<Rep>(engine, digits<Rep>() / 2)}
+      {
+      fibonacci_values(fibonacci_lhs, fibonacci_rhs);
+
+      auto const third = std::max(digits<Rep>() / 3, 1);
+      auto const factors = random_values<Rep>(engine, third, false);
+      auto const denominators = random_values<Rep>(engine, third, false);
+      reducible = rationals(multiply(random_values<Rep>(engine, third), factors), multiply(denominators, factors));
+      fibonacci = rationals(fibonacci_lhs, fibonacci_rhs);
+
+      auto const quarter = std::max(digits<Rep>() / 4, 1);
+      small_lhs = rationals(random_values<Rep>(engine, quarter), random_values<Rep>(engine, quarter, false));
+      small_rhs = rationals(random_values<Rep>(engine, quarter), random_values<Rep>(engine, quarter, false));
+
+      wide_lhs = rationals(random_lhs, random_values<Rep>(engine, digits<Rep>(), false));
+      wide_rhs = rationals(random_rhs, random_values<Rep>(engine, digits<Rep>(), false));
+
+      for(std::size_t index{}; index < input_size; ++index)
+        {
+        vector_lhs.push_back(small_lhs[index]);
+        vector_rhs.push_back(small_rhs[index]);
+        }
+
+      std::transform(random_lhs.begin(), random_lhs.end(), std::back_inserter(invertible), [this](Rep const value)
+        {
+        return value % modulus ? value : Rep{1};
+        });
+      }
+
+    std::vector<Rep> random_lhs, random_rhs;
+    std::vector<Rep> half_lhs, half_rhs;
+    std::vector<Rep> fibonacci_lhs{}, fibonacci_rhs{};
+    std::vector<cpa::basic_rational<Rep>> reducible{}, fibonacci{};
+    std::vector<cpa::basic_rational<Rep>> small_lhs{}, small_rhs{};
+    std::vector<cpa::basic_rational<Rep>> wide_lhs{}, wide_rhs{};
+    Rep modulus = largest_prime<Rep>();
+    std::vector<Rep> invertible{};
+    cpa::rational_vector<Rep> vector_lhs{}, vector_rhs{};
+
+    std::vector<Rep> integers = std::vector<Rep>(input_size);
+    std::vector<cpa::basic_rational<Rep>> results = std::vector<cpa::basic_rational<Rep>>(input_size);
+    cpa::rational_vector<Rep> vector_result{};
+    };
+
+  template<typename Rep, typename Kernel>
+  std::function<void()> scalar(std::vector<Rep> const & lhs, std::vector<Rep> const & rhs, std::vector<Rep> & out, Kernel kernel)
+    {
+    return [&lhs, &rhs, &out, kernel]
+      {
+      for(std::size_t index{}; index < input_size; ++index)
+        {
+        out[index] = kernel(lhs[index], rhs[index]);
+        }
+
+      cpa_bench::keep(out.data());
+      };
+    }
+
+  template<typename Rep>
+  void add_benchmarks(std::vector<cpa_bench::benchmark> & benchmarks, std::mt19937_64 & engine, std::string const & rep)
+    {
+    using rational_t = cpa::basic_rational<Rep>;
+
+    auto const data = std::make_shared<inputs<Rep>>(engine);
+    auto & in = *data;
+
+    auto const gcd = [](Rep const lhs, Rep const rhs) { return cpa::gcd(lhs, rhs); };
+    auto const lcm = [](Rep const lhs, Rep const rhs) { return cpa::lcm(lhs, rhs); };
+
+    auto const add = [&](std::string const & name, std::function<void()> pass)
+      {
+      benchmarks.push_back({name + "/" + rep, input_size, [data, pass] { pass(); }});
+      };
+
+    add("gcd/scalar/random", scalar(in.random_lhs, in.random_rhs, in.integers, gcd));
+    add("gcd/scalar/fibonacci", scalar(in.fibonacci_lhs, in.fibonacci_rhs, in.integers, gcd));
+    add("lcm/scalar/random", scalar(in.half_lhs, in.half_rhs, in.integers, lcm));
+
+    add("reduce/scalar/random", [&in]
+      {
+      std::transform(in.reducible.begin(), in.reducible.end(), in.results.begin(), [](rational_t const & value)
+        {
+        return value.reduce();
+        });
+      cpa_bench::keep(in.results.data());
+      });
+
+    add("reduce/scalar/fibonacci", [&in]
+      {
+      std::transform(in.fibonacci.begin(), in.fibonacci.end(), in.results.begin(), [](rational_t const & value)
+        {
+        return value.reduce();
+        });
+      cpa_bench::keep(in.results.data());
+      });
+
+    add("common/scalar/random", [&in]
+      {
+      std::transform(in.small_lhs.begin(), in.small_lhs.end(), in.small_rhs.begin(), in.results.begin(),
+                     [](rational_t const & lhs, rational_t const & rhs) { return lhs.common(rhs); });
+      cpa_bench::keep(in.results.data());
+      });
+
+    add("add/scalar/random", [&in]
+      {
+      std::transform(in.small_lhs.begin(), in.small_lhs.end(), in.small_rhs.begin(), in.results.begin(),
+                     [](rational_t const & lhs, rational_t const & rhs) { return lhs + rhs; });
+      cpa_bench::keep(in.results.data());
+      });
+
+    add("multiply/scalar/random", [&in]
+      {
+      std::transform(in.small_lhs.begin(), in.small_lhs.end(), in.small_rhs.begin(), in.results.begin(),
+                     [](rational_t const & lhs, rational_t const & rhs) { return lhs * rhs; });
+      cpa_bench::keep(in.results.data());
+      });
+
+    add("less/scalar/random", [&in]
+      {
+      std::transform(in.wide_lhs.begin(), in.wide_lhs.end(), in.wide_rhs.begin(), in.integers.begin(),
+                     [](rational_t const & lhs, rational_t const & rhs) { return static_cast<Rep>(lhs < rhs); });
+      cpa_bench::keep(in.integers.data());
+      });
+
+    /*
+     * The batch benchmarks of in-place operations copy their input in every pass, so that each pass sees the same values.
+     */
+    add("gcd/batch/random", [&in]
+      {
+      cpa::gcd(in.random_lhs.begin(), in.random_lhs.end(), in.random_rhs.begin(), in.integers.begin());
+      cpa_bench::keep(in.integers.data());
+      });
+
+    add("gcd/batch/fibonacci", [&in]
+      {
+      cpa::gcd(in.fibonacci_lhs.begin(), in.fibonacci_lhs.end(), in.fibonacci_rhs.begin(), in.integers.begin());
+      cpa_bench::keep(in.integers.data());
+      });
+
+    add("lcm/batch/random", [&in]
+      {
+      cpa::lcm(in.half_lhs.begin(), in.half_lhs.end(), in.half_rhs.begin(), in.integers.begin());
+      cpa_bench::keep(in.integers.data());
+      });
+
+    add("reduce/batch/random", [&in]
+      {
+      std::copy(in.reducible.begin(), in.reducible.end(), in.results.begin());
+      cpa::reduce(in.results.begin(), in.results.end());
+      cpa_bench::keep(in.results.data());
+      });
+
+    add("reduce/batch/fibonacci", [&in]
+      {
+      std::copy(in.fibonacci.begin(), in.fibonacci.end(), in.results.begin());
+      cpa::reduce(in.results.begin(), in.results.end());
+      cpa_bench::keep(in.results.data());
+      });
+
+    add("mod_inverse/scalar/random", [&in]
+      {
+      std::transform(in.invertible.begin(), in.invertible.end(), in.integers.begin(), [&in](Rep const value)
+        {
+        return cpa::mod_inverse(value, in.modulus);
+        });
+      cpa_bench::keep(in.integers.data());
+      });
+
+    add("mod_inverse/batch/random", [&in]
+      {
+      cpa::mod_inverse(in.invertible.begin(), in.invertible.end(), in.integers.begin(), in.modulus);
+      cpa_bench::keep(in.integers.data());
+      });
+
+    add("add/batch/random", [&in]
+      {
+      in.vector_result = in.vector_lhs;
+      in.vector_result.add(in.vector_rhs);
+      cpa_bench::keep(in.vector_result.numerators());
+      });
+    }
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto engine = std::mt19937_64{0x6370612d62656e63};
+  auto benchmarks = std::vector<cpa_bench::benchmark>{};
+
+  add_benchmarks<std::int8_t>(benchmarks, engine, "int8");
+  add_benchmarks<std::int16_t>(benchmarks, engine, "int16");
+  add_benchmarks<std::int32_t>(benchmarks, engine, "int32");
+  add_benchmarks<std::int64_t>(benchmarks, engine, "int64");
+#if defined(__SIZEOF_INT128__)
+  add_benchmarks<cpa::__cpa_int128>(benchmarks, engine, "int128");
+#endif
+
+  return cpa_bench::run(argc, argv, benchmarks);
+  }
@@ -0,0 +1,337 @@
+#ifndef __CPA_BENCH__HARNESS
+#define __CPA_BENCH__HARNESS
+
+#include "perf_counters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * A minimal, dependency free micro-benchmark harness.
+ *
+ * Every benchmark consists of a pass, which executes a kernel a fixed number of times over pre-generated inputs. The harness
+ * first determines how many passes are needed to exceed the minimum sample time, and then takes a number of samples of that
+ * many passes. The results are reported as nanoseconds per kernel execution, with the median, mean, standard deviation and
+ * extrema over all samples.
+ *
+ * With --perf, the hardware performance counters are read around every sample, and their totals over all samples are reported
+ * per kernel execution as well. If the counters can not be opened, the benchmarks are still run and only timed.
+ */
+
+namespace cpa_bench
+  {
+
+  using clock = std::chrono::steady_clock;
+
+  /*
+   * Prevent the compiler from optimizing away the computation of the object at address.
+   */
+  inline void keep(void const * address)
+    {
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(address) : "memory");
+#else
+    static void const * volatile sink;
+    sink = address;
+#endif
+    }
+
+  struct benchmark
+    {
+    std::string name;
+    std::size_t operations;
+    std::function<void()> pass;
+    };
+
+  struct result
+    {
+    std::string name;
+    std::size_t operations;
+    std::size_t passes;
+    double median;
+    double mean;
+    double stddev;
+    double min;
+    double max;
+    std::vector<std::pair<std::string, double>> counters;
+    };
+
+  struct options
+    {
+    std::vector<std::string> filters{};
+    std::size_t repetitions{15};
+    double min_time{0.01};
+    char const * json{};
+    bool list{};
+    bool perf{};
+    std::uint64_t divider_event{};
+    };
+
+  inline bool selected(options const & options, std::string const & name)
+    {
+    return options.filters.empty() || std::any_of(options.filters.begin(), options.filters.end(), [&](std::string const & filter)
+      {
+      return name.find(filter) != std::string::npos;
+      });
+    }
+
+  inline double seconds(clock::duration const duration)
+    {
+    return std::chrono::duration<double>(duration).count();
+    }
+
+  inline double time(benchmark const & benchmark, std::size_t const passes)
+    {
+    auto const start = clock::now();
+
+    for(std::size_t pass{}; pass < passes; ++pass)
+      {
+      benchmark.pass();
+      }
+
+    return seconds(clock::now() - start);
+    }
+
+  inline result measure(benchmark const & benchmark, options const & options, perf_counters const * const counters)
+    {
+    auto passes = std::size_t{1};
+    time(benchmark, passes);
+
+    for(auto elapsed = time(benchmark, passes); elapsed < options.min_time; elapsed = time(benchmark, passes))
+      {
+      auto const estimate = elapsed > 0 ? options.min_time / elapsed * 1.2 : 10.0;
+      passes = std::max(passes + 1, static_cast<std::size_t>(static_cast<double>(passes) * std::min(estimate, 10.0)));
+      }
+
+    auto samples = std::vector<double>(options.repetitions);
+    auto const operations = static_cast<double>(passes * benchmark.operations);
+    auto totals = std::vector<double>(counters ? counters->names().size() : 0);
+
+    for(auto & sample : samples)
+      {
+      if(counters)
+        {
+        counters->start();
+        }
+
+      sample = time(benchmark, passes) * 1e9 / operations;
+
+      if(counters)
+        {
+        auto const counts = counters->stop();
+        std::transform(totals.begin(), totals.end(), counts.begin(), totals.begin(), std::plus<double>{});
+        }
+      }
+
+    auto per_operation = std::vector<std::pair<std::string, double>>{};
+
+    for(std::size_t index{}; index < totals.size(); ++index)
+      {
+      per_operation.emplace_back(counters->names()[index], totals[index] / (operations * static_cast<double>(samples.size())));
+      }
+
+    std::sort(samples.begin(), samples.end());
+
+    auto const count = static_cast<double>(samples.size());
+    auto const middle = samples.size() / 2;
+    auto const median = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+    auto const mean = std::accumulate(samples.begin(), samples.end(), 0.0) / count;
+    auto const squares = std::accumulate(samples.begin(), samples.end(), 0.0, [&](double const sum, double const sample)
+      {
+      return sum + (sample - mean) * (sample - mean);
+      });
+    auto const stddev = samples.size() > 1 ? std::sqrt(squares / (count - 1)) : 0.0;
+
+    return {benchmark.name, benchmark.operations, passes, median, mean, stddev, samples.front(), samples.back(), per_operation};
+    }
+
+  inline void write_json(char const * const path, std::vector<result> const & results, options const & options)
+    {
+    auto const file = std::fopen(path, "w");
+
+    if(!file)
+      {
+      std::perror(path);
+      std::exit(EXIT_FAILURE);
+      }
+
+    std::fprintf(file, "{\n  \"context\": {\n");
+#if defined(__VERSION__)
+    std::fprintf(file, "    \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+#if defined(NDEBUG)
+    std::fprintf(file, "    \"assertions\": false,\n");
+#else
+    std::fprintf(file, "    \"assertions\": true,\n");
+#endif
+    std::fprintf(file, "    \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+    std::fprintf(file, "    \"repetitions\": %zu,\n", options.repetitions);
+    std::fprintf(file, "    \"min_time\": %g\n", options.min_time);
+    std::fprintf(file, "  },\n  \"benchmarks\": [");
+
+    for(std::size_t index{}; index < results.size(); ++index)
+      {
+      auto const & result = results[index];
+      std::fprintf(file, "%s\n    {\"name\": \"%s\", \"operations\": %zu, \"passes\": %zu, \"ns_per_op\": %.4f, "
+                         "\"mean\": %.4f, \"stddev\": %.4f, \"min\": %.4f, \"max\": %.4f",
+                   index ? "," : "", result.name.c_str(), result.operations, result.passes, result.median, result.mean,
+                   result.stddev, result.min, result.max);
+
+      if(!result.counters.empty())
+        {
+        std::fprintf(file, ", \"counters\": {");
+
+        for(std::size_t counter{}; counter < result.counters.size(); ++counter)
+          {
+          std::fprintf(file, "%s\"%s\": %.4f", counter ? ", " : "", result.counters[counter].first.c_str(),
+                       result.counters[counter].second);
+          }
+
+        std::fprintf(file, "}");
+        }
+
+      std::fprintf(file, "}");
+      }
+
+    std::fprintf(file, "\n  ]\n}\n");
+    std::fclose(file);
+    }
+
+  inline void usage(char const * const program)
+    {
+    std::fprintf(stderr, "usage: %s [--list] [--repetitions N] [--min-time SECONDS] [--json FILE] [--perf] "
+                         "[--divider-event RAW] [FILTER...]\n", program);
+    std::exit(EXIT_FAILURE);
+    }
+
+  inline options parse_options(int const argc, char * argv[])
+    {
+    auto parsed = options{};
+
+    for(int index{1}; index < argc; ++index)
+      {
+      auto const argument = std::string{argv[index]};
+      auto const has_value = index + 1 < argc;
+
+      if(argument == "--list")
+        {
+        parsed.list = true;
+        }
+      else if(argument == "--repetitions" && has_value)
+        {
+        parsed.repetitions = std::max(std::strtoul(argv[++index], nullptr, 10), 1ul);
+        }
+      else if(argument == "--min-time" && has_value)
+        {
+        parsed.min_time = std::strtod(argv[++index], nullptr);
+        }
+      else if(argument == "--json" && has_value)
+        {
+        parsed.json = argv[++index];
+        }
+      else if(argument == "--perf")
+        {
+        parsed.perf = true;
+        }
+      else if(argument == "--divider-event" && has_value)
+        {
+        parsed.perf = true;
+        parsed.divider_event = std::strtoull(argv[++index], nullptr, 0);
+        }
+      else if(argument.compare(0, 2, "--") == 0)
+        {
+        usage(argv[0]);
+        }
+      else
+        {
+        parsed.filters.push_back(argument);
+        }
+      }
+
+    return parsed;
+    }
+
+  /*
+   * Run all benchmarks whose name contains one of the filters given on the command line, print a table of their results and
+   * optionally write them to a JSON file.
+   */
+  inline int run(int const argc, char * argv[], std::vector<benchmark> const & benchmarks)
+    {
+    auto const options = parse_options(argc, argv);
+    auto results = std::vector<result>{};
+    auto const perf = options.perf && !options.list;
+    perf_counters const counters{perf ? default_perf_events(options.divider_event) : std::vector<perf_event>{}};
+
+    for(auto const & error : perf ? counters.errors() : std::vector<std::string>{})
+      {
+      std::fprintf(stderr, "perf counter unavailable: %s\n", error.c_str());
+      }
+
+    if(perf && !counters.available())
+      {
+      std::fprintf(stderr, "perf counters are unavailable, measuring time only\n");
+      }
+
+    if(!options.list)
+      {
+      std::printf("%-40s %12s %12s %10s %12s", "benchmark", "ns/op", "mean", "stddev %", "min");
+
+      for(auto const & name : counters.names())
+        {
+        std::printf(" %14s", (name + "/op").c_str());
+        }
+
+      std::printf("\n");
+      }
+
+    for(auto const & benchmark : benchmarks)
+      {
+      if(!selected(options, benchmark.name))
+        {
+        continue;
+        }
+
+      if(options.list)
+        {
+        std::printf("%s\n", benchmark.name.c_str());
+        continue;
+        }
+
+      results.push_back(measure(benchmark, options, counters.available() ? &counters : nullptr));
+
+      auto const & result = results.back();
+      std::printf("%-40s %12.3f %12.3f %10.2f %12.3f", result.name.c_str(), result.median, result.mean,
+                  result.mean > 0 ? 100 * result.stddev / result.mean : 0.0, result.min);
+
+      for(auto const & counter : result.counters)
+        {
+        std::printf(" %14.3f", counter.second);
+        }
+
+      std::printf("\n");
+      std::fflush(stdout);
+      }
+
+    if(options.json)
+      {
+      write_json(options.json, results, options);
+      }
+
+    return EXIT_SUCCESS;
+    }
+
+  }
+
+#endif
@@ -0,0 +1,231 @@
+#ifndef __CPA_BENCH__PERF_COUNTERS
+#define __CPA_BENCH__PERF_COUNTERS
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Hardware performance counters read via the Linux perf_event_open interface.
+ *
+ * The counters are opened as a single group, so that all of them are counted during exactly the same interval. Only user space
+ * is counted, which is permitted with the default setting of kernel.perf_event_paranoid. Events that can not be opened are
+ * skipped, and if none can be opened, the counters are simply unavailable.
+ */
+
+namespace cpa_bench
+  {
+
+  struct perf_event
+    {
+    std::string name;
+    std::uint32_t type;
+    std::uint64_t config;
+    };
+
+  /*
+   * ARITH.DIVIDER_ACTIVE (event 0x14, umask 0x01, cmask 1) counts the cycles in which the divider is busy on Intel processors
+   * since Skylake.
+   */
+  constexpr std::uint64_t intel_divider_active = 0x14 | (0x01 << 8) | (std::uint64_t{1} << 24);
+
+  inline bool is_intel()
+    {
+    auto cpuinfo = std::ifstream{"/proc/cpuinfo"};
+    auto line = std::string{};
+
+    while(std::getline(cpuinfo, line))
+      {
+      if(line.compare(0, 9, "vendor_id") == 0)
+        {
+        return line.find("GenuineIntel") != std::string::npos;
+        }
+      }
+
+    return false;
+    }
+
+#if defined(__linux__)
+  /*
+   * The events to count. The divider event is only known for Intel processors, unless a raw event is given explicitly.
+   */
+  inline std::vector<perf_event> default_perf_events(std::uint64_t const divider_event)
+    {
+    auto events = std::vector<perf_event>{
+      {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    };
+
+    if(divider_event)
+      {
+      events.push_back({"divider_active", PERF_TYPE_RAW, divider_event});
+      }
+    else if(is_intel())
+      {
+      events.push_back({"divider_active", PERF_TYPE_RAW, intel_divider_active});
+      }
+
+    return events;
+    }
+
+  struct perf_counters
+    {
+    explicit perf_counters(std::vector<perf_event> const & events)
+      {
+      for(auto const & event : events)
+        {
+        auto attributes = perf_event_attr{};
+        attributes.size = sizeof(attributes);
+        attributes.type = event.type;
+        attributes.config = event.config;
+        attributes.disabled = m_leader < 0;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        auto const descriptor = static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, m_leader, 0));
+
+        if(descriptor < 0)
+          {
+          m_errors.push_back(event.name + ": " + std::strerror(errno));
+          continue;
+          }
+
+        if(m_leader < 0)
+          {
+          m_leader = descriptor;
+          }
+
+        m_descriptors.push_back(descriptor);
+        m_names.push_back(event.name);
+        }
+      }
+
+    perf_counters(perf_counters const &) = delete;
+    perf_counters & operator = (perf_counters const &) = delete;
+
+    ~perf_counters()
+      {
+      for(auto const descriptor : m_descriptors)
+        {
+        ::close(descriptor);
+        }
+      }
+
+    bool available() const noexcept
+      {
+      return m_leader >= 0;
+      }
+
+    /*
+     * The names of the events that could be opened, in the order of the values returned by stop().
+     */
+    std::vector<std::string> const & names() const noexcept
+      {
+      return m_names;
+      }
+
+    /*
+     * Descriptions of the events that could not be opened.
+     */
+    std::vector<std::string> const & errors() const noexcept
+      {
+      return m_errors;
+      }
+
+    void start() const
+      {
+      ::ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ::ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      }
+
+    /*
+     * Stop counting and get the counts since the last call to start(). If the counters had to share the hardware with other
+     * events, the counts are extrapolated to the whole interval.
+     */
+    std::vector<double> stop() const
+      {
+      ::ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+      auto buffer = std::vector<std::uint64_t>(3 + m_descriptors.size());
+      auto const size = static_cast<ssize_t>(buffer.size() * sizeof(std::uint64_t));
+      auto values = std::vector<double>(m_descriptors.size());
+
+      if(::read(m_leader, buffer.data(), buffer.size() * sizeof(std::uint64_t)) != size || !buffer[2])
+        {
+        return values;
+        }
+
+      auto const scale = static_cast<double>(buffer[1]) / static_cast<double>(buffer[2]);
+
+      for(std::size_t index{}; index < values.size(); ++index)
+        {
+        values[index] = static_cast<double>(buffer[3 + index]) * scale;
+        }
+
+      return values;
+      }
+
+    private:
+      int m_leader{-1};
+      std::vector<int> m_descriptors{};
+      std::vector<std::string> m_names{};
+      std::vector<std::string> m_errors{};
+    };
+#else
+  inline std::vector<perf_event> default_perf_events(std::uint64_t const)
+    {
+    return {};
+    }
+
+  struct perf_counters
+    {
+    explicit perf_counters(std::vector<perf_event> const &)
+      {
+      }
+
+    bool available() const noexcept
+      {
+      return false;
+      }
+
+    std::vector<std::string> const & names() const noexcept
+      {
+      return m_names;
+      }
+
+    std::vector<std::string> const & errors() const noexcept
+      {
+      return m_errors;
+      }
+
+    void start() const
+      {
+      }
+
+    std::vector<double> stop() const
+      {
+      return {};
+      }
+
+    private:
+      std::vector<std::string> m_names{};
+      std::vector<std::string> m_errors{"perf_event_open is only available on Linux"};
+    };
+#endif
+
+  }
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef __CPA_IMPL__ALIGNED_ALLOCATOR
+#define __CPA_IMPL__ALIGNED_ALLOCATOR
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+namespace cpa
+  {
+  /*
+   * Allocator returning storage aligned to Alignment bytes, which must be a power of two. The address of the underlying
+   * allocation is stored right in front of the aligned storage.
+   */
+  template<typename Type, std::size_t Alignment>
+  struct __cpa_aligned_allocator
+    {
+    static_assert(Alignment && !(Alignment & (Alignment - 1)), "Alignment must be a power of two");
+
+    using value_type = Type;
+
+    template<typename Other>
+    struct rebind
+      {
+      using other = __cpa_aligned_allocator<Other, Alignment>;
+      };
+
+    __cpa_aligned_allocator() noexcept = default;
+
+    template<typename Other>
+    __cpa_aligned_allocator(__cpa_aligned_allocator<Other, Alignment> const &) noexcept
+      {
+      }
+
+    Type * allocate(std::size_t const count)
+      {
+      constexpr auto overhead = Alignment + sizeof(void *);
+
+      if(count > (std::numeric_limits<std::size_t>::max() - overhead) / sizeof(Type))
+        {
+        throw std::bad_alloc{};
+        }
+
+      auto const raw = ::operator new(count * sizeof(Type) + overhead);
+      auto const address = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *);
+      auto const aligned = (address + Alignment - 1) & ~static_cast<std::uintptr_t>(Alignment - 1);
+
+      reinterpret_cast<void **>(aligned)[-1] = raw;
+      return reinterpret_cast<Type *>(aligned);
+      }
+
+    void deallocate(Type * const pointer, std::size_t) noexcept
+      {
+      ::operator delete(reinterpret_cast<void **>(pointer)[-1]);
+      }
+
+    template<typename Other>
+    bool operator == (__cpa_aligned_allocator<Other, Alignment> const &) const noexcept
+      {
+      return true;
+      }
+
+    template<typename Other>
+    bool operator != (__cpa_aligned_allocator<Other, Alignment> const &) const noexcept
+      {
+      return false;
+      }
+    };
+  }
+
+#endif
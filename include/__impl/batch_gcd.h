@@ -0,0 +1,219 @@
+#ifndef __CPA_IMPL__BATCH_GCD
+#define __CPA_IMPL__BATCH_GCD
+
+#include <__impl/numeric.h>
+#include <__impl/type_traits.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define __CPA_GCD_LANES_DISPATCH 1
+#endif
+
+namespace cpa
+  {
+  constexpr std::size_t __cpa_gcd_lane_count = 8;
+  constexpr std::size_t __cpa_gcd_batch_size = 256;
+
+  template<typename Type>
+  struct __cpa_is_batch_gcd_capable
+  : std::integral_constant<bool, __cpa_is_binary_gcd_capable<Type>::value && sizeof(Type) <= sizeof(std::uint64_t)> {};
+
+  template<typename Integral>
+  using __cpa_gcd_lane_t = std::conditional_t<(sizeof(Integral) <= sizeof(std::uint32_t)), std::uint32_t, std::uint64_t>;
+
+  template<typename Lane>
+  using __cpa_gcd_lanes_t = void (*)(Lane *, Lane *, std::size_t);
+
+  /*
+   * Branch-free binary GCD over a fixed number of lanes. Each iteration either halves an even right operand or replaces the
+   * odd pair (left, right) by (min(left, right), |right - left| / 2). Lanes that have finished keep a right operand of 0 and
+   * are not modified anymore, so all lanes can execute the same instruction stream. With instrumentation, every lane counts
+   * the iterations in which it was still active.
+   */
+  template<typename Lane>
+#if defined(__GNUC__)
+  __attribute__((always_inline))
+#endif
+  inline void __cpa_gcd_block(Lane * __restrict left, Lane * __restrict right) noexcept
+    {
+    int shift[__cpa_gcd_lane_count];
+#if defined(CPA_INSTRUMENTATION)
+    std::uint64_t iterations[__cpa_gcd_lane_count] = {};
+#endif
+
+    for(std::size_t lane{}; lane < __cpa_gcd_lane_count; ++lane)
+      {
+      auto const lhs = left[lane];
+      auto const rhs = right[lane];
+
+      if(!lhs || !rhs)
+        {
+        left[lane] = lhs | rhs;
+        right[lane] = 0;
+        shift[lane] = 0;
+        continue;
+        }
+
+      shift[lane] = __cpa_ctz(static_cast<Lane>(lhs | rhs));
+      left[lane] = lhs >> __cpa_ctz(lhs);
+      right[lane] = rhs >> shift[lane];
+      }
+
+    for(;;)
+      {
+      Lane active{};
+
+      for(std::size_t lane{}; lane < __cpa_gcd_lane_count; ++lane)
+        {
+        active |= right[lane];
+        }
+
+      if(!active)
+        {
+        break;
+        }
+
+#if defined(CPA_INSTRUMENTATION)
+      for(std::size_t lane{}; lane < __cpa_gcd_lane_count; ++lane)
+        {
+        iterations[lane] += right[lane] != 0;
+        }
+#endif
+
+      for(std::size_t lane{}; lane < __cpa_gcd_lane_count; ++lane)
+        {
+        auto const lhs = left[lane];
+        auto const rhs = right[lane];
+        auto const odd = static_cast<Lane>(Lane{0} - (rhs & Lane{1}));
+        auto const less = static_cast<Lane>(Lane{0} - static_cast<Lane>(rhs < lhs));
+        auto const difference = static_cast<Lane>(((rhs - lhs) & ~less) | ((lhs - rhs) & less));
+        auto const smaller = static_cast<Lane>((rhs & less) | (lhs & ~less));
+
+        left[lane] = (smaller & odd) | (lhs & ~odd);
+        right[lane] = static_cast<Lane>(((difference & odd) | (rhs & ~odd)) >> 1);
+        }
+      }
+
+    for(std::size_t lane{}; lane < __cpa_gcd_lane_count; ++lane)
+      {
+      left[lane] = static_cast<Lane>(left[lane] << shift[lane]);
+#if defined(CPA_INSTRUMENTATION)
+      __CPA_INSTRUMENT(gcd, iterations[lane], __cpa_bits(left[lane]));
+#endif
+      }
+    }
+
+  template<typename Lane>
+#if defined(__GNUC__)
+  __attribute__((always_inline))
+#endif
+  inline void __cpa_gcd_lanes_generic(Lane * left, Lane * right, std::size_t const count) noexcept
+    {
+    std::size_t index{};
+
+    for(; index + __cpa_gcd_lane_count <= count; index += __cpa_gcd_lane_count)
+      {
+      __cpa_gcd_block(left + index, right + index);
+      }
+
+    for(; index < count; ++index)
+      {
+      left[index] = __cpa_binary_gcd(left[index], right[index]);
+      }
+    }
+
+  template<typename Lane>
+  void __cpa_gcd_lanes_baseline(Lane * left, Lane * right, std::size_t const count) noexcept
+    {
+    __cpa_gcd_lanes_generic(left, right, count);
+    }
+
+#if defined(__CPA_GCD_LANES_DISPATCH)
+  template<typename Lane>
+  __attribute__((target("sse4.2"))) void __cpa_gcd_lanes_sse42(Lane * left, Lane * right, std::size_t const count) noexcept
+    {
+    __cpa_gcd_lanes_generic(left, right, count);
+    }
+
+  template<typename Lane>
+  __attribute__((target("avx2"))) void __cpa_gcd_lanes_avx2(Lane * left, Lane * right, std::size_t const count) noexcept
+    {
+    __cpa_gcd_lanes_generic(left, right, count);
+    }
+#endif
+
+  template<typename Lane>
+  __cpa_gcd_lanes_t<Lane> __cpa_select_gcd_lanes() noexcept
+    {
+#if defined(__CPA_GCD_LANES_DISPATCH)
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx2"))
+      {
+      return &__cpa_gcd_lanes_avx2<Lane>;
+      }
+
+    if(__builtin_cpu_supports("sse4.2"))
+      {
+      return &__cpa_gcd_lanes_sse42<Lane>;
+      }
+#endif
+
+    return &__cpa_gcd_lanes_baseline<Lane>;
+    }
+
+  /*
+   * Calculate the GCDs of count pairs of magnitudes, using the best kernel supported by the processor. The results are stored
+   * in left, while right is clobbered.
+   */
+  template<typename Lane>
+  void __cpa_gcd_lanes(Lane * left, Lane * right, std::size_t const count) noexcept
+    {
+    static auto const kernel = __cpa_select_gcd_lanes<Lane>();
+    kernel(left, right, count);
+    }
+
+  /*
+   * Drive the lane kernel over two input ranges. The operands are buffered, so that finish can combine them with their GCD
+   * before the result is written to the destination.
+   */
+  template<typename InputIt1, typename InputIt2, typename OutputIt, typename Finish>
+  OutputIt __cpa_batch_gcd_transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt destination, Finish finish)
+    {
+    using common_t = std::common_type_t<__cpa_iterator_value_t<InputIt1>, __cpa_iterator_value_t<InputIt2>>;
+    using lane_t = __cpa_gcd_lane_t<common_t>;
+
+    common_t lhs[__cpa_gcd_batch_size];
+    common_t rhs[__cpa_gcd_batch_size];
+    lane_t left[__cpa_gcd_batch_size];
+    lane_t right[__cpa_gcd_batch_size];
+
+    while(first1 != last1)
+      {
+      std::size_t count{};
+
+      for(; count < __cpa_gcd_batch_size && first1 != last1; ++count, ++first1, ++first2)
+        {
+        lhs[count] = static_cast<common_t>(*first1);
+        rhs[count] = static_cast<common_t>(*first2);
+        left[count] = __cpa_magnitude(lhs[count]);
+        right[count] = __cpa_magnitude(rhs[count]);
+        }
+
+      __cpa_gcd_lanes(left, right, count);
+
+      for(std::size_t index{}; index < count; ++index, ++destination)
+        {
+        *destination = finish(lhs[index], rhs[index], static_cast<common_t>(left[index]));
+        }
+      }
+
+    return destination;
+    }
+  }
+
+#endif
+
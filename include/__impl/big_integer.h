@@ -0,0 +1,424 @@
+#ifndef __CPA_IMPL__BIG_INTEGER
+#define __CPA_IMPL__BIG_INTEGER
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cpa
+  {
+  /*
+   * Little-endian sequence of 32-bit digits representing a magnitude. Normalized sequences have no leading zero digits.
+   */
+  using __cpa_limbs = std::vector<std::uint32_t>;
+
+  constexpr std::size_t __cpa_karatsuba_threshold = 32;
+
+  inline void __cpa_limbs_trim(__cpa_limbs & limbs) noexcept
+    {
+    while(!limbs.empty() && !limbs.back())
+      {
+      limbs.pop_back();
+      }
+    }
+
+  inline __cpa_limbs __cpa_limbs_from(std::uint64_t const value)
+    {
+    auto limbs = __cpa_limbs{static_cast<std::uint32_t>(value), static_cast<std::uint32_t>(value >> 32)};
+    __cpa_limbs_trim(limbs);
+    return limbs;
+    }
+
+  inline int __cpa_limbs_compare(__cpa_limbs const & lhs, __cpa_limbs const & rhs) noexcept
+    {
+    if(lhs.size() != rhs.size())
+      {
+      return lhs.size() < rhs.size() ? -1 : 1;
+      }
+
+    for(auto index = lhs.size(); index-- > 0;)
+      {
+      if(lhs[index] != rhs[index])
+        {
+        return lhs[index] < rhs[index] ? -1 : 1;
+        }
+      }
+
+    return 0;
+    }
+
+  inline std::size_t __cpa_limbs_bit_length(__cpa_limbs const & limbs) noexcept
+    {
+    if(limbs.empty())
+      {
+      return 0;
+      }
+
+    auto top = limbs.back();
+    std::size_t bits{};
+
+    for(; top; top >>= 1)
+      {
+      ++bits;
+      }
+
+    return 32 * (limbs.size() - 1) + bits;
+    }
+
+  /*
+   * Extract the 64 bits starting at bit position shift.
+   */
+  inline std::uint64_t __cpa_limbs_extract(__cpa_limbs const & limbs, std::size_t const shift) noexcept
+    {
+    auto const limb = shift / 32;
+    auto const offset = shift % 32;
+    std::uint64_t result{};
+
+    for(std::size_t index{}; index < 3 && limb + index < limbs.size(); ++index)
+      {
+      auto const digit = static_cast<std::uint64_t>(limbs[limb + index]);
+      auto const position = 32 * index;
+
+      if(position >= offset)
+        {
+        auto const target = position - offset;
+        result |= target < 64 ? digit << target : 0;
+        }
+      else
+        {
+        result |= digit >> (offset - position);
+        }
+      }
+
+    return result;
+    }
+
+  /*
+   * Shift a magnitude to the left by the given number of bits.
+   */
+  inline __cpa_limbs __cpa_limbs_shift_left(__cpa_limbs const & limbs, std::size_t const shift)
+    {
+    if(limbs.empty())
+      {
+      return {};
+      }
+
+    auto const offset = shift / 32;
+    auto const bits = shift % 32;
+    auto result = __cpa_limbs(limbs.size() + offset + 1);
+
+    for(std::size_t index{}; index < limbs.size(); ++index)
+      {
+      auto const shifted = static_cast<std::uint64_t>(limbs[index]) << bits;
+      result[index + offset] |= static_cast<std::uint32_t>(shifted);
+      result[index + offset + 1] |= static_cast<std::uint32_t>(shifted >> 32);
+      }
+
+    __cpa_limbs_trim(result);
+    return result;
+    }
+
+  inline bool __cpa_limbs_test_bit(__cpa_limbs const & limbs, std::size_t const position) noexcept
+    {
+    return position / 32 < limbs.size() && (limbs[position / 32] >> (position % 32)) & 1u;
+    }
+
+  /*
+   * Check whether any of the bits below position are set.
+   */
+  inline bool __cpa_limbs_any_below(__cpa_limbs const & limbs, std::size_t const position) noexcept
+    {
+    auto const limb = position / 32;
+
+    for(std::size_t index{}; index < limb && index < limbs.size(); ++index)
+      {
+      if(limbs[index])
+        {
+        return true;
+        }
+      }
+
+    return limb < limbs.size() && (limbs[limb] & ((std::uint32_t{1} << (position % 32)) - 1));
+    }
+
+  /*
+   * Add value, shifted by offset digits, to target in place.
+   */
+  inline void __cpa_limbs_add_at(__cpa_limbs & target, __cpa_limbs const & value, std::size_t const offset)
+    {
+    if(target.size() < value.size() + offset)
+      {
+      target.resize(value.size() + offset);
+      }
+
+    std::uint64_t carry{};
+    auto index = std::size_t{};
+
+    for(; index < value.size(); ++index)
+      {
+      auto const sum = static_cast<std::uint64_t>(target[index + offset]) + value[index] + carry;
+      target[index + offset] = static_cast<std::uint32_t>(sum);
+      carry = sum >> 32;
+      }
+
+    for(index += offset; carry; ++index)
+      {
+      if(index == target.size())
+        {
+        target.push_back(0);
+        }
+
+      auto const sum = static_cast<std::uint64_t>(target[index]) + carry;
+      target[index] = static_cast<std::uint32_t>(sum);
+      carry = sum >> 32;
+      }
+    }
+
+  inline __cpa_limbs __cpa_limbs_add(__cpa_limbs const & lhs, __cpa_limbs const & rhs)
+    {
+    auto result = lhs;
+    __cpa_limbs_add_at(result, rhs, 0);
+    return result;
+    }
+
+  /*
+   * Subtract value from target in place. The magnitude of target must not be less than the magnitude of value.
+   */
+  inline void __cpa_limbs_subtract_from(__cpa_limbs & target, __cpa_limbs const & value) noexcept
+    {
+    std::int64_t borrow{};
+
+    for(std::size_t index{}; index < target.size(); ++index)
+      {
+      auto difference = static_cast<std::int64_t>(target[index]) - borrow - (index < value.size() ? value[index] : 0);
+      borrow = difference < 0;
+      difference += borrow << 32;
+      target[index] = static_cast<std::uint32_t>(difference);
+
+      if(!borrow && index >= value.size())
+        {
+        break;
+        }
+      }
+
+    __cpa_limbs_trim(target);
+    }
+
+  inline __cpa_limbs __cpa_limbs_subtract(__cpa_limbs const & lhs, __cpa_limbs const & rhs)
+    {
+    auto result = lhs;
+    __cpa_limbs_subtract_from(result, rhs);
+    return result;
+    }
+
+  inline __cpa_limbs __cpa_limbs_schoolbook_multiply(__cpa_limbs const & lhs, __cpa_limbs const & rhs)
+    {
+    if(lhs.empty() || rhs.empty())
+      {
+      return {};
+      }
+
+    auto result = __cpa_limbs(lhs.size() + rhs.size());
+
+    for(std::size_t outer{}; outer < lhs.size(); ++outer)
+      {
+      std::uint64_t carry{};
+
+      for(std::size_t inner{}; inner < rhs.size(); ++inner)
+        {
+        auto const product = static_cast<std::uint64_t>(lhs[outer]) * rhs[inner] + result[outer + inner] + carry;
+        result[outer + inner] = static_cast<std::uint32_t>(product);
+        carry = product >> 32;
+        }
+
+      result[outer + rhs.size()] = static_cast<std::uint32_t>(carry);
+      }
+
+    __cpa_limbs_trim(result);
+    return result;
+    }
+
+  inline __cpa_limbs __cpa_limbs_slice(__cpa_limbs const & limbs, std::size_t const first, std::size_t const last)
+    {
+    auto const begin = std::min(first, limbs.size());
+    auto const end = std::min(last, limbs.size());
+    auto slice = __cpa_limbs(limbs.begin() + begin, limbs.begin() + end);
+    __cpa_limbs_trim(slice);
+    return slice;
+    }
+
+  /*
+   * Multiply two magnitudes using Karatsuba's algorithm, falling back to schoolbook multiplication for short operands.
+   */
+  inline __cpa_limbs __cpa_limbs_multiply(__cpa_limbs const & lhs, __cpa_limbs const & rhs)
+    {
+    if(std::min(lhs.size(), rhs.size()) < __cpa_karatsuba_threshold)
+      {
+      return __cpa_limbs_schoolbook_multiply(lhs, rhs);
+      }
+
+    auto const split = std::max(lhs.size(), rhs.size()) / 2;
+
+    if(rhs.size() <= split || lhs.size() <= split)
+      {
+      auto const & longer = lhs.size() > rhs.size() ? lhs : rhs;
+      auto const & shorter = lhs.size() > rhs.size() ? rhs : lhs;
+
+      auto result = __cpa_limbs_multiply(__cpa_limbs_slice(longer, 0, split), shorter);
+      __cpa_limbs_add_at(result, __cpa_limbs_multiply(__cpa_limbs_slice(longer, split, longer.size()), shorter), split);
+      __cpa_limbs_trim(result);
+      return result;
+      }
+
+    auto const lhs_low = __cpa_limbs_slice(lhs, 0, split);
+    auto const lhs_high = __cpa_limbs_slice(lhs, split, lhs.size());
+    auto const rhs_low = __cpa_limbs_slice(rhs, 0, split);
+    auto const rhs_high = __cpa_limbs_slice(rhs, split, rhs.size());
+
+    auto const low = __cpa_limbs_multiply(lhs_low, rhs_low);
+    auto const high = __cpa_limbs_multiply(lhs_high, rhs_high);
+    auto middle = __cpa_limbs_multiply(__cpa_limbs_add(lhs_low, lhs_high), __cpa_limbs_add(rhs_low, rhs_high));
+    __cpa_limbs_subtract_from(middle, low);
+    __cpa_limbs_subtract_from(middle, high);
+
+    auto result = low;
+    __cpa_limbs_add_at(result, middle, split);
+    __cpa_limbs_add_at(result, high, 2 * split);
+    __cpa_limbs_trim(result);
+    return result;
+    }
+
+  /*
+   * Divide a magnitude by a single digit in place, returning the remainder.
+   */
+  inline std::uint32_t __cpa_limbs_divide_digit(__cpa_limbs & limbs, std::uint32_t const divisor) noexcept
+    {
+    std::uint64_t remainder{};
+
+    for(auto index = limbs.size(); index-- > 0;)
+      {
+      auto const current = (remainder << 32) | limbs[index];
+      limbs[index] = static_cast<std::uint32_t>(current / divisor);
+      remainder = current % divisor;
+      }
+
+    __cpa_limbs_trim(limbs);
+    return static_cast<std::uint32_t>(remainder);
+    }
+
+  /*
+   * Divide two magnitudes using Knuth's Algorithm D (TAOCP Vol. 2, 4.3.1). The divisor must not be zero.
+   */
+  inline void __cpa_limbs_divide(__cpa_limbs const & dividend, __cpa_limbs const & divisor, __cpa_limbs & quotient,
+                                 __cpa_limbs & remainder)
+    {
+    if(__cpa_limbs_compare(dividend, divisor) < 0)
+      {
+      quotient.clear();
+      remainder = dividend;
+      return;
+      }
+
+    if(divisor.size() == 1)
+      {
+      quotient = dividend;
+      auto const digit = __cpa_limbs_divide_digit(quotient, divisor[0]);
+      remainder = __cpa_limbs_from(digit);
+      return;
+      }
+
+    constexpr auto base = std::uint64_t{1} << 32;
+    auto const length = dividend.size();
+    auto const divisor_length = divisor.size();
+
+    auto shift = 0;
+    for(auto top = divisor.back(); !(top & 0x80000000u); top <<= 1)
+      {
+      ++shift;
+      }
+
+    auto normalized_divisor = __cpa_limbs(divisor_length);
+    for(auto index = divisor_length - 1; index > 0; --index)
+      {
+      normalized_divisor[index] = static_cast<std::uint32_t>((static_cast<std::uint64_t>(divisor[index]) << shift) |
+                                                             (static_cast<std::uint64_t>(divisor[index - 1]) >> (32 - shift)));
+      }
+    normalized_divisor[0] = divisor[0] << shift;
+
+    auto normalized_dividend = __cpa_limbs(length + 1);
+    normalized_dividend[length] = static_cast<std::uint32_t>(static_cast<std::uint64_t>(dividend[length - 1]) >> (32 - shift));
+    for(auto index = length - 1; index > 0; --index)
+      {
+      normalized_dividend[index] = static_cast<std::uint32_t>((static_cast<std::uint64_t>(dividend[index]) << shift) |
+                                                              (static_cast<std::uint64_t>(dividend[index - 1]) >> (32 - shift)));
+      }
+    normalized_dividend[0] = dividend[0] << shift;
+
+    quotient.assign(length - divisor_length + 1, 0);
+
+    for(auto position = length - divisor_length + 1; position-- > 0;)
+      {
+      auto const numerator = (static_cast<std::uint64_t>(normalized_dividend[position + divisor_length]) << 32) |
+                             normalized_dividend[position + divisor_length - 1];
+      auto estimate = numerator / normalized_divisor[divisor_length - 1];
+      auto rest = numerator % normalized_divisor[divisor_length - 1];
+
+      while(estimate >= base ||
+            estimate * normalized_divisor[divisor_length - 2] > ((rest << 32) | normalized_dividend[position + divisor_length - 2]))
+        {
+        --estimate;
+        rest += normalized_divisor[divisor_length - 1];
+
+        if(rest >= base)
+          {
+          break;
+          }
+        }
+
+      std::int64_t borrow{};
+      std::int64_t difference{};
+
+      for(std::size_t index{}; index < divisor_length; ++index)
+        {
+        auto const product = estimate * normalized_divisor[index];
+        difference = static_cast<std::int64_t>(normalized_dividend[index + position]) - borrow -
+                     static_cast<std::int64_t>(product & 0xFFFFFFFFu);
+        normalized_dividend[index + position] = static_cast<std::uint32_t>(difference);
+        borrow = static_cast<std::int64_t>(product >> 32) - (difference >> 32);
+        }
+
+      difference = static_cast<std::int64_t>(normalized_dividend[position + divisor_length]) - borrow;
+      normalized_dividend[position + divisor_length] = static_cast<std::uint32_t>(difference);
+      quotient[position] = static_cast<std::uint32_t>(estimate);
+
+      if(difference < 0)
+        {
+        --quotient[position];
+        std::uint64_t carry{};
+
+        for(std::size_t index{}; index < divisor_length; ++index)
+          {
+          auto const sum = static_cast<std::uint64_t>(normalized_dividend[index + position]) + normalized_divisor[index] + carry;
+          normalized_dividend[index + position] = static_cast<std::uint32_t>(sum);
+          carry = sum >> 32;
+          }
+
+        normalized_dividend[position + divisor_length] += static_cast<std::uint32_t>(carry);
+        }
+      }
+
+    remainder.assign(divisor_length, 0);
+    for(std::size_t index{}; index < divisor_length; ++index)
+      {
+      remainder[index] = static_cast<std::uint32_t>((static_cast<std::uint64_t>(normalized_dividend[index]) >> shift) |
+                                                    (static_cast<std::uint64_t>(normalized_dividend[index + 1]) << (32 - shift)));
+      }
+
+    __cpa_limbs_trim(quotient);
+    __cpa_limbs_trim(remainder);
+    }
+  }
+
+#endif
+
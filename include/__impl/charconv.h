@@ -0,0 +1,114 @@
+#ifndef __CPA_IMPL__CHARCONV
+#define __CPA_IMPL__CHARCONV
+
+#include <__impl/numeric.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <type_traits>
+
+namespace cpa
+  {
+  /*
+   * The decimal digits of all numbers from 00 to 99, used to format two digits per division.
+   */
+  inline char const * __cpa_digit_pairs() noexcept
+    {
+    static constexpr char pairs[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                                    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                                    "8081828384858687888990919293949596979899";
+    return pairs;
+    }
+
+  /*
+   * Magnitudes of at most 64 bits are formatted and parsed as std::uint64_t, since division by a constant is cheapest there.
+   */
+  template<typename Integral>
+  using __cpa_text_magnitude_t = std::conditional_t<(sizeof(Integral) <= sizeof(std::uint64_t)), std::uint64_t,
+                                                    __cpa_make_unsigned_t<Integral>>;
+
+  /*
+   * Write the decimal digits of value into [first, last) without a terminating null character. Returns nullptr if the digits
+   * do not fit.
+   */
+  template<typename Unsigned>
+  char * __cpa_write_digits(char * const first, char * const last, Unsigned value) noexcept
+    {
+    char buffer[sizeof(Unsigned) * 3];
+    auto position = buffer + sizeof(buffer);
+
+    while(value >= 100)
+      {
+      auto const pair = static_cast<std::size_t>(value % 100) * 2;
+      value /= 100;
+      *--position = __cpa_digit_pairs()[pair + 1];
+      *--position = __cpa_digit_pairs()[pair];
+      }
+
+    if(value >= 10)
+      {
+      auto const pair = static_cast<std::size_t>(value) * 2;
+      *--position = __cpa_digit_pairs()[pair + 1];
+      *--position = __cpa_digit_pairs()[pair];
+      }
+    else
+      {
+      *--position = static_cast<char>('0' + value);
+      }
+
+    auto const length = static_cast<std::size_t>(buffer + sizeof(buffer) - position);
+
+    if(static_cast<std::size_t>(last - first) < length)
+      {
+      return nullptr;
+      }
+
+    std::memcpy(first, position, length);
+    return first + length;
+    }
+
+  /*
+   * Parse a non-empty sequence of decimal digits from [first, last) into value, which must not exceed limit. On success, the
+   * returned error is empty. The returned pointer is first if there is no digit, and otherwise points past the last digit.
+   */
+  template<typename Unsigned>
+  char const * __cpa_parse_digits(char const * first, char const * const last, Unsigned const limit, Unsigned & value,
+                                  std::errc & error) noexcept
+    {
+    auto const begin = first;
+    auto result = Unsigned{};
+    auto overflow = false;
+
+    for(; first != last && static_cast<unsigned char>(*first - '0') < 10; ++first)
+      {
+      auto const digit = static_cast<Unsigned>(*first - '0');
+
+      if(result > (limit - digit) / 10)
+        {
+        overflow = true;
+        }
+
+      result = static_cast<Unsigned>(result * 10 + digit);
+      }
+
+    if(first == begin)
+      {
+      error = std::errc::invalid_argument;
+      }
+    else if(overflow)
+      {
+      error = std::errc::result_out_of_range;
+      }
+    else
+      {
+      error = std::errc{};
+      value = result;
+      }
+
+    return first;
+    }
+  }
+
+#endif
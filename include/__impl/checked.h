@@ -0,0 +1,131 @@
+#ifndef __CPA_IMPL__CHECKED
+#define __CPA_IMPL__CHECKED
+
+#include <__impl/numeric.h>
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace cpa
+  {
+  /*
+   * The integral type of twice the width of Integral, with the same signedness, or void if there is no such type.
+   */
+  template<typename Integral, typename = void>
+  struct __cpa_widened { using type = void; };
+
+  template<typename Integral>
+  struct __cpa_widened<Integral, std::enable_if_t<std::is_integral<Integral>::value && (sizeof(Integral) <= sizeof(std::uint32_t))>>
+    {
+    using type = std::conditional_t<std::is_signed<Integral>::value, std::int64_t, std::uint64_t>;
+    };
+
+#if defined(__SIZEOF_INT128__)
+  template<typename Integral>
+  struct __cpa_widened<Integral, std::enable_if_t<std::is_integral<Integral>::value && sizeof(Integral) == sizeof(std::uint64_t)>>
+    {
+    using type = std::conditional_t<std::is_signed<Integral>::value, __cpa_int128, __cpa_uint128>;
+    };
+#endif
+
+  template<typename Integral>
+  using __cpa_widened_t = typename __cpa_widened<Integral>::type;
+
+#if defined(__GNUC__)
+  template<typename Integral>
+  constexpr bool __cpa_add_overflow(Integral const lhs, Integral const rhs, Integral & result) noexcept
+    {
+    return __builtin_add_overflow(lhs, rhs, &result);
+    }
+
+  template<typename Integral>
+  constexpr bool __cpa_subtract_overflow(Integral const lhs, Integral const rhs, Integral & result) noexcept
+    {
+    return __builtin_sub_overflow(lhs, rhs, &result);
+    }
+
+  template<typename Integral>
+  constexpr bool __cpa_multiply_overflow(Integral const lhs, Integral const rhs, Integral & result) noexcept
+    {
+    return __builtin_mul_overflow(lhs, rhs, &result);
+    }
+#else
+  template<typename Integral>
+  constexpr bool __cpa_add_overflow(Integral const lhs, Integral const rhs, Integral & result) noexcept
+    {
+    using limits = std::numeric_limits<Integral>;
+
+    if(__cpa_is_negative(rhs) ? lhs < limits::min() - rhs : lhs > limits::max() - rhs)
+      {
+      return true;
+      }
+
+    result = lhs + rhs;
+    return false;
+    }
+
+  template<typename Integral>
+  constexpr bool __cpa_subtract_overflow(Integral const lhs, Integral const rhs, Integral & result) noexcept
+    {
+    using limits = std::numeric_limits<Integral>;
+
+    if(__cpa_is_negative(rhs) ? lhs > limits::max() + rhs : lhs < limits::min() + rhs)
+      {
+      return true;
+      }
+
+    result = lhs - rhs;
+    return false;
+    }
+
+  template<typename Integral>
+  constexpr bool __cpa_multiply_overflow(Integral const lhs, Integral const rhs, Integral & result) noexcept
+    {
+    using limits = std::numeric_limits<Integral>;
+
+    if(lhs && rhs)
+      {
+      auto const lhs_negative = __cpa_is_negative(lhs);
+      auto const rhs_negative = __cpa_is_negative(rhs);
+
+      if((!lhs_negative && !rhs_negative && lhs > limits::max() / rhs) ||
+         (!lhs_negative && rhs_negative && rhs < limits::min() / lhs) ||
+         (lhs_negative && !rhs_negative && lhs < limits::min() / rhs) ||
+         (lhs_negative && rhs_negative && rhs < limits::max() / lhs))
+        {
+        return true;
+        }
+      }
+
+    result = lhs * rhs;
+    return false;
+    }
+#endif
+
+  template<typename Target, typename Source>
+  constexpr bool __cpa_fits(Source const value, std::true_type) noexcept
+    {
+    return value <= static_cast<Source>(std::numeric_limits<Target>::max());
+    }
+
+  template<typename Target, typename Source>
+  constexpr bool __cpa_fits(Source const value, std::false_type) noexcept
+    {
+    return value >= static_cast<Source>(std::numeric_limits<Target>::min()) &&
+           value <= static_cast<Source>(std::numeric_limits<Target>::max());
+    }
+
+  /*
+   * Check whether value can be represented by Target. Both types must be integral and of the same signedness, with Target
+   * being the narrower one.
+   */
+  template<typename Target, typename Source>
+  constexpr bool __cpa_fits(Source const value) noexcept
+    {
+    return __cpa_fits<Target>(value, __cpa_is_unsigned_integral<Source>{});
+    }
+  }
+
+#endif
+
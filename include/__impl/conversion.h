@@ -0,0 +1,227 @@
+#ifndef __CPA_IMPL__CONVERSION
+#define __CPA_IMPL__CONVERSION
+
+#include <__impl/big_integer.h>
+#include <__impl/numeric.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace cpa
+  {
+  /*
+   * The unsigned integral type holding the bits of a binary floating point type.
+   */
+  template<typename Float>
+  using __cpa_float_bits_t = std::conditional_t<sizeof(Float) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+
+  /*
+   * Magnitudes of at most 64 bits are divided using 128-bit integers if they are available. Larger magnitudes are divided as
+   * sequences of limbs.
+   */
+  template<typename Unsigned>
+  struct __cpa_has_wide_quotient
+#if defined(__SIZEOF_INT128__)
+  : std::integral_constant<bool, sizeof(Unsigned) <= sizeof(std::uint64_t)> {};
+#else
+  : std::false_type {};
+#endif
+
+  template<typename Unsigned>
+  __cpa_limbs __cpa_limbs_from_magnitude(Unsigned value)
+    {
+    auto limbs = __cpa_limbs{};
+
+    for(; value; value = static_cast<Unsigned>(value >> 16 >> 16))
+      {
+      limbs.push_back(static_cast<std::uint32_t>(value));
+      }
+
+    return limbs;
+    }
+
+  /*
+   * Round mantissa to even, given the bit right below its last bit and whether any bit below that one is set.
+   */
+  inline std::uint64_t __cpa_round_to_even(std::uint64_t const mantissa, bool const half, bool const sticky) noexcept
+    {
+    return mantissa + (half && (sticky || (mantissa & 1u)));
+    }
+
+#if defined(__SIZEOF_INT128__)
+  /*
+   * Calculate the correctly rounded quotient of two non-zero magnitudes of at most 64 bits. The numerator is shifted to the top
+   * of a 128-bit integer, so that the integral quotient has at least 64 significant bits. Neither overflow nor underflow can
+   * occur in this case.
+   */
+  template<typename Float, typename Unsigned>
+  Float __cpa_divide_to_float(Unsigned const numerator, Unsigned const denominator, std::true_type)
+    {
+    constexpr auto precision = std::numeric_limits<Float>::digits;
+
+    auto const shift = 128 - __cpa_bits(numerator);
+    auto const dividend = static_cast<__cpa_uint128>(numerator) << shift;
+    auto const quotient = dividend / denominator;
+    auto const drop = __cpa_bits(quotient) - precision;
+
+    auto const mantissa = static_cast<std::uint64_t>(quotient >> drop);
+    auto const half = static_cast<bool>((quotient >> (drop - 1)) & 1u);
+    auto const sticky = (quotient & ((__cpa_uint128{1} << (drop - 1)) - 1)) || dividend % denominator;
+
+    return std::ldexp(static_cast<Float>(__cpa_round_to_even(mantissa, half, sticky)), drop - shift);
+    }
+#endif
+
+  /*
+   * Calculate the correctly rounded quotient of two non-zero magnitudes of arbitrary size. The numerator is scaled, so that
+   * the integral quotient has at least two bits more than the mantissa of Float. Quotients in the subnormal range are rounded
+   * to the reduced precision available there.
+   */
+  template<typename Float, typename Unsigned>
+  Float __cpa_divide_to_float(Unsigned const numerator, Unsigned const denominator, std::false_type)
+    {
+    constexpr auto precision = std::numeric_limits<Float>::digits;
+    constexpr auto minimum = std::numeric_limits<Float>::min_exponent - 1;
+
+    auto const numerator_bits = __cpa_bits(numerator);
+    auto const denominator_bits = __cpa_bits(denominator);
+    auto const scale = std::max(0, precision + 2 + denominator_bits - numerator_bits);
+
+    auto quotient = __cpa_limbs{};
+    auto remainder = __cpa_limbs{};
+    __cpa_limbs_divide(__cpa_limbs_shift_left(__cpa_limbs_from_magnitude(numerator), static_cast<std::size_t>(scale)),
+                       __cpa_limbs_from_magnitude(denominator), quotient, remainder);
+
+    auto const bits = static_cast<int>(__cpa_limbs_bit_length(quotient));
+    auto const exponent = bits - 1 - scale;
+    auto const available = exponent < minimum ? precision - (minimum - exponent) : precision;
+
+    if(available < 0)
+      {
+      return Float{0};
+      }
+
+    auto const drop = static_cast<std::size_t>(bits - available);
+    auto const mantissa = available ? __cpa_limbs_extract(quotient, drop) : std::uint64_t{};
+    auto const half = __cpa_limbs_test_bit(quotient, drop - 1);
+    auto const sticky = __cpa_limbs_any_below(quotient, drop - 1) || !remainder.empty();
+
+    return std::ldexp(static_cast<Float>(__cpa_round_to_even(mantissa, half, sticky)), static_cast<int>(drop) - scale);
+    }
+
+  /*
+   * Convert the quotient of two integral values, the second of which is non-zero, to the nearest value of type Float, with
+   * ties rounded to even. If both magnitudes are exactly representable in Float, the division of the converted values is
+   * already correctly rounded.
+   */
+  template<typename Float, typename Integral>
+  Float __cpa_to_float(Integral const numerator, Integral const denominator)
+    {
+    using unsigned_t = std::conditional_t<(sizeof(Integral) <= sizeof(std::uint64_t)), std::uint64_t,
+                                          __cpa_make_unsigned_t<Integral>>;
+
+    if(!numerator)
+      {
+      return Float{0};
+      }
+
+    auto const negative = __cpa_is_negative(numerator) != __cpa_is_negative(denominator);
+    auto const numerator_magnitude = static_cast<unsigned_t>(__cpa_magnitude(numerator));
+    auto const denominator_magnitude = static_cast<unsigned_t>(__cpa_magnitude(denominator));
+
+    constexpr auto exact = unsigned_t{1} << std::numeric_limits<Float>::digits;
+
+    auto const magnitude = numerator_magnitude <= exact && denominator_magnitude <= exact ?
+      static_cast<Float>(numerator_magnitude) / static_cast<Float>(denominator_magnitude) :
+      __cpa_divide_to_float<Float>(numerator_magnitude, denominator_magnitude, __cpa_has_wide_quotient<unsigned_t>{});
+
+    return negative ? -magnitude : magnitude;
+    }
+
+  /*
+   * Decompose a finite binary floating point value into a sign, an integral mantissa and a binary exponent, such that the
+   * value is the mantissa times two to the power of the exponent. Trailing zero bits of the mantissa are moved into the
+   * exponent.
+   */
+  template<typename Float>
+  void __cpa_decompose(Float const value, bool & negative, std::uint64_t & mantissa, int & exponent)
+    {
+    using bits_t = __cpa_float_bits_t<Float>;
+
+    static_assert(std::numeric_limits<Float>::is_iec559 && sizeof(Float) == sizeof(bits_t),
+                  "Only IEEE 754 binary32 and binary64 values can be decomposed");
+
+    constexpr auto fraction_bits = std::numeric_limits<Float>::digits - 1;
+    constexpr auto bias = std::numeric_limits<Float>::max_exponent - 1;
+    constexpr auto exponent_mask = static_cast<bits_t>(2 * std::numeric_limits<Float>::max_exponent - 1);
+
+    auto bits = bits_t{};
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    auto const biased = static_cast<int>((bits >> fraction_bits) & exponent_mask);
+    auto const fraction = static_cast<std::uint64_t>(bits & ((bits_t{1} << fraction_bits) - 1));
+
+    if(biased == static_cast<int>(exponent_mask))
+      {
+      throw std::domain_error{"Can not convert infinity or NaN to a rational number"};
+      }
+
+    negative = static_cast<bool>(bits >> (sizeof(bits_t) * 8 - 1));
+    mantissa = biased ? fraction | (std::uint64_t{1} << fraction_bits) : fraction;
+    exponent = (biased ? biased : 1) - bias - fraction_bits;
+
+    if(mantissa && exponent < 0)
+      {
+      auto const shift = std::min(__cpa_ctz(mantissa), -exponent);
+      mantissa >>= shift;
+      exponent += shift;
+      }
+    }
+
+  /*
+   * Convert a finite binary floating point value to the numerator and denominator of the exactly equal, reduced fraction.
+   * Since the denominator is a power of two and the mantissa has no trailing zeros if the exponent is negative, the fraction
+   * is reduced by construction.
+   */
+  template<typename Integral, typename Float>
+  void __cpa_from_float(Float const value, Integral & numerator, Integral & denominator)
+    {
+    using unsigned_t = __cpa_make_unsigned_t<Integral>;
+
+    constexpr auto digits = static_cast<int>(sizeof(Integral) * 8) - __cpa_is_signed_integral<Integral>::value;
+
+    auto negative = false;
+    auto mantissa = std::uint64_t{};
+    auto exponent = 0;
+    __cpa_decompose(value, negative, mantissa, exponent);
+
+    if(!mantissa)
+      {
+      numerator = Integral{0};
+      denominator = Integral{1};
+      return;
+      }
+
+    if(negative && !__cpa_is_signed_integral<Integral>::value)
+      {
+      throw std::domain_error{"Can not convert a negative value to an unsigned representation"};
+      }
+
+    if(__cpa_bits(mantissa) + std::max(exponent, 0) > digits || -exponent >= digits)
+      {
+      throw std::domain_error{"The value is not representable with the given representation type"};
+      }
+
+    auto const magnitude = static_cast<unsigned_t>(static_cast<unsigned_t>(mantissa) << std::max(exponent, 0));
+    numerator = static_cast<Integral>(negative ? unsigned_t{0} - magnitude : magnitude);
+    denominator = static_cast<Integral>(unsigned_t{1} << std::max(-exponent, 0));
+    }
+  }
+
+#endif
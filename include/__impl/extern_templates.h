@@ -0,0 +1,29 @@
+#ifndef __CPA_IMPL__EXTERN_TEMPLATES
+#define __CPA_IMPL__EXTERN_TEMPLATES
+
+/*
+ * Support for explicit instantiations of the library templates for the common representation types.
+ *
+ * If CPA_EXTERN_TEMPLATES is defined, the headers declare these instantiations as extern, so that translation units do not
+ * have to instantiate them. The definitions are provided by the library built from src/extern_templates.cpp, which defines
+ * __CPA_DEFINE_EXTERN_TEMPLATES before including the headers.
+ */
+#if defined(CPA_EXTERN_TEMPLATES) || defined(__CPA_DEFINE_EXTERN_TEMPLATES)
+#define __CPA_USE_EXTERN_TEMPLATES 1
+
+#if defined(__CPA_DEFINE_EXTERN_TEMPLATES)
+#define __CPA_EXTERN_TEMPLATE template
+#else
+#define __CPA_EXTERN_TEMPLATE extern template
+#endif
+
+#define __CPA_FOR_EACH_EXTERN_REP(Apply) \
+  Apply(int) \
+  Apply(long) \
+  Apply(long long) \
+  Apply(unsigned int) \
+  Apply(unsigned long) \
+  Apply(unsigned long long)
+#endif
+
+#endif
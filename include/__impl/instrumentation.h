@@ -0,0 +1,159 @@
+#ifndef __CPA_IMPL__INSTRUMENTATION
+#define __CPA_IMPL__INSTRUMENTATION
+
+#include <cstddef>
+
+/*
+ * Hot-path instrumentation hooks. If CPA_INSTRUMENTATION is not defined, __CPA_INSTRUMENT only evaluates its iterations
+ * argument, which is a plain local counter at every call site, and the compiler removes it together with the hook.
+ */
+#if defined(CPA_INSTRUMENTATION)
+
+#if !defined(__has_builtin)
+#error "CPA_INSTRUMENTATION requires __builtin_is_constant_evaluated"
+#elif !__has_builtin(__builtin_is_constant_evaluated)
+#error "CPA_INSTRUMENTATION requires __builtin_is_constant_evaluated"
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#define __CPA_INSTRUMENT(operation, iterations, bits) \
+  ::cpa::__cpa_instrument(::cpa::__cpa_operation::operation, iterations, bits)
+
+#else
+
+#define __CPA_INSTRUMENT(operation, iterations, bits) static_cast<void>(iterations)
+
+#endif
+
+namespace cpa
+  {
+  enum struct __cpa_operation : std::size_t
+    {
+    gcd,
+    lcm,
+    reduce,
+    common,
+    expand,
+    };
+
+  constexpr std::size_t __cpa_operation_count = 5;
+  constexpr std::size_t __cpa_magnitude_buckets = 129;
+
+#if defined(CPA_INSTRUMENTATION)
+  /*
+   * The counters of a single thread. Only the owning thread modifies them, so the increments are plain loads and stores, while
+   * the atomics make it safe to read them from other threads.
+   */
+  struct __cpa_thread_counters
+    {
+    __cpa_thread_counters();
+    ~__cpa_thread_counters();
+
+    std::atomic<std::uint64_t> calls[__cpa_operation_count];
+    std::atomic<std::uint64_t> iterations[__cpa_operation_count];
+    std::atomic<std::uint64_t> magnitudes[__cpa_operation_count][__cpa_magnitude_buckets];
+    };
+
+  /*
+   * The counters of all live threads, and the totals of the threads that have already exited. The registry is never destroyed,
+   * since threads exiting during the destruction of static objects, like the workers of the thread pool, still report to it.
+   */
+  struct __cpa_counter_registry
+    {
+    std::mutex mutex;
+    std::vector<__cpa_thread_counters *> threads;
+    std::uint64_t calls[__cpa_operation_count];
+    std::uint64_t iterations[__cpa_operation_count];
+    std::uint64_t magnitudes[__cpa_operation_count][__cpa_magnitude_buckets];
+    };
+
+  inline __cpa_counter_registry & __cpa_counters() noexcept
+    {
+    static auto & registry = *new __cpa_counter_registry{};
+    return registry;
+    }
+
+  inline __cpa_thread_counters::__cpa_thread_counters()
+    {
+    for(std::size_t operation{}; operation < __cpa_operation_count; ++operation)
+      {
+      calls[operation].store(0, std::memory_order_relaxed);
+      iterations[operation].store(0, std::memory_order_relaxed);
+
+      for(auto & bucket : magnitudes[operation])
+        {
+        bucket.store(0, std::memory_order_relaxed);
+        }
+      }
+
+    auto & registry = __cpa_counters();
+    std::lock_guard<std::mutex> lock{registry.mutex};
+    registry.threads.push_back(this);
+    }
+
+  inline __cpa_thread_counters::~__cpa_thread_counters()
+    {
+    auto & registry = __cpa_counters();
+    std::lock_guard<std::mutex> lock{registry.mutex};
+
+    for(std::size_t operation{}; operation < __cpa_operation_count; ++operation)
+      {
+      registry.calls[operation] += calls[operation].load(std::memory_order_relaxed);
+      registry.iterations[operation] += iterations[operation].load(std::memory_order_relaxed);
+
+      for(std::size_t bucket{}; bucket < __cpa_magnitude_buckets; ++bucket)
+        {
+        registry.magnitudes[operation][bucket] += magnitudes[operation][bucket].load(std::memory_order_relaxed);
+        }
+      }
+
+    for(auto & thread : registry.threads)
+      {
+      if(thread == this)
+        {
+        thread = registry.threads.back();
+        registry.threads.pop_back();
+        break;
+        }
+      }
+    }
+
+  inline void __cpa_increment(std::atomic<std::uint64_t> & counter, std::uint64_t const amount) noexcept
+    {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+  inline void __cpa_record(__cpa_operation const operation, std::uint64_t const iterations, int const bits)
+    {
+    static thread_local __cpa_thread_counters counters{};
+
+    auto const index = static_cast<std::size_t>(operation);
+    __cpa_increment(counters.calls[index], 1);
+    __cpa_increment(counters.iterations[index], iterations);
+
+    if(bits >= 0 && static_cast<std::size_t>(bits) < __cpa_magnitude_buckets)
+      {
+      __cpa_increment(counters.magnitudes[index][bits], 1);
+      }
+    }
+
+  /*
+   * Record one call of operation that took the given number of loop iterations and produced a result with a magnitude of the
+   * given number of bits. A negative number of bits signals that the magnitude is unknown. Nothing is recorded during
+   * constant evaluation.
+   */
+  constexpr void __cpa_instrument(__cpa_operation const operation, std::uint64_t const iterations, int const bits)
+    {
+    if(!__builtin_is_constant_evaluated())
+      {
+      __cpa_record(operation, iterations, bits);
+      }
+    }
+#endif
+  }
+
+#endif
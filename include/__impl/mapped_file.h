@@ -0,0 +1,89 @@
+#ifndef __CPA_IMPL__MAPPED_FILE
+#define __CPA_IMPL__MAPPED_FILE
+
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cpa
+  {
+  /*
+   * Read-only mapping of a whole file into memory. Failures to open or map the file are reported as std::system_error. An
+   * empty file is not mapped at all, and its data is nullptr.
+   */
+  struct __cpa_mapped_file
+    {
+    explicit __cpa_mapped_file(char const * const path)
+      : m_descriptor{::open(path, O_RDONLY)}
+      {
+      if(m_descriptor < 0)
+        {
+        throw std::system_error{errno, std::generic_category(), "Failed to open file"};
+        }
+
+      struct stat status{};
+
+      if(::fstat(m_descriptor, &status))
+        {
+        fail("Failed to determine the size of file");
+        }
+
+      m_size = static_cast<std::size_t>(status.st_size);
+
+      if(m_size)
+        {
+        auto const address = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_descriptor, 0);
+
+        if(address == MAP_FAILED)
+          {
+          fail("Failed to map file");
+          }
+
+        ::madvise(address, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<char const *>(address);
+        }
+      }
+
+    __cpa_mapped_file(__cpa_mapped_file const &) = delete;
+    __cpa_mapped_file & operator = (__cpa_mapped_file const &) = delete;
+
+    ~__cpa_mapped_file()
+      {
+      if(m_data)
+        {
+        ::munmap(const_cast<char *>(m_data), m_size);
+        }
+
+      ::close(m_descriptor);
+      }
+
+    char const * data() const noexcept
+      {
+      return m_data;
+      }
+
+    std::size_t size() const noexcept
+      {
+      return m_size;
+      }
+
+    private:
+      [[noreturn]] void fail(char const * const message)
+        {
+        auto const error = errno;
+        ::close(m_descriptor);
+        throw std::system_error{error, std::generic_category(), message};
+        }
+
+      int m_descriptor;
+      char const * m_data{};
+      std::size_t m_size{};
+    };
+  }
+
+#endif
@@ -0,0 +1,317 @@
+#ifndef __CPA_IMPL__NUMERIC
+#define __CPA_IMPL__NUMERIC
+
+#include <__impl/instrumentation.h>
+#include <__impl/type_traits.h>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace cpa
+  {
+  /*
+   * The standard library does not consider the 128-bit integer extension integral in strict conformance mode, so these traits
+   * complement the standard ones for the types used internally for widening.
+   */
+  template<typename Type>
+  struct __cpa_is_signed_integral : std::integral_constant<bool, std::is_integral<Type>::value && std::is_signed<Type>::value> {};
+
+  template<typename Type>
+  struct __cpa_is_unsigned_integral : std::integral_constant<bool, std::is_integral<Type>::value && std::is_unsigned<Type>::value> {};
+
+  template<typename Integral>
+  struct __cpa_make_unsigned { using type = std::make_unsigned_t<Integral>; };
+
+#if defined(__SIZEOF_INT128__)
+  template<>
+  struct __cpa_is_signed_integral<__cpa_int128> : std::true_type {};
+
+  template<>
+  struct __cpa_is_unsigned_integral<__cpa_uint128> : std::true_type {};
+
+  template<>
+  struct __cpa_make_unsigned<__cpa_int128> { using type = __cpa_uint128; };
+
+  template<>
+  struct __cpa_make_unsigned<__cpa_uint128> { using type = __cpa_uint128; };
+#endif
+
+  template<typename Integral>
+  using __cpa_make_unsigned_t = typename __cpa_make_unsigned<Integral>::type;
+
+  template<typename Type>
+  struct __cpa_is_binary_gcd_capable
+  : std::integral_constant<bool, (__cpa_is_signed_integral<Type>::value || __cpa_is_unsigned_integral<Type>::value) &&
+                                 !std::is_same<std::remove_cv_t<Type>, bool>::value> {};
+
+  constexpr int __cpa_count_trailing_zeros(unsigned int const value) noexcept
+    {
+#if defined(__GNUC__)
+    return __builtin_ctz(value);
+#else
+    auto count = 0;
+    for(auto current = value; !(current & 1u); current >>= 1)
+      {
+      ++count;
+      }
+    return count;
+#endif
+    }
+
+  constexpr int __cpa_count_trailing_zeros(unsigned long const value) noexcept
+    {
+#if defined(__GNUC__)
+    return __builtin_ctzl(value);
+#else
+    auto count = 0;
+    for(auto current = value; !(current & 1ul); current >>= 1)
+      {
+      ++count;
+      }
+    return count;
+#endif
+    }
+
+  constexpr int __cpa_count_trailing_zeros(unsigned long long const value) noexcept
+    {
+#if defined(__GNUC__)
+    return __builtin_ctzll(value);
+#else
+    auto count = 0;
+    for(auto current = value; !(current & 1ull); current >>= 1)
+      {
+      ++count;
+      }
+    return count;
+#endif
+    }
+
+#if defined(__SIZEOF_INT128__)
+  constexpr int __cpa_count_trailing_zeros(__cpa_uint128 const value) noexcept
+    {
+    auto const low = static_cast<unsigned long long>(value);
+    return low ? __cpa_count_trailing_zeros(low) : 64 + __cpa_count_trailing_zeros(static_cast<unsigned long long>(value >> 64));
+    }
+#endif
+
+  /*
+   * Count the trailing zero bits of a non-zero unsigned value. Types narrower than unsigned int are widened first, so that
+   * overload resolution always picks an exact match.
+   */
+  template<typename Unsigned>
+  constexpr int __cpa_ctz(Unsigned const value) noexcept
+    {
+    return __cpa_count_trailing_zeros(static_cast<std::common_type_t<Unsigned, unsigned int>>(value));
+    }
+
+  constexpr int __cpa_bit_length(unsigned long long const value) noexcept
+    {
+#if defined(__GNUC__)
+    return value ? 64 - __builtin_clzll(value) : 0;
+#else
+    auto count = 0;
+    for(auto current = value; current; current >>= 1)
+      {
+      ++count;
+      }
+    return count;
+#endif
+    }
+
+#if defined(__SIZEOF_INT128__)
+  constexpr int __cpa_bit_length(__cpa_uint128 const value) noexcept
+    {
+    auto const high = static_cast<unsigned long long>(value >> 64);
+    return high ? 64 + __cpa_bit_length(high) : __cpa_bit_length(static_cast<unsigned long long>(value));
+    }
+#endif
+
+  /*
+   * Get the number of bits required to represent an unsigned value, which is 0 for 0.
+   */
+  template<typename Unsigned>
+  constexpr int __cpa_bits(Unsigned const value) noexcept
+    {
+    return __cpa_bit_length(static_cast<std::conditional_t<(sizeof(Unsigned) > sizeof(unsigned long long)), Unsigned,
+                                                           unsigned long long>>(value));
+    }
+
+  template<typename Integral>
+  constexpr __cpa_make_unsigned_t<Integral> __cpa_magnitude(Integral const value, std::true_type) noexcept
+    {
+    using unsigned_t = __cpa_make_unsigned_t<Integral>;
+    return value < 0 ? static_cast<unsigned_t>(unsigned_t{0} - static_cast<unsigned_t>(value)) : static_cast<unsigned_t>(value);
+    }
+
+  template<typename Integral>
+  constexpr __cpa_make_unsigned_t<Integral> __cpa_magnitude(Integral const value, std::false_type) noexcept
+    {
+    return value;
+    }
+
+  /*
+   * Get the magnitude of an integral value as the corresponding unsigned type. Unlike cpa::abs, this is well-defined for the
+   * most negative value of a signed type.
+   */
+  template<typename Integral>
+  constexpr __cpa_make_unsigned_t<Integral> __cpa_magnitude(Integral const value) noexcept
+    {
+    return __cpa_magnitude(value, __cpa_is_signed_integral<Integral>{});
+    }
+
+  /*
+   * Get the largest value of Integral. Unlike std::numeric_limits, this also works for the 128-bit integers in strict
+   * conformance mode.
+   */
+  template<typename Integral>
+  constexpr Integral __cpa_max_value() noexcept
+    {
+    using unsigned_t = __cpa_make_unsigned_t<Integral>;
+    return static_cast<Integral>(__cpa_is_signed_integral<Integral>::value ? static_cast<unsigned_t>(~unsigned_t{0}) >> 1
+                                                                           : static_cast<unsigned_t>(~unsigned_t{0}));
+    }
+
+  /*
+   * Get the value of type Integral with the given magnitude and sign. The value must be representable by Integral, which
+   * includes the most negative value of a signed type.
+   */
+  template<typename Integral, typename Unsigned>
+  constexpr Integral __cpa_apply_sign(Unsigned const magnitude, bool const negative) noexcept
+    {
+    return negative ? static_cast<Integral>(Unsigned{0} - magnitude) : static_cast<Integral>(magnitude);
+    }
+
+  template<typename Type>
+  constexpr int __cpa_magnitude_bits(Type const & value, std::true_type) noexcept
+    {
+    return __cpa_bits(__cpa_magnitude(value));
+    }
+
+  template<typename Type>
+  constexpr int __cpa_magnitude_bits(Type const &, std::false_type) noexcept
+    {
+    return -1;
+    }
+
+  /*
+   * Get the number of bits required to represent the magnitude of a value, or -1 if the type of the value is not integral. This
+   * is the bucket of the value in the magnitude histograms of the instrumentation.
+   */
+  template<typename Type>
+  constexpr int __cpa_magnitude_bits(Type const & value) noexcept
+    {
+    return __cpa_magnitude_bits(value, std::integral_constant<bool, __cpa_is_signed_integral<Type>::value ||
+                                                                    __cpa_is_unsigned_integral<Type>::value>{});
+    }
+
+  template<typename Type>
+  constexpr bool __cpa_is_negative(Type const &, std::true_type) noexcept
+    {
+    return false;
+    }
+
+  template<typename Type>
+  constexpr bool __cpa_is_negative(Type const & value, std::false_type)
+    {
+    return value < Type{0};
+    }
+
+  /*
+   * Check whether a value is less than zero, without comparing unsigned values against zero.
+   */
+  template<typename Type>
+  constexpr bool __cpa_is_negative(Type const & value)
+    {
+    return __cpa_is_negative(value, __cpa_is_unsigned_integral<Type>{});
+    }
+
+  template<typename Unsigned>
+  constexpr Unsigned __cpa_binary_gcd(Unsigned left, Unsigned right) noexcept
+    {
+    if(!left || !right)
+      {
+      __CPA_INSTRUMENT(gcd, 0, __cpa_bits(static_cast<Unsigned>(left | right)));
+      return left | right;
+      }
+
+    auto const shift = __cpa_ctz(static_cast<Unsigned>(left | right));
+    left >>= __cpa_ctz(left);
+    std::uint64_t iterations{};
+
+    do
+      {
+      ++iterations;
+      right >>= __cpa_ctz(right);
+
+      if(left > right)
+        {
+        auto const temporary = left;
+        left = right;
+        right = temporary;
+        }
+
+      right -= left;
+      }
+    while(right);
+
+    auto const result = static_cast<Unsigned>(left << shift);
+    __CPA_INSTRUMENT(gcd, iterations, __cpa_bits(result));
+    return result;
+    }
+
+  template<typename Unsigned>
+  constexpr Unsigned __cpa_euclidean_gcd_32(Unsigned left, Unsigned right, std::uint64_t & iterations) noexcept
+    {
+    auto narrow_left = static_cast<std::uint32_t>(left);
+    auto narrow_right = static_cast<std::uint32_t>(right);
+
+    while(narrow_right)
+      {
+      ++iterations;
+      auto const remainder = narrow_left % narrow_right;
+      narrow_left = narrow_right;
+      narrow_right = remainder;
+      }
+
+    return static_cast<Unsigned>(narrow_left);
+    }
+
+  template<typename Unsigned>
+  constexpr Unsigned __cpa_narrowing_gcd(Unsigned left, Unsigned right, std::uint64_t & iterations, std::false_type) noexcept
+    {
+    return __cpa_euclidean_gcd_32(left, right, iterations);
+    }
+
+  template<typename Unsigned>
+  constexpr Unsigned __cpa_narrowing_gcd(Unsigned left, Unsigned right, std::uint64_t & iterations, std::true_type) noexcept
+    {
+    constexpr auto narrow_max = Unsigned{UINT32_MAX};
+
+    while(right && (left > narrow_max || right > narrow_max))
+      {
+      ++iterations;
+      auto const remainder = left % right;
+      left = right;
+      right = remainder;
+      }
+
+    return right ? __cpa_euclidean_gcd_32(left, right, iterations) : left;
+    }
+
+  /*
+   * Euclidean GCD that switches to 32-bit division as soon as both operands fit into 32 bits. On many targets, a 32-bit
+   * division has a considerably lower latency than a 64-bit one.
+   */
+  template<typename Unsigned>
+  constexpr Unsigned __cpa_narrowing_gcd(Unsigned left, Unsigned right) noexcept
+    {
+    std::uint64_t iterations{};
+    auto const result = __cpa_narrowing_gcd(left, right, iterations,
+                                            std::integral_constant<bool, (sizeof(Unsigned) > sizeof(std::uint32_t))>{});
+    __CPA_INSTRUMENT(gcd, iterations, __cpa_bits(result));
+    return result;
+    }
+  }
+
+#endif
+
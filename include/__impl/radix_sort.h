@@ -0,0 +1,79 @@
+#ifndef __CPA_IMPL__RADIX_SORT
+#define __CPA_IMPL__RADIX_SORT
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace cpa
+  {
+  /*
+   * A sort key paired with the position of its element in the unsorted range.
+   */
+  struct __cpa_keyed_index
+    {
+    std::uint64_t key;
+    std::size_t index;
+    };
+
+  /*
+   * Map a double to an unsigned integer with the same order. Positive values get their sign bit set, and negative values get
+   * all of their bits inverted.
+   */
+  inline std::uint64_t __cpa_order_key(double const value) noexcept
+    {
+    auto bits = std::uint64_t{};
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits >> 63 ? ~bits : bits | (std::uint64_t{1} << 63);
+    }
+
+  /*
+   * Sort entries by key using a stable least significant digit radix sort on bytes. The histograms of all digits are
+   * collected in a single pass, and passes over digits that are the same for all keys are skipped.
+   */
+  inline void __cpa_radix_sort(std::vector<__cpa_keyed_index> & entries)
+    {
+    constexpr auto digits = sizeof(std::uint64_t);
+
+    std::size_t histograms[digits][256] = {};
+
+    for(auto const & entry : entries)
+      {
+      for(std::size_t digit{}; digit < digits; ++digit)
+        {
+        ++histograms[digit][(entry.key >> (8 * digit)) & 0xff];
+        }
+      }
+
+    auto buffer = std::vector<__cpa_keyed_index>(entries.size());
+
+    for(std::size_t digit{}; digit < digits; ++digit)
+      {
+      auto & histogram = histograms[digit];
+
+      if(histogram[(entries.front().key >> (8 * digit)) & 0xff] == entries.size())
+        {
+        continue;
+        }
+
+      std::size_t offset{};
+
+      for(auto & count : histogram)
+        {
+        auto const next = offset + count;
+        count = offset;
+        offset = next;
+        }
+
+      for(auto const & entry : entries)
+        {
+        buffer[histogram[(entry.key >> (8 * digit)) & 0xff]++] = entry;
+        }
+
+      entries.swap(buffer);
+      }
+    }
+  }
+
+#endif
@@ -0,0 +1,280 @@
+#ifndef __CPA_IMPL__THREAD_POOL
+#define __CPA_IMPL__THREAD_POOL
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace cpa
+  {
+
+  /*
+   * The process wide pool of worker threads used by the parallel algorithms. Threads are created on demand, when a caller
+   * requests more helpers than are running, and are then kept waiting for jobs until the end of the program, so that the
+   * parallel algorithms only pay for queueing their jobs instead of creating and joining threads on every call.
+   */
+  struct __cpa_thread_pool
+    {
+    static __cpa_thread_pool & instance()
+      {
+      static __cpa_thread_pool pool{};
+      return pool;
+      }
+
+    __cpa_thread_pool() = default;
+    __cpa_thread_pool(__cpa_thread_pool const &) = delete;
+    __cpa_thread_pool & operator = (__cpa_thread_pool const &) = delete;
+
+    ~__cpa_thread_pool()
+      {
+        {
+        std::lock_guard<std::mutex> const lock{m_mutex};
+        m_stopping = true;
+        }
+
+      m_available.notify_all();
+
+      for(auto & thread : m_threads)
+        {
+        thread.join();
+        }
+      }
+
+    /*
+     * Grow the pool to at least count threads, and return the number of threads running. If the system refuses to create a
+     * thread, the pool stays at its current size.
+     */
+    std::size_t reserve(std::size_t const count)
+      {
+      std::lock_guard<std::mutex> const lock{m_mutex};
+
+      while(m_threads.size() < count)
+        {
+        try
+          {
+          m_threads.emplace_back([this] { run(); });
+          }
+        catch(std::system_error const &)
+          {
+          break;
+          }
+        }
+
+      return m_threads.size();
+      }
+
+    void submit(std::function<void()> job)
+      {
+        {
+        std::lock_guard<std::mutex> const lock{m_mutex};
+        m_jobs.push_back(std::move(job));
+        }
+
+      m_available.notify_one();
+      }
+
+    private:
+      void run()
+        {
+        for(;;)
+          {
+          std::function<void()> job{};
+
+            {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_available.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+
+            if(m_jobs.empty())
+              {
+              return;
+              }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            }
+
+          job();
+          }
+        }
+
+      std::mutex m_mutex{};
+      std::condition_variable m_available{};
+      std::deque<std::function<void()>> m_jobs{};
+      std::vector<std::thread> m_threads{};
+      bool m_stopping{};
+    };
+
+  /*
+   * The helpers of one call of __cpa_run_work_stealing. Once the caller has run out of work, it closes the batch, so that
+   * helpers which have not started yet return immediately, and waits only for the active ones. Helpers therefore never have
+   * to be scheduled for a call to finish, which keeps nested and concurrent calls from waiting on each other.
+   */
+  struct __cpa_work_batch
+    {
+    std::mutex mutex{};
+    std::condition_variable idle{};
+    std::size_t active{};
+    bool closed{};
+    };
+
+  struct __cpa_task_queue
+    {
+    std::mutex mutex;
+    std::deque<std::size_t> tasks;
+    };
+
+  /*
+   * Run task(index) for every index in [0, count) on up to workers threads, the calling one and helpers from the thread pool.
+   * Every worker starts with a contiguous block of indices, which it processes from the back. Once its own queue is empty, it
+   * steals indices from the front of the queues of the other workers. If a helper does not start, for example because the
+   * pool threads are busy or could not be created, the other workers take over its share. The first exception thrown by a
+   * task is rethrown once all workers have finished.
+   */
+  template<typename Task>
+  void __cpa_run_work_stealing(std::size_t const count, std::size_t workers, Task const & task)
+    {
+    workers = workers < 1 ? 1 : (workers > count ? count : workers);
+
+    auto queues = std::vector<__cpa_task_queue>(workers);
+
+    for(std::size_t worker{}; worker < workers; ++worker)
+      {
+      for(auto index = worker * count / workers; index < (worker + 1) * count / workers; ++index)
+        {
+        queues[worker].tasks.push_back(index);
+        }
+      }
+
+    auto error = std::exception_ptr{};
+    std::mutex error_mutex{};
+    std::atomic<bool> failed{false};
+
+    auto const work = [&](std::size_t const self)
+      {
+      for(;;)
+        {
+        std::size_t index{};
+        auto found = false;
+
+          {
+          std::lock_guard<std::mutex> const lock{queues[self].mutex};
+
+          if(!queues[self].tasks.empty())
+            {
+            index = queues[self].tasks.back();
+            queues[self].tasks.pop_back();
+            found = true;
+            }
+          }
+
+        for(std::size_t offset{1}; !found && offset < workers; ++offset)
+          {
+          auto & victim = queues[(self + offset) % workers];
+          std::lock_guard<std::mutex> const lock{victim.mutex};
+
+          if(!victim.tasks.empty())
+            {
+            index = victim.tasks.front();
+            victim.tasks.pop_front();
+            found = true;
+            }
+          }
+
+        if(!found)
+          {
+          return;
+          }
+
+        if(failed.load(std::memory_order_relaxed))
+          {
+          continue;
+          }
+
+        try
+          {
+          task(index);
+          }
+        catch(...)
+          {
+          std::lock_guard<std::mutex> const lock{error_mutex};
+
+          if(!error)
+            {
+            error = std::current_exception();
+            }
+
+          failed.store(true, std::memory_order_relaxed);
+          }
+        }
+      };
+
+    if(workers > 1)
+      {
+      auto & pool = __cpa_thread_pool::instance();
+      auto const batch = std::make_shared<__cpa_work_batch>();
+      auto const available = pool.reserve(workers - 1);
+      auto const helpers = available < workers - 1 ? available : workers - 1;
+
+      auto const help = [batch, &work](std::size_t const worker)
+        {
+          {
+          std::lock_guard<std::mutex> const lock{batch->mutex};
+
+          if(batch->closed)
+            {
+            return;
+            }
+
+          ++batch->active;
+          }
+
+        work(worker);
+
+          {
+          std::lock_guard<std::mutex> const lock{batch->mutex};
+          --batch->active;
+          }
+
+        batch->idle.notify_all();
+        };
+
+      for(std::size_t worker{1}; worker <= helpers; ++worker)
+        {
+        try
+          {
+          pool.submit([help, worker] { help(worker); });
+          }
+        catch(std::bad_alloc const &)
+          {
+          break;
+          }
+        }
+
+      work(0);
+
+      std::unique_lock<std::mutex> lock{batch->mutex};
+      batch->closed = true;
+      batch->idle.wait(lock, [&] { return !batch->active; });
+      }
+    else
+      {
+      work(0);
+      }
+
+    if(error)
+      {
+      std::rethrow_exception(error);
+      }
+    }
+  }
+
+#endif
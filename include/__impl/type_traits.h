@@ -2,39 +2,94 @@
 #define __CPA_IMPL__TYPE_TRAITS
 
 #include <type_traits>
+#include <utility>
 
 namespace cpa
   {
+#if defined(__SIZEOF_INT128__)
+  __extension__ typedef __int128 __cpa_int128;
+  __extension__ typedef unsigned __int128 __cpa_uint128;
+#endif
+
   template<typename ...>
   struct voidify;
 
   template<typename ...Types>
   using voidify_t = typename voidify<Types...>::type;
 
+  /*
+   * The arithmetic types that are not subject to integral promotion are known to be negatable and less-than comparable. The
+   * traits below answer for them directly, so that the expression detectors are only instantiated for other types.
+   */
+  template<typename Type>
+  struct __cpa_is_unpromoted_arithmetic : std::false_type {};
+
+  template<> struct __cpa_is_unpromoted_arithmetic<int> : std::true_type {};
+  template<> struct __cpa_is_unpromoted_arithmetic<long> : std::true_type {};
+  template<> struct __cpa_is_unpromoted_arithmetic<long long> : std::true_type {};
+  template<> struct __cpa_is_unpromoted_arithmetic<unsigned int> : std::true_type {};
+  template<> struct __cpa_is_unpromoted_arithmetic<unsigned long> : std::true_type {};
+  template<> struct __cpa_is_unpromoted_arithmetic<unsigned long long> : std::true_type {};
+  template<> struct __cpa_is_unpromoted_arithmetic<float> : std::true_type {};
+  template<> struct __cpa_is_unpromoted_arithmetic<double> : std::true_type {};
+  template<> struct __cpa_is_unpromoted_arithmetic<long double> : std::true_type {};
+
+#if defined(__SIZEOF_INT128__)
+  template<> struct __cpa_is_unpromoted_arithmetic<__cpa_int128> : std::true_type {};
+  template<> struct __cpa_is_unpromoted_arithmetic<__cpa_uint128> : std::true_type {};
+#endif
+
   template<typename Type>
   using __cpa_negation_t = decltype(-std::declval<Type &>());
 
   template<typename Type, typename = void>
-  struct __cpa_is_negatable : std::false_type {};
+  struct __cpa_detect_negatable : std::false_type {};
 
   template<typename Type>
-  struct __cpa_is_negatable<Type, voidify_t<__cpa_negation_t<Type>>>
+  struct __cpa_detect_negatable<Type, voidify_t<__cpa_negation_t<Type>>>
   : std::is_same<Type, std::remove_reference_t<__cpa_negation_t<Type>>>::type {};
 
   template<typename Type>
-  struct __cpa_is_negatable<Type const, voidify_t<__cpa_negation_t<Type const>>>
+  struct __cpa_detect_negatable<Type const, voidify_t<__cpa_negation_t<Type const>>>
   : std::is_same<Type, __cpa_negation_t<Type const>>::type {};
 
+  template<typename Type>
+  struct __cpa_is_negatable
+  : std::conditional_t<__cpa_is_unpromoted_arithmetic<Type>::value, std::true_type, __cpa_detect_negatable<Type>> {};
+
   template<typename Left, typename Right>
   using __cpa_lessthan_comparison_t = decltype(std::declval<Left>() < std::declval<Right>());
 
   template<typename Left, typename Right, typename = void>
-  struct __cpa_is_lessthan_comparable : std::false_type {};
+  struct __cpa_detect_lessthan_comparable : std::false_type {};
 
   template<typename Left, typename Right>
-  struct __cpa_is_lessthan_comparable<Left, Right, voidify_t<__cpa_lessthan_comparison_t<Left, Right>>>
+  struct __cpa_detect_lessthan_comparable<Left, Right, voidify_t<__cpa_lessthan_comparison_t<Left, Right>>>
   : std::is_same<bool, std::decay_t<__cpa_lessthan_comparison_t<Left, Right>>>::type {};
+
+  template<typename Left, typename Right>
+  struct __cpa_is_lessthan_comparable
+  : std::conditional_t<std::is_same<Left, Right>::value && __cpa_is_unpromoted_arithmetic<Left>::value, std::true_type,
+                       __cpa_detect_lessthan_comparable<Left, Right>> {};
+
+  /*
+   * The type of the elements of an iterator. Unlike std::iterator_traits, this does not require the comparatively expensive
+   * standard header iterator.
+   */
+  template<typename Iterator>
+  using __cpa_iterator_value_t = std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<Iterator &>())>>;
+
+  /*
+   * Detect whether Type can be used as an input iterator, that is whether it can be dereferenced, incremented and compared. This
+   * distinguishes ranges from values in overloads taking two arguments of the same type.
+   */
+  template<typename Type, typename = void>
+  struct __cpa_is_iterator : std::false_type {};
+
+  template<typename Type>
+  struct __cpa_is_iterator<Type, voidify_t<decltype(*std::declval<Type &>()), decltype(++std::declval<Type &>()),
+                                           decltype(std::declval<Type const &>() != std::declval<Type const &>())>>
+  : std::true_type {};
   }
 
 #endif
-
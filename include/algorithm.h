@@ -0,0 +1,337 @@
+#ifndef __CPA__ALGORITHM
+#define __CPA__ALGORITHM
+
+#include <conversion.h>
+#include <rational.h>
+#include <__impl/batch_gcd.h>
+#include <__impl/checked.h>
+#include <__impl/radix_sort.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \file algorithm.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief Algorithms operating on whole ranges of cpa::basic_rational objects.
+ */
+
+namespace cpa
+  {
+
+  template<typename ForwardIt>
+  void __cpa_reduce(ForwardIt first, ForwardIt const last, std::true_type)
+    {
+    using rational_t = typename std::iterator_traits<ForwardIt>::value_type;
+    using rep_t = typename rational_t::rep;
+    using lane_t = __cpa_gcd_lane_t<rep_t>;
+
+    ForwardIt elements[__cpa_gcd_batch_size];
+    lane_t numerators[__cpa_gcd_batch_size];
+    lane_t denominators[__cpa_gcd_batch_size];
+
+    while(first != last)
+      {
+      std::size_t count{};
+
+      for(; count < __cpa_gcd_batch_size && first != last; ++first)
+        {
+        if(!first->known_canonical())
+          {
+          elements[count] = first;
+          numerators[count] = __cpa_magnitude(first->numerator());
+          denominators[count] = __cpa_magnitude(first->denominator());
+          ++count;
+          }
+        }
+
+      __cpa_gcd_lanes(numerators, denominators, count);
+
+      for(std::size_t index{}; index < count; ++index)
+        {
+        auto const & element = *elements[index];
+        auto const gcd = static_cast<rep_t>(numerators[index]);
+        *elements[index] = rational_t{__cpa_unchecked{}, static_cast<rep_t>(element.numerator() / gcd),
+                                      static_cast<rep_t>(element.denominator() / gcd), true};
+        __CPA_INSTRUMENT(reduce, 0, __cpa_magnitude_bits(*elements[index]));
+        }
+      }
+    }
+
+  template<typename ForwardIt>
+  void __cpa_reduce(ForwardIt first, ForwardIt const last, std::false_type)
+    {
+    for(; first != last; ++first)
+      {
+      first->reduce();
+      }
+    }
+
+  /**
+   * Reduce every cpa::basic_rational object in the range [\p first, \p last)
+   *
+   * The effect is the same as calling cpa::basic_rational::reduce() on each element. Elements that are known to be in canonical
+   * form are skipped.
+   *
+   * \note
+   * If the representation type is an integral type of at most 64 bits, the GCDs are calculated in batches, using the same
+   * vectorized implementation as cpa::gcd(InputIt1, InputIt1, InputIt2, OutputIt).
+   */
+  template<typename ForwardIt>
+  void reduce(ForwardIt first, ForwardIt last)
+    {
+    using rep_t = typename std::iterator_traits<ForwardIt>::value_type::rep;
+    __cpa_reduce(first, last, __cpa_is_batch_gcd_capable<rep_t>{});
+    }
+
+  template<typename Rep>
+  struct __cpa_sum_bucket
+    {
+    Rep denominator;
+    Rep numerator;
+    };
+
+  constexpr std::size_t __cpa_sum_linear_buckets = 16;
+
+  /*
+   * Find the bucket for denominator, creating it if necessary. As long as there are only a few buckets, they are searched
+   * linearly. Once there are more, an index mapping denominators to buckets is used.
+   */
+  template<typename Rep>
+  std::size_t __cpa_find_bucket(std::vector<__cpa_sum_bucket<Rep>> & buckets, std::map<Rep, std::size_t> & index,
+                                Rep const & denominator)
+    {
+    if(buckets.size() <= __cpa_sum_linear_buckets)
+      {
+      for(std::size_t position{}; position < buckets.size(); ++position)
+        {
+        if(buckets[position].denominator == denominator)
+          {
+          return position;
+          }
+        }
+
+      buckets.push_back({denominator, Rep{0}});
+
+      if(buckets.size() > __cpa_sum_linear_buckets)
+        {
+        for(std::size_t position{}; position < buckets.size(); ++position)
+          {
+          index.emplace(buckets[position].denominator, position);
+          }
+        }
+
+      return buckets.size() - 1;
+      }
+
+    auto const inserted = index.emplace(denominator, buckets.size());
+
+    if(inserted.second)
+      {
+      buckets.push_back({denominator, Rep{0}});
+      }
+
+    return inserted.first->second;
+    }
+
+  /*
+   * Add value to sum, returning true and leaving sum untouched if the result is not representable.
+   */
+  template<typename Rep>
+  bool __cpa_accumulate(Rep & sum, Rep const & value, std::true_type) noexcept
+    {
+    Rep result{};
+
+    if(__cpa_add_overflow(sum, value, result))
+      {
+      return true;
+      }
+
+    sum = result;
+    return false;
+    }
+
+  template<typename Rep>
+  bool __cpa_accumulate(Rep & sum, Rep const & value, std::false_type)
+    {
+    sum += value;
+    return false;
+    }
+
+  /*
+   * The implementation of cpa::sum(InputIt, InputIt), which combines the sums of the groups using merge(lhs, rhs).
+   */
+  template<typename InputIt, typename Merge>
+  typename std::iterator_traits<InputIt>::value_type __cpa_sum(InputIt first, InputIt last, Merge const & merge)
+    {
+    using rational_t = typename std::iterator_traits<InputIt>::value_type;
+    using rep_t = typename rational_t::rep;
+
+    auto buckets = std::vector<__cpa_sum_bucket<rep_t>>{};
+    auto index = std::map<rep_t, std::size_t>{};
+    auto partials = std::vector<rational_t>{};
+    std::size_t current{};
+
+    for(; first != last; ++first)
+      {
+      auto numerator = first->numerator();
+      auto denominator = first->denominator();
+      __cpa_positive_denominator(numerator, denominator);
+
+      if(buckets.empty() || !(buckets[current].denominator == denominator))
+        {
+        current = __cpa_find_bucket(buckets, index, denominator);
+        }
+
+      auto & bucket = buckets[current];
+
+      if(__cpa_accumulate(bucket.numerator, numerator, __cpa_is_binary_gcd_capable<rep_t>{}))
+        {
+        partials.push_back(rational_t{__cpa_unchecked{}, bucket.numerator, bucket.denominator});
+        bucket.numerator = numerator;
+        }
+      }
+
+    for(auto const & bucket : buckets)
+      {
+      if(bucket.numerator)
+        {
+        partials.push_back(rational_t{__cpa_unchecked{}, bucket.numerator, bucket.denominator});
+        }
+      }
+
+    if(partials.empty())
+      {
+      return rational_t{};
+      }
+
+    for(auto count = partials.size(); count > 1; count = (count + 1) / 2)
+      {
+      for(std::size_t position{}; position < count / 2; ++position)
+        {
+        partials[position] = merge(partials[2 * position], partials[2 * position + 1]);
+        }
+
+      if(count % 2)
+        {
+        partials[count / 2] = partials[count - 1];
+        }
+      }
+
+    return partials.front().reduce();
+    }
+
+  /**
+   * Calculate the exact sum of the cpa::basic_rational objects in the range [\p first, \p last)
+   *
+   * The terms are grouped by their denominator, and the numerators within each group are added without calculating any GCD.
+   * The sums of the groups are then combined pairwise in a balanced tree, using
+   * cpa::operator+(basic_rational<LeftRep, Policy> const &, basic_rational<RightRep, Policy> const &). Each step of the tree
+   * thereby cancels the factors its numerator shares with the GCD of the denominators, which keeps the intermediate values
+   * small. Since the sums of the groups are not reduced, the result of the tree is reduced at the end.
+   *
+   * \note
+   * If the representation type is integral and the sum of the numerators of a group overflows, the sum accumulated so far is
+   * set aside as a separate term of the tree and the group starts over. If the representation type can not represent an
+   * intermediate value of the tree, the behavior is undefined.
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff a term can not be represented with a positive denominator,
+   * like 1 / INT64_MIN.
+   *
+   * \return
+   * The reduced sum, or 0 if the range is empty.
+   */
+  template<typename InputIt>
+  typename std::iterator_traits<InputIt>::value_type sum(InputIt first, InputIt last)
+    {
+    using rational_t = typename std::iterator_traits<InputIt>::value_type;
+
+    return __cpa_sum(first, last, [](rational_t const & lhs, rational_t const & rhs) { return lhs + rhs; });
+    }
+
+  /*
+   * Ranges with fewer elements than this are sorted by comparison only.
+   */
+  constexpr std::size_t __cpa_radix_sort_threshold = 256;
+
+  template<typename RandomIt>
+  void __cpa_sort(RandomIt const first, RandomIt const last, std::true_type)
+    {
+    using rational_t = typename std::iterator_traits<RandomIt>::value_type;
+
+    auto const size = static_cast<std::size_t>(last - first);
+
+    if(size < __cpa_radix_sort_threshold)
+      {
+      std::sort(first, last);
+      return;
+      }
+
+    auto entries = std::vector<__cpa_keyed_index>(size);
+
+    for(std::size_t index{}; index < size; ++index)
+      {
+      entries[index] = __cpa_keyed_index{__cpa_order_key(cpa::to_double(first[static_cast<std::ptrdiff_t>(index)])), index};
+      }
+
+    __cpa_radix_sort(entries);
+
+    auto sorted = std::vector<rational_t>{};
+    sorted.reserve(size);
+
+    for(auto const & entry : entries)
+      {
+      sorted.push_back(std::move(first[static_cast<std::ptrdiff_t>(entry.index)]));
+      }
+
+    std::move(sorted.begin(), sorted.end(), first);
+
+    for(std::size_t begin{}, end{}; begin < size; begin = end)
+      {
+      for(end = begin + 1; end < size && entries[end].key == entries[begin].key; ++end)
+        {
+        }
+
+      if(end - begin > 1)
+        {
+        std::sort(first + static_cast<std::ptrdiff_t>(begin), first + static_cast<std::ptrdiff_t>(end));
+        }
+      }
+    }
+
+  template<typename RandomIt>
+  void __cpa_sort(RandomIt const first, RandomIt const last, std::false_type)
+    {
+    std::sort(first, last);
+    }
+
+  /**
+   * Sort the cpa::basic_rational objects in the range [\p first, \p last) in ascending order of their values
+   *
+   * If the representation type is integral, the correctly rounded double of every element is calculated once, using
+   * cpa::to_double. Since correct rounding preserves the order, the elements are sorted by a radix sort on these keys, and
+   * only runs of elements with equal keys are sorted using the exact comparison. Small ranges and other representation types
+   * are sorted using the exact comparison only.
+   *
+   * \note
+   * Like std::sort, this function is not stable. Elements with equal values, but different representations, may appear in
+   * any order.
+   */
+  template<typename RandomIt>
+  void sort(RandomIt first, RandomIt last)
+    {
+    using rep_t = typename std::iterator_traits<RandomIt>::value_type::rep;
+    __cpa_sort(first, last, __cpa_is_binary_gcd_capable<rep_t>{});
+    }
+
+  }
+
+#endif
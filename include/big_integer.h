@@ -0,0 +1,499 @@
+#ifndef __CPA__BIG_INTEGER
+#define __CPA__BIG_INTEGER
+
+#include <numeric.h>
+#include <type_traits.h>
+#include <__impl/big_integer.h>
+#include <__impl/checked.h>
+#include <__impl/numeric.h>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+/**
+ * \file big_integer.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief An arbitrary precision integer type, suitable as the representation type of cpa::basic_rational.
+ */
+
+namespace cpa
+  {
+
+  struct lehmer_gcd;
+
+  /**
+   * A signed integer of arbitrary precision
+   *
+   * Values with a magnitude of at most 64 bits are stored inline, without any dynamic allocation, and the arithmetic operations
+   * on them only fall back to multi-precision arithmetic if the result does not fit. Larger values are stored as a sequence of
+   * 32-bit digits. Multiplication of large values uses Karatsuba's algorithm and division uses Knuth's Algorithm D.
+   *
+   * \note
+   * Division and remainder truncate towards zero, like they do for the builtin integral types.
+   */
+  struct big_integer
+    {
+    /**
+     * Construct a cpa::big_integer representing 0
+     */
+    big_integer() noexcept = default;
+
+    /**
+     * Construct a cpa::big_integer from a value of an integral type
+     *
+     * \note
+     * This constructor does not throw if \p Integral is at most 64 bits wide
+     */
+    template<typename Integral, typename = std::enable_if_t<__cpa_is_binary_gcd_capable<Integral>::value>>
+    big_integer(Integral const value) noexcept(sizeof(Integral) <= sizeof(std::uint64_t))
+      {
+      assign(__cpa_magnitude(value), __cpa_is_negative(value));
+      }
+
+    /**
+     * Convert a cpa::big_integer to a bool
+     *
+     * \return
+     * true if the cpa::big_integer object does not represent 0, false otherwise
+     */
+    explicit operator bool() const noexcept
+      {
+      return !is_small() || m_small;
+      }
+
+    /**
+     * Convert a cpa::big_integer to a long double
+     *
+     * \note
+     * This conversion will loose precision if the magnitude exceeds the number of digits of long double.
+     */
+    explicit operator long double() const noexcept
+      {
+      auto result = static_cast<long double>(m_small);
+
+      if(!is_small())
+        {
+        result = 0;
+
+        for(auto limb = m_limbs.rbegin(); limb != m_limbs.rend(); ++limb)
+          {
+          result = result * 4294967296.0L + *limb;
+          }
+        }
+
+      return m_negative ? -result : result;
+      }
+
+    /**
+     * Create an object of type cpa::big_integer representing the negation of the current object
+     */
+    big_integer operator - () const
+      {
+      auto result = *this;
+      result.m_negative = !m_negative && static_cast<bool>(*this);
+      return result;
+      }
+
+    big_integer & operator += (big_integer const & other)
+      {
+      return *this = *this + other;
+      }
+
+    big_integer & operator -= (big_integer const & other)
+      {
+      return *this = *this - other;
+      }
+
+    big_integer & operator *= (big_integer const & other)
+      {
+      return *this = *this * other;
+      }
+
+    /**
+     * \note
+     * This function will throw an instance of std::domain_error iff other is equal to 0.
+     */
+    big_integer & operator /= (big_integer const & other)
+      {
+      return *this = *this / other;
+      }
+
+    /**
+     * \note
+     * This function will throw an instance of std::domain_error iff other is equal to 0.
+     */
+    big_integer & operator %= (big_integer const & other)
+      {
+      return *this = *this % other;
+      }
+
+    friend big_integer operator + (big_integer const & lhs, big_integer const & rhs)
+      {
+      return add(lhs, rhs, rhs.m_negative);
+      }
+
+    friend big_integer operator - (big_integer const & lhs, big_integer const & rhs)
+      {
+      return add(lhs, rhs, !rhs.m_negative && static_cast<bool>(rhs));
+      }
+
+    friend big_integer operator * (big_integer const & lhs, big_integer const & rhs)
+      {
+      auto const negative = lhs.m_negative != rhs.m_negative;
+
+      if(lhs.is_small() && rhs.is_small())
+        {
+        std::uint64_t product{};
+
+        if(!__cpa_multiply_overflow(lhs.m_small, rhs.m_small, product))
+          {
+          return big_integer{product, negative};
+          }
+        }
+
+      return big_integer{__cpa_limbs_multiply(lhs.magnitude(), rhs.magnitude()), negative};
+      }
+
+    /**
+     * \note
+     * This function will throw an instance of std::domain_error iff rhs is equal to 0.
+     */
+    friend big_integer operator / (big_integer const & lhs, big_integer const & rhs)
+      {
+      return divide(lhs, rhs).first;
+      }
+
+    /**
+     * \note
+     * This function will throw an instance of std::domain_error iff rhs is equal to 0.
+     */
+    friend big_integer operator % (big_integer const & lhs, big_integer const & rhs)
+      {
+      return divide(lhs, rhs).second;
+      }
+
+    friend bool operator == (big_integer const & lhs, big_integer const & rhs) noexcept
+      {
+      return lhs.m_negative == rhs.m_negative && lhs.m_small == rhs.m_small && lhs.m_limbs == rhs.m_limbs;
+      }
+
+    friend bool operator != (big_integer const & lhs, big_integer const & rhs) noexcept
+      {
+      return !(lhs == rhs);
+      }
+
+    friend bool operator < (big_integer const & lhs, big_integer const & rhs) noexcept
+      {
+      if(lhs.m_negative != rhs.m_negative)
+        {
+        return lhs.m_negative;
+        }
+
+      auto const order = compare_magnitudes(lhs, rhs);
+      return lhs.m_negative ? order > 0 : order < 0;
+      }
+
+    friend bool operator > (big_integer const & lhs, big_integer const & rhs) noexcept
+      {
+      return rhs < lhs;
+      }
+
+    friend bool operator <= (big_integer const & lhs, big_integer const & rhs) noexcept
+      {
+      return !(rhs < lhs);
+      }
+
+    friend bool operator >= (big_integer const & lhs, big_integer const & rhs) noexcept
+      {
+      return !(lhs < rhs);
+      }
+
+    /**
+     * Get the decimal representation of \p value
+     */
+    friend std::string to_string(big_integer const & value)
+      {
+      auto digits = std::string{};
+
+      if(value.is_small())
+        {
+        digits = std::to_string(value.m_small);
+        }
+      else
+        {
+        auto limbs = value.m_limbs;
+
+        while(!limbs.empty())
+          {
+          auto chunk = __cpa_limbs_divide_digit(limbs, 1000000000u);
+
+          for(auto count = 0; count < 9 && (chunk || !limbs.empty()); ++count, chunk /= 10)
+            {
+            digits.insert(digits.begin(), static_cast<char>('0' + chunk % 10));
+            }
+          }
+        }
+
+      return value.m_negative ? '-' + digits : digits;
+      }
+
+    private:
+      friend lehmer_gcd;
+
+      big_integer(std::uint64_t const magnitude, bool const negative) noexcept
+        : m_small{magnitude},
+          m_negative{negative && magnitude}
+        {
+        }
+
+      big_integer(__cpa_limbs && magnitude, bool const negative)
+        {
+        __cpa_limbs_trim(magnitude);
+
+        if(magnitude.size() > 2)
+          {
+          m_limbs = std::move(magnitude);
+          m_negative = negative;
+          }
+        else
+          {
+          m_small = __cpa_limbs_extract(magnitude, 0);
+          m_negative = negative && m_small;
+          }
+        }
+
+      void assign(std::uint64_t const magnitude, bool const negative) noexcept
+        {
+        m_small = magnitude;
+        m_negative = negative;
+        }
+
+#if defined(__SIZEOF_INT128__)
+      void assign(__cpa_uint128 const magnitude, bool const negative)
+        {
+        *this = big_integer{__cpa_limbs{static_cast<std::uint32_t>(magnitude), static_cast<std::uint32_t>(magnitude >> 32),
+                                        static_cast<std::uint32_t>(magnitude >> 64), static_cast<std::uint32_t>(magnitude >> 96)},
+                            negative};
+        }
+#endif
+
+      template<typename Unsigned>
+      void assign(Unsigned const magnitude, bool const negative) noexcept
+        {
+        assign(static_cast<std::uint64_t>(magnitude), negative);
+        }
+
+      bool is_small() const noexcept
+        {
+        return m_limbs.empty();
+        }
+
+      __cpa_limbs magnitude() const
+        {
+        return is_small() ? __cpa_limbs_from(m_small) : m_limbs;
+        }
+
+      static int compare_magnitudes(big_integer const & lhs, big_integer const & rhs) noexcept
+        {
+        if(lhs.is_small() && rhs.is_small())
+          {
+          return lhs.m_small < rhs.m_small ? -1 : lhs.m_small > rhs.m_small;
+          }
+
+        if(lhs.is_small() || rhs.is_small())
+          {
+          return lhs.is_small() ? -1 : 1;
+          }
+
+        return __cpa_limbs_compare(lhs.m_limbs, rhs.m_limbs);
+        }
+
+      /*
+       * Add lhs and the magnitude of rhs, with the sign given by rhs_negative.
+       */
+      static big_integer add(big_integer const & lhs, big_integer const & rhs, bool const rhs_negative)
+        {
+        if(lhs.m_negative == rhs_negative)
+          {
+          if(lhs.is_small() && rhs.is_small())
+            {
+            std::uint64_t sum{};
+
+            if(!__cpa_add_overflow(lhs.m_small, rhs.m_small, sum))
+              {
+              return big_integer{sum, rhs_negative};
+              }
+            }
+
+          return big_integer{__cpa_limbs_add(lhs.magnitude(), rhs.magnitude()), rhs_negative};
+          }
+
+        auto const order = compare_magnitudes(lhs, rhs);
+        auto const & larger = order < 0 ? rhs : lhs;
+        auto const & smaller = order < 0 ? lhs : rhs;
+        auto const negative = order < 0 ? rhs_negative : lhs.m_negative;
+
+        if(larger.is_small())
+          {
+          return big_integer{larger.m_small - smaller.m_small, negative};
+          }
+
+        return big_integer{__cpa_limbs_subtract(larger.m_limbs, smaller.magnitude()), negative};
+        }
+
+      static std::pair<big_integer, big_integer> divide(big_integer const & lhs, big_integer const & rhs)
+        {
+        if(!rhs)
+          {
+          throw std::domain_error{"division by 0 would result in an undefined value"};
+          }
+
+        auto const negative = lhs.m_negative != rhs.m_negative;
+
+        if(lhs.is_small() && rhs.is_small())
+          {
+          return {big_integer{lhs.m_small / rhs.m_small, negative}, big_integer{lhs.m_small % rhs.m_small, lhs.m_negative}};
+          }
+
+        if(compare_magnitudes(lhs, rhs) < 0)
+          {
+          return {big_integer{}, lhs};
+          }
+
+        auto quotient = __cpa_limbs{};
+        auto remainder = __cpa_limbs{};
+        __cpa_limbs_divide(lhs.magnitude(), rhs.magnitude(), quotient, remainder);
+
+        return {big_integer{std::move(quotient), negative}, big_integer{std::move(remainder), lhs.m_negative}};
+        }
+
+      __cpa_limbs m_limbs{};
+      std::uint64_t m_small{};
+      bool m_negative{};
+    };
+
+  /**
+   * Function object calculating the GCD of two cpa::big_integer objects using Lehmer's algorithm
+   *
+   * \note
+   * As long as the operands are large, the steps of the Euclidean algorithm are simulated on their leading 32 bits and only
+   * applied to the full values once the simulation becomes inexact (Knuth, TAOCP Vol. 2, 4.5.2, Algorithm L). Once both
+   * operands fit into 64 bits, the calculation continues with the binary GCD on machine integers.
+   */
+  struct lehmer_gcd
+    {
+    big_integer operator()(big_integer const & lhs, big_integer const & rhs) const
+      {
+      auto left = big_integer{lhs.m_negative ? -lhs : lhs};
+      auto right = big_integer{rhs.m_negative ? -rhs : rhs};
+
+      if(left < right)
+        {
+        std::swap(left, right);
+        }
+
+      while(!right.is_small())
+        {
+        auto const shift = __cpa_limbs_bit_length(left.m_limbs) - 32;
+        auto left_digit = static_cast<std::int64_t>(__cpa_limbs_extract(left.m_limbs, shift));
+        auto right_digit = static_cast<std::int64_t>(__cpa_limbs_extract(right.m_limbs, shift));
+        std::int64_t a{1}, b{0}, c{0}, d{1};
+
+        while(right_digit + c > 0 && right_digit + d > 0)
+          {
+          auto const quotient = (left_digit + a) / (right_digit + c);
+
+          if(quotient != (left_digit + b) / (right_digit + d))
+            {
+            break;
+            }
+
+          auto next = a - quotient * c;
+          a = c;
+          c = next;
+          next = b - quotient * d;
+          b = d;
+          d = next;
+          next = left_digit - quotient * right_digit;
+          left_digit = right_digit;
+          right_digit = next;
+          }
+
+        if(!b)
+          {
+          auto remainder = left % right;
+          left = std::move(right);
+          right = std::move(remainder);
+          }
+        else
+          {
+          auto next = left * a + right * b;
+          right = left * c + right * d;
+          left = std::move(next);
+          }
+        }
+
+      if(!right)
+        {
+        return left;
+        }
+
+      left %= right;
+      return big_integer{__cpa_binary_gcd(left.m_small, right.m_small), false};
+      }
+    };
+
+  /**
+   * cpa::gcd uses cpa::lehmer_gcd for cpa::big_integer
+   */
+  template<>
+  struct gcd_algorithm<big_integer>
+    {
+    using type = lehmer_gcd;
+    };
+
+  template<>
+  constexpr bool is_signed_v<big_integer> = true;
+
+  }
+
+namespace std
+  {
+
+  /**
+   * Specialization of std::numeric_limits for cpa::big_integer
+   *
+   * \note
+   * cpa::big_integer is unbounded, which disables the threshold of cpa::lazy_normalization.
+   */
+  template<>
+  struct numeric_limits<cpa::big_integer>
+    {
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = true;
+    static constexpr bool is_exact = true;
+    static constexpr bool has_infinity = false;
+    static constexpr bool has_quiet_NaN = false;
+    static constexpr bool has_signaling_NaN = false;
+    static constexpr bool is_bounded = false;
+    static constexpr bool is_modulo = false;
+    static constexpr int digits = 0;
+    static constexpr int digits10 = 0;
+    static constexpr int radix = 2;
+
+    static cpa::big_integer min() noexcept { return {}; }
+    static cpa::big_integer max() noexcept { return {}; }
+    static cpa::big_integer lowest() noexcept { return {}; }
+    };
+
+  }
+
+#endif
+
@@ -0,0 +1,204 @@
+#ifndef __CPA__CHARCONV
+#define __CPA__CHARCONV
+
+#include <rational.h>
+#include <__impl/charconv.h>
+#include <__impl/numeric.h>
+
+#include <system_error>
+#include <type_traits>
+
+/**
+ * \file charconv.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief Conversions between cpa::basic_rational objects and their textual representation.
+ *
+ * The functions in this file follow the design of std::to_chars and std::from_chars: they operate on caller supplied buffers,
+ * never allocate, do not depend on the current locale and report errors through a std::errc value instead of exceptions. The
+ * textual representation of a rational number is either a plain integer like "-7", or a fraction like "-7/12", where only the
+ * numerator carries a sign.
+ */
+
+namespace cpa
+  {
+
+  /**
+   * The result of cpa::to_chars
+   */
+  struct to_chars_result
+    {
+    char * ptr;
+    std::errc ec;
+    };
+
+  /**
+   * The result of cpa::from_chars
+   */
+  struct from_chars_result
+    {
+    char const * ptr;
+    std::errc ec;
+    };
+
+  /*
+   * Get the parts of value to be written by cpa::to_chars. Objects using cpa::lazy_normalization are reduced, since the policy
+   * canonicalizes values that are printed. The signs are left as stored, since cpa::to_chars only writes magnitudes.
+   */
+  template<typename Rep, typename Policy>
+  constexpr void __cpa_printed_parts(basic_rational<Rep, Policy> const & value, Rep & numerator, Rep & denominator,
+                                     std::true_type) noexcept
+    {
+    numerator = value.numerator();
+    denominator = value.denominator();
+
+    if(!value.known_canonical())
+      {
+      auto const gcd = cpa::gcd(numerator, denominator);
+      numerator = static_cast<Rep>(numerator / gcd);
+      denominator = static_cast<Rep>(denominator / gcd);
+      }
+    }
+
+  template<typename Rep, typename Policy>
+  constexpr void __cpa_printed_parts(basic_rational<Rep, Policy> const & value, Rep & numerator, Rep & denominator,
+                                     std::false_type) noexcept
+    {
+    numerator = value.numerator();
+    denominator = value.denominator();
+    }
+
+  /**
+   * Write the textual representation of a cpa::basic_rational into the range [\p first, \p last)
+   *
+   * The numerator is written, followed by a '/' and the denominator, unless the magnitude of the denominator is 1. If the
+   * denominator is negative, the signs of both parts are swapped, so that the denominator is always written without a sign.
+   * The value is written as stored, and not reduced, unless \p Policy is cpa::lazy_normalization, which canonicalizes printed
+   * values.
+   *
+   * \note
+   * If the range is too small, the returned error is std::errc::value_too_large, the returned pointer is \p last and the
+   * contents of the range are unspecified. No terminating null character is written.
+   *
+   * \return
+   * A cpa::to_chars_result holding a pointer past the last character written on success.
+   */
+  template<typename Rep, typename Policy>
+  to_chars_result to_chars(char * first, char * const last, basic_rational<Rep, Policy> const & value) noexcept
+    {
+    static_assert(__cpa_is_binary_gcd_capable<Rep>::value, "to_chars requires an integral representation type");
+
+    using unsigned_t = __cpa_text_magnitude_t<Rep>;
+
+    Rep numerator{};
+    Rep denominator{};
+    __cpa_printed_parts(value, numerator, denominator, std::is_same<Policy, lazy_normalization>{});
+
+    auto const denominator_magnitude = static_cast<unsigned_t>(__cpa_magnitude(denominator));
+
+    if(numerator && __cpa_is_negative(numerator) != __cpa_is_negative(denominator))
+      {
+      if(first == last)
+        {
+        return {last, std::errc::value_too_large};
+        }
+
+      *first++ = '-';
+      }
+
+    first = __cpa_write_digits(first, last, static_cast<unsigned_t>(__cpa_magnitude(numerator)));
+
+    if(first && denominator_magnitude != 1)
+      {
+      if(first == last)
+        {
+        return {last, std::errc::value_too_large};
+        }
+
+      *first = '/';
+      first = __cpa_write_digits(first + 1, last, denominator_magnitude);
+      }
+
+    if(!first)
+      {
+      return {last, std::errc::value_too_large};
+      }
+
+    return {first, std::errc{}};
+    }
+
+  /**
+   * Parse a cpa::basic_rational from the range [\p first, \p last)
+   *
+   * The accepted syntax is an optional '-', followed by one or more decimal digits, optionally followed by a '/' and one or
+   * more decimal digits. Leading whitespace and a leading '+' are not accepted. If a '/' is not followed by a digit, only
+   * the integer in front of it is parsed. Unless \p reduce is false, the parsed value is reduced.
+   *
+   * \note
+   * If the range does not start with a valid representation, or if the denominator is 0, the returned error is
+   * std::errc::invalid_argument and the returned pointer is \p first. If either part is not representable by Rep, the
+   * returned error is std::errc::result_out_of_range and the returned pointer points past the digits of that part. In both
+   * cases, \p value is not modified.
+   *
+   * \return
+   * A cpa::from_chars_result holding a pointer to the first character not parsed on success.
+   */
+  template<typename Rep, typename Policy>
+  from_chars_result from_chars(char const * const first, char const * const last, basic_rational<Rep, Policy> & value,
+                               bool const reduce = true) noexcept
+    {
+    static_assert(__cpa_is_binary_gcd_capable<Rep>::value, "from_chars requires an integral representation type");
+
+    using unsigned_t = __cpa_text_magnitude_t<Rep>;
+
+    constexpr auto maximum = static_cast<unsigned_t>(static_cast<__cpa_make_unsigned_t<Rep>>(~__cpa_make_unsigned_t<Rep>{}) >>
+                                                     __cpa_is_signed_integral<Rep>::value);
+
+    auto const negative = first != last && *first == '-';
+
+    if(negative && !__cpa_is_signed_integral<Rep>::value)
+      {
+      return {first, std::errc::invalid_argument};
+      }
+
+    auto error = std::errc{};
+    auto numerator = unsigned_t{};
+    auto denominator = unsigned_t{1};
+    auto position = __cpa_parse_digits(first + negative, last, static_cast<unsigned_t>(maximum + negative), numerator, error);
+
+    if(error != std::errc{})
+      {
+      return {error == std::errc::invalid_argument ? first : position, error};
+      }
+
+    if(last - position > 1 && *position == '/' && static_cast<unsigned char>(position[1] - '0') < 10)
+      {
+      position = __cpa_parse_digits(position + 1, last, maximum, denominator, error);
+
+      if(error != std::errc{})
+        {
+        return {position, error};
+        }
+
+      if(!denominator)
+        {
+        return {first, std::errc::invalid_argument};
+        }
+      }
+
+    if(reduce && denominator != 1)
+      {
+      auto const gcd = __cpa_binary_gcd(numerator, denominator);
+      numerator /= gcd;
+      denominator /= gcd;
+      }
+
+    auto const signed_numerator = static_cast<Rep>(negative ? unsigned_t{0} - numerator : numerator);
+    value = basic_rational<Rep, Policy>{__cpa_unchecked{}, signed_numerator, static_cast<Rep>(denominator), reduce};
+    return {position, std::errc{}};
+    }
+
+  }
+
+#endif
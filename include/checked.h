@@ -0,0 +1,411 @@
+#ifndef __CPA__CHECKED
+#define __CPA__CHECKED
+
+#include <rational.h>
+#include <__impl/checked.h>
+
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+/**
+ * \file checked.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief Arithmetic on cpa::basic_rational objects with overflow detection.
+ *
+ * The operators found in rational.h exhibit undefined behavior if an intermediate value can not be represented. The functions
+ * in this file detect overflows instead. Each operation first runs on the representation type, checking every step for
+ * overflow. If an overflow occurs, the operation is repeated on an integral type of twice the width (if there is one) and the
+ * result is reduced. Only if the reduced result still can not be represented, an error is reported.
+ *
+ * Every function comes in two flavors: one reporting errors through a std::error_code and one throwing an instance of
+ * std::domain_error.
+ */
+
+namespace cpa
+  {
+
+  template<int Sign>
+  struct __cpa_checked_sum
+    {
+    template<typename Integral>
+    constexpr bool operator()(Integral const lhs_numerator, Integral const lhs_denominator,
+                              Integral const rhs_numerator, Integral const rhs_denominator,
+                              Integral & numerator, Integral & denominator) const noexcept
+      {
+      auto const gcd = static_cast<Integral>(__cpa_binary_gcd(__cpa_magnitude(lhs_denominator), __cpa_magnitude(rhs_denominator)));
+      auto const lhs_factor = static_cast<Integral>(lhs_denominator / gcd);
+      auto const rhs_factor = static_cast<Integral>(rhs_denominator / gcd);
+
+      Integral lhs_product{};
+      Integral rhs_product{};
+      Integral sum{};
+
+      if(__cpa_multiply_overflow(lhs_numerator, rhs_factor, lhs_product) ||
+         __cpa_multiply_overflow(rhs_numerator, lhs_factor, rhs_product) ||
+         (Sign > 0 ? __cpa_add_overflow(lhs_product, rhs_product, sum) : __cpa_subtract_overflow(lhs_product, rhs_product, sum)))
+        {
+        return false;
+        }
+
+      auto const common = static_cast<Integral>(__cpa_binary_gcd(__cpa_magnitude(sum), __cpa_magnitude(gcd)));
+      numerator = static_cast<Integral>(sum / common);
+
+      return !__cpa_multiply_overflow(lhs_factor, static_cast<Integral>(rhs_denominator / common), denominator);
+      }
+    };
+
+  struct __cpa_checked_product
+    {
+    template<typename Integral>
+    constexpr bool operator()(Integral const lhs_numerator, Integral const lhs_denominator,
+                              Integral const rhs_numerator, Integral const rhs_denominator,
+                              Integral & numerator, Integral & denominator) const noexcept
+      {
+      auto const lhs_gcd = static_cast<Integral>(__cpa_binary_gcd(__cpa_magnitude(lhs_numerator), __cpa_magnitude(rhs_denominator)));
+      auto const rhs_gcd = static_cast<Integral>(__cpa_binary_gcd(__cpa_magnitude(rhs_numerator), __cpa_magnitude(lhs_denominator)));
+
+      return !__cpa_multiply_overflow(static_cast<Integral>(lhs_numerator / lhs_gcd),
+                                      static_cast<Integral>(rhs_numerator / rhs_gcd),
+                                      numerator) &&
+             !__cpa_multiply_overflow(static_cast<Integral>(lhs_denominator / rhs_gcd),
+                                      static_cast<Integral>(rhs_denominator / lhs_gcd),
+                                      denominator);
+      }
+    };
+
+  template<typename Rep, typename Operation>
+  bool __cpa_checked_widened(Rep const, Rep const, Rep const, Rep const, Rep &, Rep &, Operation, std::true_type) noexcept
+    {
+    return false;
+    }
+
+  template<typename Rep, typename Operation>
+  bool __cpa_checked_widened(Rep const lhs_numerator, Rep const lhs_denominator,
+                             Rep const rhs_numerator, Rep const rhs_denominator,
+                             Rep & numerator, Rep & denominator,
+                             Operation operation, std::false_type) noexcept
+    {
+    using wide_t = __cpa_widened_t<Rep>;
+
+    wide_t wide_numerator{};
+    wide_t wide_denominator{};
+
+    if(!operation(wide_t{lhs_numerator}, wide_t{lhs_denominator}, wide_t{rhs_numerator}, wide_t{rhs_denominator},
+                  wide_numerator, wide_denominator))
+      {
+      return false;
+      }
+
+    auto const gcd = static_cast<wide_t>(__cpa_binary_gcd(__cpa_magnitude(wide_numerator), __cpa_magnitude(wide_denominator)));
+    wide_numerator /= gcd;
+    wide_denominator /= gcd;
+
+    if(!__cpa_fits<Rep>(wide_numerator) || !__cpa_fits<Rep>(wide_denominator))
+      {
+      return false;
+      }
+
+    numerator = static_cast<Rep>(wide_numerator);
+    denominator = static_cast<Rep>(wide_denominator);
+    return true;
+    }
+
+  template<typename Rep, typename Policy, typename Operation>
+  basic_rational<Rep, Policy> __cpa_checked(Rep const lhs_numerator, Rep const lhs_denominator,
+                                            Rep const rhs_numerator, Rep const rhs_denominator,
+                                            bool const reduced, Operation operation, std::error_code & error) noexcept
+    {
+    static_assert(__cpa_is_binary_gcd_capable<Rep>::value, "Checked arithmetic requires an integral representation type");
+
+    Rep numerator{};
+    Rep denominator{};
+
+    if(operation(lhs_numerator, lhs_denominator, rhs_numerator, rhs_denominator, numerator, denominator))
+      {
+      error.clear();
+      return basic_rational<Rep, Policy>{__cpa_unchecked{}, numerator, denominator, reduced};
+      }
+
+    if(__cpa_checked_widened(lhs_numerator, lhs_denominator, rhs_numerator, rhs_denominator, numerator, denominator, operation,
+                             std::is_void<__cpa_widened_t<Rep>>{}))
+      {
+      error.clear();
+      return basic_rational<Rep, Policy>{__cpa_unchecked{}, numerator, denominator, true};
+      }
+
+    error = std::make_error_code(std::errc::value_too_large);
+    return basic_rational<Rep, Policy>{};
+    }
+
+  template<typename Rep, typename Policy>
+  basic_rational<Rep, Policy> __cpa_throw_on_error(basic_rational<Rep, Policy> const & result, std::error_code const & error)
+    {
+    if(error == std::errc::invalid_argument)
+      {
+      throw std::domain_error{"division by 0 would result in an undefined value"};
+      }
+
+    if(error)
+      {
+      throw std::domain_error{"result is not representable by the representation type"};
+      }
+
+    return result;
+    }
+
+  /**
+   * Add two cpa::basic_rational objects, detecting overflows
+   *
+   * \note
+   * If the result can not be represented, \p error is set to std::errc::value_too_large and a cpa::basic_rational representing
+   * 0 is returned. Otherwise \p error is cleared. The result is reduced if both operands are reduced, or if a wider type had to
+   * be used.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> checked_add(basic_rational<LeftRep, Policy> const & lhs,
+                                                                            basic_rational<RightRep, Policy> const & rhs,
+                                                                            std::error_code & error) noexcept
+    {
+    using common_t = std::common_type_t<LeftRep, RightRep>;
+    return __cpa_checked<common_t, Policy>(lhs.numerator(), lhs.denominator(), rhs.numerator(), rhs.denominator(),
+                                           lhs.known_canonical() && rhs.known_canonical(), __cpa_checked_sum<1>{}, error);
+    }
+
+  /**
+   * Add two cpa::basic_rational objects, detecting overflows
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff the result can not be represented.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> checked_add(basic_rational<LeftRep, Policy> const & lhs,
+                                                                            basic_rational<RightRep, Policy> const & rhs)
+    {
+    auto error = std::error_code{};
+    auto const result = checked_add(lhs, rhs, error);
+    return __cpa_throw_on_error(result, error);
+    }
+
+  /**
+   * Subtract two cpa::basic_rational objects, detecting overflows
+   *
+   * \note
+   * Errors are reported like in cpa::checked_add(basic_rational<LeftRep, Policy> const &,
+   * basic_rational<RightRep, Policy> const &, std::error_code &).
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> checked_subtract(basic_rational<LeftRep, Policy> const & lhs,
+                                                                                 basic_rational<RightRep, Policy> const & rhs,
+                                                                                 std::error_code & error) noexcept
+    {
+    using common_t = std::common_type_t<LeftRep, RightRep>;
+    return __cpa_checked<common_t, Policy>(lhs.numerator(), lhs.denominator(), rhs.numerator(), rhs.denominator(),
+                                           lhs.known_canonical() && rhs.known_canonical(), __cpa_checked_sum<-1>{}, error);
+    }
+
+  /**
+   * Subtract two cpa::basic_rational objects, detecting overflows
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff the result can not be represented.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> checked_subtract(basic_rational<LeftRep, Policy> const & lhs,
+                                                                                 basic_rational<RightRep, Policy> const & rhs)
+    {
+    auto error = std::error_code{};
+    auto const result = checked_subtract(lhs, rhs, error);
+    return __cpa_throw_on_error(result, error);
+    }
+
+  /**
+   * Multiply two cpa::basic_rational objects, detecting overflows
+   *
+   * \note
+   * Errors are reported like in cpa::checked_add(basic_rational<LeftRep, Policy> const &,
+   * basic_rational<RightRep, Policy> const &, std::error_code &).
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> checked_multiply(basic_rational<LeftRep, Policy> const & lhs,
+                                                                                 basic_rational<RightRep, Policy> const & rhs,
+                                                                                 std::error_code & error) noexcept
+    {
+    using common_t = std::common_type_t<LeftRep, RightRep>;
+    return __cpa_checked<common_t, Policy>(lhs.numerator(), lhs.denominator(), rhs.numerator(), rhs.denominator(),
+                                           lhs.known_canonical() && rhs.known_canonical(), __cpa_checked_product{}, error);
+    }
+
+  /**
+   * Multiply two cpa::basic_rational objects, detecting overflows
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff the result can not be represented.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> checked_multiply(basic_rational<LeftRep, Policy> const & lhs,
+                                                                                 basic_rational<RightRep, Policy> const & rhs)
+    {
+    auto error = std::error_code{};
+    auto const result = checked_multiply(lhs, rhs, error);
+    return __cpa_throw_on_error(result, error);
+    }
+
+  /**
+   * Divide two cpa::basic_rational objects, detecting overflows
+   *
+   * \note
+   * Errors are reported like in cpa::checked_add(basic_rational<LeftRep, Policy> const &,
+   * basic_rational<RightRep, Policy> const &, std::error_code &). Additionally, \p error is set to std::errc::invalid_argument
+   * iff \p rhs is equal to 0.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> checked_divide(basic_rational<LeftRep, Policy> const & lhs,
+                                                                               basic_rational<RightRep, Policy> const & rhs,
+                                                                               std::error_code & error) noexcept
+    {
+    using common_t = std::common_type_t<LeftRep, RightRep>;
+
+    if(!rhs)
+      {
+      error = std::make_error_code(std::errc::invalid_argument);
+      return basic_rational<common_t, Policy>{};
+      }
+
+    return __cpa_checked<common_t, Policy>(lhs.numerator(), lhs.denominator(), rhs.denominator(), rhs.numerator(),
+                                           lhs.known_canonical() && rhs.known_canonical(), __cpa_checked_product{}, error);
+    }
+
+  /**
+   * Divide two cpa::basic_rational objects, detecting overflows
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff \p rhs is equal to 0 or the result can not be represented.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> checked_divide(basic_rational<LeftRep, Policy> const & lhs,
+                                                                               basic_rational<RightRep, Policy> const & rhs)
+    {
+    auto error = std::error_code{};
+    auto const result = checked_divide(lhs, rhs, error);
+    return __cpa_throw_on_error(result, error);
+    }
+
+  /**
+   * Create an object of type cpa::basic_rational representing an expansion of \p value with \p factor, detecting overflows
+   *
+   * \note
+   * Since the result of an expansion must not be reduced, no wider type is tried. If the expansion can not be represented,
+   * \p error is set to std::errc::value_too_large. If \p factor is equal to 0, \p error is set to std::errc::invalid_argument.
+   * In both cases, a cpa::basic_rational representing 0 is returned.
+   */
+  template<typename Rep, typename Policy>
+  basic_rational<Rep, Policy> checked_expand(basic_rational<Rep, Policy> const & value, Rep const factor,
+                                             std::error_code & error) noexcept
+    {
+    static_assert(__cpa_is_binary_gcd_capable<Rep>::value, "Checked arithmetic requires an integral representation type");
+
+    Rep numerator{};
+    Rep denominator{};
+
+    if(!factor)
+      {
+      error = std::make_error_code(std::errc::invalid_argument);
+      return basic_rational<Rep, Policy>{};
+      }
+
+    if(__cpa_multiply_overflow(value.numerator(), factor, numerator) ||
+       __cpa_multiply_overflow(value.denominator(), factor, denominator))
+      {
+      error = std::make_error_code(std::errc::value_too_large);
+      return basic_rational<Rep, Policy>{};
+      }
+
+    error.clear();
+    return basic_rational<Rep, Policy>{__cpa_unchecked{}, numerator, denominator, factor == Rep{1} && value.known_canonical()};
+    }
+
+  /**
+   * Create an object of type cpa::basic_rational representing an expansion of \p value with \p factor, detecting overflows
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff \p factor is equal to 0 or the expansion can not be
+   * represented.
+   */
+  template<typename Rep, typename Policy>
+  basic_rational<Rep, Policy> checked_expand(basic_rational<Rep, Policy> const & value, Rep const factor)
+    {
+    auto error = std::error_code{};
+    auto const result = checked_expand(value, factor, error);
+
+    if(error == std::errc::invalid_argument)
+      {
+      throw std::domain_error{"expansion by 0 would result in an undefined value"};
+      }
+
+    return __cpa_throw_on_error(result, error);
+    }
+
+  /**
+   * Create an object of type cpa::basic_rational representing an expansion of \p value to the denominator common to
+   * \p value and \p other, detecting overflows
+   *
+   * \note
+   * Like for cpa::basic_rational::common(basic_rational const &) const, the common denominator is the positive LCM of the
+   * denominators. If the expansion can not be represented, \p error is set to std::errc::value_too_large and a
+   * cpa::basic_rational representing 0 is returned.
+   */
+  template<typename Rep, typename Policy>
+  basic_rational<Rep, Policy> checked_common(basic_rational<Rep, Policy> const & value, basic_rational<Rep, Policy> const & other,
+                                             std::error_code & error) noexcept
+    {
+    static_assert(__cpa_is_binary_gcd_capable<Rep>::value, "Checked arithmetic requires an integral representation type");
+
+    using unsigned_t = __cpa_make_unsigned_t<Rep>;
+
+    auto const gcd = __cpa_binary_gcd(__cpa_magnitude(value.denominator()), __cpa_magnitude(other.denominator()));
+    auto const magnitude = static_cast<unsigned_t>(__cpa_magnitude(other.denominator()) / gcd);
+
+    Rep numerator{};
+    Rep denominator{};
+
+    if(magnitude > static_cast<unsigned_t>(__cpa_max_value<Rep>()))
+      {
+      error = std::make_error_code(std::errc::value_too_large);
+      return basic_rational<Rep, Policy>{};
+      }
+
+    auto const factor = __cpa_apply_sign<Rep>(magnitude, __cpa_is_negative(value.denominator()));
+
+    if(__cpa_multiply_overflow(value.numerator(), factor, numerator) ||
+       __cpa_multiply_overflow(value.denominator(), factor, denominator))
+      {
+      error = std::make_error_code(std::errc::value_too_large);
+      return basic_rational<Rep, Policy>{};
+      }
+
+    error.clear();
+    return basic_rational<Rep, Policy>{__cpa_unchecked{}, numerator, denominator, factor == Rep{1} && value.known_canonical()};
+    }
+
+  /**
+   * Create an object of type cpa::basic_rational representing an expansion of \p value to the denominator common to
+   * \p value and \p other, detecting overflows
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff the expansion can not be represented.
+   */
+  template<typename Rep, typename Policy>
+  basic_rational<Rep, Policy> checked_common(basic_rational<Rep, Policy> const & value, basic_rational<Rep, Policy> const & other)
+    {
+    auto error = std::error_code{};
+    auto const result = checked_common(value, other, error);
+    return __cpa_throw_on_error(result, error);
+    }
+
+  }
+
+#endif
+
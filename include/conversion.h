@@ -0,0 +1,113 @@
+#ifndef __CPA__CONVERSION
+#define __CPA__CONVERSION
+
+#include <rational.h>
+#include <__impl/conversion.h>
+#include <__impl/numeric.h>
+
+#include <type_traits>
+
+/**
+ * \file conversion.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief Exact conversions between cpa::basic_rational objects and binary floating point values.
+ *
+ * The conversion operator of cpa::basic_rational divides the numerator by the denominator in long double, which rounds twice
+ * once the parts are not exactly representable. The functions in this file round the exact quotient only once, to the nearest
+ * representable value, with ties rounded to even. Conversions from floating point values are exact, since every finite
+ * binary floating point value is a fraction with a power of two as its denominator.
+ */
+
+namespace cpa
+  {
+
+  /**
+   * Convert a cpa::basic_rational to the nearest double
+   *
+   * If both the numerator and the denominator are exactly representable as double, the result is the quotient of the
+   * converted values. Otherwise, the quotient is calculated as an integer with enough additional bits to round it correctly.
+   *
+   * \note
+   * The result is correctly rounded, with ties rounded to even, as long as the evaluation of double arithmetic does not use
+   * excess precision (i.e. FLT_EVAL_METHOD is 0).
+   *
+   * \return
+   * The double nearest to the value of \p value.
+   */
+  template<typename Rep, typename Policy>
+  double to_double(basic_rational<Rep, Policy> const & value)
+    {
+    static_assert(__cpa_is_binary_gcd_capable<Rep>::value, "to_double requires an integral representation type");
+    return __cpa_to_float<double>(value.numerator(), value.denominator());
+    }
+
+  /**
+   * Convert a cpa::basic_rational to the nearest float
+   *
+   * \note
+   * The result is correctly rounded like by cpa::to_double(basic_rational<Rep, Policy> const &). It is not the result of
+   * converting the nearest double to float, which could be rounded twice.
+   *
+   * \return
+   * The float nearest to the value of \p value.
+   */
+  template<typename Rep, typename Policy>
+  float to_float(basic_rational<Rep, Policy> const & value)
+    {
+    static_assert(__cpa_is_binary_gcd_capable<Rep>::value, "to_float requires an integral representation type");
+    return __cpa_to_float<float>(value.numerator(), value.denominator());
+    }
+
+  /**
+   * Construct the cpa::basic_rational exactly equal to a double
+   *
+   * The value is decomposed into its sign, mantissa and exponent. Since the denominator of the result is a power of two, the
+   * result is reduced without calculating any GCD.
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff \p value is infinite or NaN, or if the numerator or the
+   * denominator of the result can not be represented by the representation type of \p Rational.
+   *
+   * \return
+   * A reduced cpa::basic_rational equal to \p value.
+   */
+  template<typename Rational = rational>
+  Rational from_double(double const value)
+    {
+    using rep_t = typename Rational::rep;
+
+    static_assert(__cpa_is_binary_gcd_capable<rep_t>::value, "from_double requires an integral representation type");
+
+    auto numerator = rep_t{};
+    auto denominator = rep_t{};
+    __cpa_from_float(value, numerator, denominator);
+    return Rational{__cpa_unchecked{}, numerator, denominator, true};
+    }
+
+  /**
+   * Construct the cpa::basic_rational exactly equal to a float
+   *
+   * \note
+   * This function will throw an instance of std::domain_error under the same conditions as cpa::from_double(double).
+   *
+   * \return
+   * A reduced cpa::basic_rational equal to \p value.
+   */
+  template<typename Rational = rational>
+  Rational from_float(float const value)
+    {
+    using rep_t = typename Rational::rep;
+
+    static_assert(__cpa_is_binary_gcd_capable<rep_t>::value, "from_float requires an integral representation type");
+
+    auto numerator = rep_t{};
+    auto denominator = rep_t{};
+    __cpa_from_float(value, numerator, denominator);
+    return Rational{__cpa_unchecked{}, numerator, denominator, true};
+    }
+
+  }
+
+#endif
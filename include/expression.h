@@ -0,0 +1,277 @@
+#ifndef __CPA__EXPRESSION
+#define __CPA__EXPRESSION
+
+#include <rational.h>
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * \file expression.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief Expression templates fusing chains of arithmetic on cpa::basic_rational objects.
+ *
+ * Wrapping an operand with cpa::fuse turns the surrounding arithmetic expression into a cpa::rational_expression. Instead of
+ * computing a reduced temporary for every operator, the whole expression is evaluated on unreduced numerators and
+ * denominators, and only the final result is reduced. Terms of a sum sharing the same denominator are added without
+ * multiplying the denominators, and other terms are brought to the LCM of their denominators.
+ *
+ * \note
+ * Since intermediate values are not reduced, they grow faster than with the operators found in rational.h. If the
+ * representation type can not represent an intermediate value, the behavior is undefined.
+ */
+
+namespace cpa
+  {
+
+  /*
+   * An unreduced fraction, produced while evaluating an expression.
+   */
+  template<typename Rep>
+  struct __cpa_fraction
+    {
+    Rep numerator;
+    Rep denominator;
+    };
+
+  template<typename Rep, typename Policy>
+  struct __cpa_leaf_node
+    {
+    using rep = Rep;
+    using policy = Policy;
+
+    constexpr __cpa_fraction<rep> evaluate() const
+      {
+      return {value.numerator(), value.denominator()};
+      }
+
+    basic_rational<Rep, Policy> value;
+    };
+
+  template<typename Node>
+  struct __cpa_negation_node
+    {
+    using rep = typename Node::rep;
+    using policy = typename Node::policy;
+
+    constexpr __cpa_fraction<rep> evaluate() const
+      {
+      auto const operand = node.evaluate();
+      return {static_cast<rep>(-operand.numerator), operand.denominator};
+      }
+
+    Node node;
+    };
+
+  template<int Sign, typename Left, typename Right>
+  struct __cpa_sum_node
+    {
+    static_assert(is_same_v<typename Left::policy, typename Right::policy>,
+                  "Operands of a fused expression must have the same normalization policy");
+
+    using rep = std::common_type_t<typename Left::rep, typename Right::rep>;
+    using policy = typename Left::policy;
+
+    constexpr __cpa_fraction<rep> evaluate() const
+      {
+      auto const left = lhs.evaluate();
+      auto const right = rhs.evaluate();
+
+      if(left.denominator == right.denominator)
+        {
+        rep const numerator = Sign > 0 ? left.numerator + right.numerator : left.numerator - right.numerator;
+        return {numerator, static_cast<rep>(left.denominator)};
+        }
+
+      rep const gcd = cpa::gcd(left.denominator, right.denominator);
+      rep const left_factor = right.denominator / gcd;
+      rep const right_factor = left.denominator / gcd;
+
+      rep const numerator = Sign > 0 ? left.numerator * left_factor + right.numerator * right_factor
+                                     : left.numerator * left_factor - right.numerator * right_factor;
+      rep const denominator = left.denominator * left_factor;
+      return {numerator, denominator};
+      }
+
+    Left lhs;
+    Right rhs;
+    };
+
+  template<bool Inverse, typename Left, typename Right>
+  struct __cpa_product_node
+    {
+    static_assert(is_same_v<typename Left::policy, typename Right::policy>,
+                  "Operands of a fused expression must have the same normalization policy");
+
+    using rep = std::common_type_t<typename Left::rep, typename Right::rep>;
+    using policy = typename Left::policy;
+
+    constexpr __cpa_fraction<rep> evaluate() const
+      {
+      auto const left = lhs.evaluate();
+      auto const right = rhs.evaluate();
+
+      if(Inverse && !right.numerator)
+        {
+        throw std::domain_error{"division by 0 would result in an undefined value"};
+        }
+
+      rep const numerator = left.numerator * (Inverse ? right.denominator : right.numerator);
+      rep const denominator = left.denominator * (Inverse ? right.numerator : right.denominator);
+      return {numerator, denominator};
+      }
+
+    Left lhs;
+    Right rhs;
+    };
+
+  /**
+   * An arithmetic expression on cpa::basic_rational objects, evaluated as a whole
+   *
+   * Objects of this type are created by cpa::fuse and by applying the operators \p +, \p -, \p * and \p / to a
+   * cpa::rational_expression and either another cpa::rational_expression or a cpa::basic_rational.
+   */
+  template<typename Node>
+  struct rational_expression
+    {
+    using rep = typename Node::rep;
+    using policy = typename Node::policy;
+
+    constexpr explicit rational_expression(Node const & node) noexcept(std::is_nothrow_copy_constructible<Node>::value)
+      : m_node{node}
+      {
+      }
+
+    /**
+     * Evaluate the expression
+     *
+     * \note
+     * The result is reduced exactly once. With cpa::manual_normalization, the sign of the denominator is retained, like it is
+     * by cpa::basic_rational::reduce().
+     *
+     * \note
+     * This function will throw an instance of std::domain_error iff a divisor in the expression is equal to 0.
+     */
+    constexpr basic_rational<rep, policy> evaluate() const
+      {
+      auto const result = m_node.evaluate();
+      auto const value = basic_rational<rep, policy>{__cpa_unchecked{}, result.numerator, result.denominator};
+      return value.reduce();
+      }
+
+    /**
+     * Convert the expression to a cpa::basic_rational by evaluating it
+     */
+    constexpr operator basic_rational<rep, policy>() const
+      {
+      return evaluate();
+      }
+
+    constexpr Node const & node() const noexcept
+      {
+      return m_node;
+      }
+
+    constexpr rational_expression<__cpa_negation_node<Node>> operator - () const
+      {
+      return rational_expression<__cpa_negation_node<Node>>{{m_node}};
+      }
+
+    private:
+      Node m_node;
+    };
+
+  /**
+   * Start a fused expression with \p value as its first operand
+   */
+  template<typename Rep, typename Policy>
+  constexpr rational_expression<__cpa_leaf_node<Rep, Policy>> fuse(basic_rational<Rep, Policy> const & value)
+    noexcept(std::is_nothrow_copy_constructible<Rep>::value)
+    {
+    return rational_expression<__cpa_leaf_node<Rep, Policy>>{{value}};
+    }
+
+  template<typename Type>
+  struct __cpa_is_expression : std::false_type { };
+
+  template<typename Node>
+  struct __cpa_is_expression<rational_expression<Node>> : std::true_type { };
+
+  template<typename Node>
+  constexpr Node __cpa_node(rational_expression<Node> const & expression)
+    {
+    return expression.node();
+    }
+
+  template<typename Rep, typename Policy>
+  constexpr __cpa_leaf_node<Rep, Policy> __cpa_node(basic_rational<Rep, Policy> const & value)
+    {
+    return {value};
+    }
+
+  /*
+   * The expression resulting from combining Left and Right with Operation, if at least one of them is a
+   * cpa::rational_expression and the other one is a cpa::rational_expression or a cpa::basic_rational.
+   */
+  template<typename Left, typename Right, template<typename, typename> class Operation>
+  using __cpa_fused_t = std::enable_if_t<__cpa_is_expression<Left>::value || __cpa_is_expression<Right>::value,
+                                         rational_expression<Operation<decltype(__cpa_node(std::declval<Left const &>())),
+                                                                       decltype(__cpa_node(std::declval<Right const &>()))>>>;
+
+  template<typename Left, typename Right>
+  using __cpa_addition_node = __cpa_sum_node<1, Left, Right>;
+
+  template<typename Left, typename Right>
+  using __cpa_subtraction_node = __cpa_sum_node<-1, Left, Right>;
+
+  template<typename Left, typename Right>
+  using __cpa_multiplication_node = __cpa_product_node<false, Left, Right>;
+
+  template<typename Left, typename Right>
+  using __cpa_division_node = __cpa_product_node<true, Left, Right>;
+
+  /**
+   * Extend a fused expression by an addition
+   */
+  template<typename Left, typename Right>
+  constexpr __cpa_fused_t<Left, Right, __cpa_addition_node> operator + (Left const & lhs, Right const & rhs)
+    {
+    return __cpa_fused_t<Left, Right, __cpa_addition_node>{{__cpa_node(lhs), __cpa_node(rhs)}};
+    }
+
+  /**
+   * Extend a fused expression by a subtraction
+   */
+  template<typename Left, typename Right>
+  constexpr __cpa_fused_t<Left, Right, __cpa_subtraction_node> operator - (Left const & lhs, Right const & rhs)
+    {
+    return __cpa_fused_t<Left, Right, __cpa_subtraction_node>{{__cpa_node(lhs), __cpa_node(rhs)}};
+    }
+
+  /**
+   * Extend a fused expression by a multiplication
+   */
+  template<typename Left, typename Right>
+  constexpr __cpa_fused_t<Left, Right, __cpa_multiplication_node> operator * (Left const & lhs, Right const & rhs)
+    {
+    return __cpa_fused_t<Left, Right, __cpa_multiplication_node>{{__cpa_node(lhs), __cpa_node(rhs)}};
+    }
+
+  /**
+   * Extend a fused expression by a division
+   *
+   * \note
+   * A division by 0 is detected when the expression is evaluated.
+   */
+  template<typename Left, typename Right>
+  constexpr __cpa_fused_t<Left, Right, __cpa_division_node> operator / (Left const & lhs, Right const & rhs)
+    {
+    return __cpa_fused_t<Left, Right, __cpa_division_node>{{__cpa_node(lhs), __cpa_node(rhs)}};
+    }
+
+  }
+
+#endif
@@ -0,0 +1,519 @@
+#ifndef __CPA__FIXED_RATIONAL
+#define __CPA__FIXED_RATIONAL
+
+#include <rational.h>
+#include <__impl/checked.h>
+#include <__impl/numeric.h>
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * \file fixed_rational.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief Rational numbers with a denominator fixed at compile time.
+ *
+ * A cpa::fixed_rational stores only its numerator, while its denominator is part of its type. This makes it a fixed-point
+ * number, like an amount of money in cents with the denominator 100. Addition, subtraction and comparison are plain integer
+ * operations, and no GCD is ever calculated. Multiplication and division need to divide by the constant denominator, which
+ * compilers implement without a division, and which is a shift if the denominator is a power of two.
+ */
+
+namespace cpa
+  {
+
+  /*
+   * The integral type used for products of two values of type Rep, which is twice as wide as Rep if there is such a type.
+   */
+  template<typename Rep>
+  using __cpa_fixed_wide_t = std::conditional_t<std::is_void<__cpa_widened_t<Rep>>::value, Rep, __cpa_widened_t<Rep>>;
+
+  /*
+   * Divide magnitude by divisor, rounding to the nearest integer and ties away from 0.
+   */
+  template<typename Unsigned>
+  constexpr Unsigned __cpa_round_divide(Unsigned const magnitude, Unsigned const divisor) noexcept
+    {
+    auto const quotient = static_cast<Unsigned>(magnitude / divisor);
+    auto const remainder = static_cast<Unsigned>(magnitude - quotient * divisor);
+    return remainder >= divisor - remainder ? static_cast<Unsigned>(quotient + 1) : quotient;
+    }
+
+  /*
+   * Divide magnitude by the constant Divisor, rounding like cpa::__cpa_round_divide. For powers of two, the quotient and the
+   * remainder are taken by a shift and a mask. Compilers replace the other constant divisions by multiplications.
+   */
+  template<std::uintmax_t Divisor, typename Unsigned>
+  constexpr Unsigned __cpa_round_divide_constant(Unsigned const magnitude) noexcept
+    {
+    constexpr auto divisor = static_cast<Unsigned>(Divisor);
+    constexpr auto shift = __cpa_ctz(Divisor);
+
+    auto const quotient = static_cast<Unsigned>(!(Divisor & (Divisor - 1)) ? magnitude >> shift : magnitude / divisor);
+    auto const remainder = static_cast<Unsigned>(!(Divisor & (Divisor - 1)) ? magnitude & (divisor - 1) : magnitude % divisor);
+    return remainder >= divisor - remainder ? static_cast<Unsigned>(quotient + 1) : quotient;
+    }
+
+  /*
+   * Calculate the numerator of lhs * rhs / Denominator. As long as the product of the magnitudes fits Rep, the division by
+   * the constant happens in Rep. Otherwise, the product is formed in the wider type.
+   */
+  template<typename Rep, Rep Denominator>
+  constexpr Rep __cpa_fixed_multiply(Rep const lhs, Rep const rhs) noexcept
+    {
+    using unsigned_t = __cpa_make_unsigned_t<Rep>;
+    using wide_t = __cpa_make_unsigned_t<__cpa_fixed_wide_t<Rep>>;
+
+    auto const lhs_magnitude = __cpa_magnitude(lhs);
+    auto const rhs_magnitude = __cpa_magnitude(rhs);
+    unsigned_t product{};
+
+    auto const magnitude = __cpa_multiply_overflow(lhs_magnitude, rhs_magnitude, product)
+      ? static_cast<unsigned_t>(__cpa_round_divide_constant<Denominator>(static_cast<wide_t>(lhs_magnitude) * rhs_magnitude))
+      : __cpa_round_divide_constant<Denominator>(product);
+
+    return __cpa_apply_sign<Rep>(magnitude, __cpa_is_negative(lhs) != __cpa_is_negative(rhs));
+    }
+
+  /*
+   * Calculate the numerator of lhs * Denominator / rhs, with the same choice of types as cpa::__cpa_fixed_multiply.
+   */
+  template<typename Rep, Rep Denominator>
+  constexpr Rep __cpa_fixed_divide(Rep const lhs, Rep const rhs)
+    {
+    using unsigned_t = __cpa_make_unsigned_t<Rep>;
+    using wide_t = __cpa_make_unsigned_t<__cpa_fixed_wide_t<Rep>>;
+
+    if(!rhs)
+      {
+      throw std::domain_error{"division by 0 would result in an undefined value"};
+      }
+
+    auto const lhs_magnitude = __cpa_magnitude(lhs);
+    auto const rhs_magnitude = __cpa_magnitude(rhs);
+    unsigned_t scaled{};
+
+    auto const magnitude = __cpa_multiply_overflow(lhs_magnitude, static_cast<unsigned_t>(Denominator), scaled)
+      ? static_cast<unsigned_t>(__cpa_round_divide(static_cast<wide_t>(static_cast<wide_t>(lhs_magnitude) * Denominator),
+                                                   static_cast<wide_t>(rhs_magnitude)))
+      : __cpa_round_divide(scaled, rhs_magnitude);
+
+    return __cpa_apply_sign<Rep>(magnitude, __cpa_is_negative(lhs) != __cpa_is_negative(rhs));
+    }
+
+  /*
+   * Multiply magnitude by Denominator, keeping the quotient magnitude / divisor. If the wider type can hold any such
+   * product, the multiplication is plain.
+   */
+  template<typename Rep, Rep Denominator, typename Unsigned>
+  constexpr void __cpa_fixed_scale(Unsigned & magnitude, Unsigned &, std::false_type) noexcept
+    {
+    magnitude = static_cast<Unsigned>(magnitude * static_cast<Unsigned>(Denominator));
+    }
+
+  /*
+   * Without a wider type, the common factors of divisor and Denominator are cancelled if the product overflows, and products
+   * that still overflow are rejected.
+   */
+  template<typename Rep, Rep Denominator, typename Unsigned>
+  constexpr void __cpa_fixed_scale(Unsigned & magnitude, Unsigned & divisor, std::true_type)
+    {
+    auto factor = static_cast<Unsigned>(Denominator);
+    Unsigned scaled{};
+
+    if(__cpa_multiply_overflow(magnitude, factor, scaled))
+      {
+      auto const gcd = __cpa_binary_gcd(divisor, factor);
+      divisor = static_cast<Unsigned>(divisor / gcd);
+      factor = static_cast<Unsigned>(factor / gcd);
+
+      if(__cpa_multiply_overflow(magnitude, factor, scaled))
+        {
+        throw std::domain_error{"result is not representable by the representation type"};
+        }
+      }
+
+    magnitude = scaled;
+    }
+
+  /*
+   * Calculate the numerator of value with the fixed Denominator. Unless round is true, values that are not a multiple of
+   * 1 / Denominator are rejected.
+   */
+  template<typename Rep, Rep Denominator, typename Policy>
+  constexpr Rep __cpa_fixed_numerator(basic_rational<Rep, Policy> const & value, bool const round)
+    {
+    using wide_t = __cpa_make_unsigned_t<__cpa_fixed_wide_t<Rep>>;
+
+    auto const negative = __cpa_is_negative(value.numerator()) != __cpa_is_negative(value.denominator());
+    auto scaled = static_cast<wide_t>(__cpa_magnitude(value.numerator()));
+    auto divisor = static_cast<wide_t>(__cpa_magnitude(value.denominator()));
+    __cpa_fixed_scale<Rep, Denominator>(scaled, divisor, std::is_void<__cpa_widened_t<Rep>>{});
+
+    if(!round && scaled % divisor)
+      {
+      throw std::domain_error{"value is not a multiple of the fixed denominator"};
+      }
+
+    auto const magnitude = __cpa_round_divide(scaled, divisor);
+    auto const limit = static_cast<wide_t>(static_cast<wide_t>(__cpa_max_value<Rep>()) + (negative ? 1 : 0));
+
+    if(magnitude > limit)
+      {
+      throw std::domain_error{"result is not representable by the representation type"};
+      }
+
+    return __cpa_apply_sign<Rep>(magnitude, negative);
+    }
+
+  /**
+   * A rational number with a numerator of type \p Rep and the constant denominator \p Denominator
+   *
+   * Only the numerator is stored, so a cpa::fixed_rational has the size of \p Rep. The value is never reduced, and the
+   * results of multiplications and divisions are rounded to the nearest multiple of 1 / \p Denominator, with ties rounded
+   * away from 0. All other operations are exact.
+   *
+   * \note
+   * A \p Denominator less than 1 is rejected at compile time.
+   */
+  template<typename Rep, Rep Denominator>
+  struct fixed_rational
+    {
+    static_assert(__cpa_is_binary_gcd_capable<Rep>::value, "fixed_rational requires a non-bool integral type");
+    static_assert(Denominator > 0, "denominator must be positive");
+
+    using rep = Rep;
+
+    /**
+     * Construct a cpa::fixed_rational representing 0.
+     */
+    constexpr fixed_rational() noexcept = default;
+
+    /**
+     * Construct a cpa::fixed_rational representing the integer \p value
+     *
+     * \note
+     * If Rep can not represent \p value * Denominator, the behavior is undefined.
+     */
+    explicit constexpr fixed_rational(rep const value) noexcept
+      : m_numerator{static_cast<rep>(value * Denominator)}
+      {
+      }
+
+    /**
+     * Convert a cpa::basic_rational to a cpa::fixed_rational
+     *
+     * \note
+     * This constructor will throw an object of type std::domain_error iff \p value is not a multiple of 1 / Denominator, or if
+     * the resulting numerator can not be represented by Rep.
+     */
+    template<typename Policy>
+    explicit constexpr fixed_rational(basic_rational<rep, Policy> const & value)
+      : m_numerator{__cpa_fixed_numerator<rep, Denominator>(value, false)}
+      {
+      }
+
+    /**
+     * Create a cpa::fixed_rational with the numerator \p numerator, representing \p numerator / Denominator
+     */
+    static constexpr fixed_rational from_numerator(rep const numerator) noexcept
+      {
+      auto result = fixed_rational{};
+      result.m_numerator = numerator;
+      return result;
+      }
+
+    /**
+     * Create a cpa::fixed_rational by rounding \p value to the nearest multiple of 1 / Denominator, with ties rounded away
+     * from 0
+     *
+     * \note
+     * This function will throw an object of type std::domain_error iff the resulting numerator can not be represented by Rep.
+     */
+    template<typename Policy>
+    static constexpr fixed_rational round(basic_rational<rep, Policy> const & value)
+      {
+      return from_numerator(__cpa_fixed_numerator<rep, Denominator>(value, true));
+      }
+
+    /**
+     * Convert a cpa::fixed_rational to a cpa::basic_rational
+     *
+     * \note
+     * The conversion is lossless, but the result is not reduced, unless required by the normalization policy. If \p OtherRep
+     * can not represent the numerator or the denominator, the behavior is undefined.
+     */
+    template<typename OtherRep, typename Policy>
+    constexpr operator basic_rational<OtherRep, Policy>() const
+      {
+      return basic_rational<OtherRep, Policy>{__cpa_unchecked{}, static_cast<OtherRep>(m_numerator),
+                                              static_cast<OtherRep>(Denominator)};
+      }
+
+    /**
+     * Convert a cpa::fixed_rational to a bool
+     *
+     * \return
+     * true if the cpa::fixed_rational object does not represent 0, false otherwise
+     */
+    explicit constexpr operator bool() const noexcept
+      {
+      return static_cast<bool>(m_numerator);
+      }
+
+    /**
+     * Convert a cpa::fixed_rational to a long double
+     *
+     * \note
+     * This conversion may loose precission.
+     */
+    explicit constexpr operator long double() const noexcept
+      {
+      return static_cast<long double>(m_numerator) / static_cast<long double>(Denominator);
+      }
+
+    constexpr fixed_rational operator - () const noexcept
+      {
+      return from_numerator(static_cast<rep>(-m_numerator));
+      }
+
+    /**
+     * Add \p other to the current object
+     *
+     * \note
+     * If Rep can not represent the result, the behavior is undefined.
+     */
+    constexpr fixed_rational & operator += (fixed_rational const & other) noexcept
+      {
+      m_numerator += other.m_numerator;
+      return *this;
+      }
+
+    /**
+     * Subtract \p other from the current object
+     *
+     * \note
+     * If Rep can not represent the result, the behavior is undefined.
+     */
+    constexpr fixed_rational & operator -= (fixed_rational const & other) noexcept
+      {
+      m_numerator -= other.m_numerator;
+      return *this;
+      }
+
+    /**
+     * Multiply the current object by \p other
+     *
+     * \note
+     * See cpa::operator*(fixed_rational<Rep, Denominator>, fixed_rational<Rep, Denominator>) for details.
+     */
+    constexpr fixed_rational & operator *= (fixed_rational const & other) noexcept
+      {
+      m_numerator = __cpa_fixed_multiply<rep, Denominator>(m_numerator, other.m_numerator);
+      return *this;
+      }
+
+    /**
+     * Multiply the current object by the integer \p factor
+     *
+     * \note
+     * If Rep can not represent the result, the behavior is undefined.
+     */
+    constexpr fixed_rational & operator *= (rep const factor) noexcept
+      {
+      m_numerator *= factor;
+      return *this;
+      }
+
+    /**
+     * Divide the current object by \p other
+     *
+     * \note
+     * See cpa::operator/(fixed_rational<Rep, Denominator>, fixed_rational<Rep, Denominator>) for details.
+     */
+    constexpr fixed_rational & operator /= (fixed_rational const & other)
+      {
+      m_numerator = __cpa_fixed_divide<rep, Denominator>(m_numerator, other.m_numerator);
+      return *this;
+      }
+
+    /**
+     * Get the numerator of the current object.
+     */
+    constexpr rep numerator() const noexcept
+      {
+      return m_numerator;
+      }
+
+    /**
+     * Get the denominator shared by all objects of this type.
+     */
+    static constexpr rep denominator() noexcept
+      {
+      return Denominator;
+      }
+
+    private:
+      rep m_numerator{};
+    };
+
+  /*
+   * Calculate Base raised to the power of Exponent, rejecting overflows at compile time.
+   */
+  template<typename Rep>
+  constexpr Rep __cpa_power(Rep const base, int const exponent)
+    {
+    Rep result{1};
+
+    for(int step{}; step < exponent; ++step)
+      {
+      if(__cpa_multiply_overflow(result, base, result))
+        {
+        throw std::domain_error{"result is not representable by the representation type"};
+        }
+      }
+
+    return result;
+    }
+
+  /**
+   * Alias for the cpa::fixed_rational with \p Digits decimal places, like cpa::decimal<std::int64_t, 2> for cents
+   */
+  template<typename Rep, int Digits>
+  using decimal = fixed_rational<Rep, __cpa_power(Rep{10}, Digits)>;
+
+  /**
+   * Add two cpa::fixed_rational objects
+   *
+   * \note
+   * The numerators are added, and no normalization is required. If Rep can not represent the result, the behavior is
+   * undefined.
+   */
+  template<typename Rep, Rep Denominator>
+  constexpr fixed_rational<Rep, Denominator> operator + (fixed_rational<Rep, Denominator> lhs,
+                                                         fixed_rational<Rep, Denominator> const & rhs) noexcept
+    {
+    return lhs += rhs;
+    }
+
+  /**
+   * Subtract two cpa::fixed_rational objects
+   *
+   * \note
+   * The same guarantees as for cpa::operator+(fixed_rational<Rep, Denominator>, fixed_rational<Rep, Denominator>) apply.
+   */
+  template<typename Rep, Rep Denominator>
+  constexpr fixed_rational<Rep, Denominator> operator - (fixed_rational<Rep, Denominator> lhs,
+                                                         fixed_rational<Rep, Denominator> const & rhs) noexcept
+    {
+    return lhs -= rhs;
+    }
+
+  /**
+   * Multiply two cpa::fixed_rational objects
+   *
+   * \note
+   * The result is rounded to the nearest multiple of 1 / Denominator, with ties rounded away from 0. The product of the
+   * numerators is formed in a type of twice the width of Rep if necessary, so that only the result must be representable by
+   * Rep. If there is no such type and Rep can not represent the product, the behavior is undefined.
+   */
+  template<typename Rep, Rep Denominator>
+  constexpr fixed_rational<Rep, Denominator> operator * (fixed_rational<Rep, Denominator> lhs,
+                                                         fixed_rational<Rep, Denominator> const & rhs) noexcept
+    {
+    return lhs *= rhs;
+    }
+
+  /**
+   * Multiply a cpa::fixed_rational by an integer
+   *
+   * \note
+   * The result is exact. If Rep can not represent it, the behavior is undefined.
+   */
+  template<typename Rep, Rep Denominator>
+  constexpr fixed_rational<Rep, Denominator> operator * (fixed_rational<Rep, Denominator> lhs,
+                                                         typename fixed_rational<Rep, Denominator>::rep const rhs) noexcept
+    {
+    return lhs *= rhs;
+    }
+
+  template<typename Rep, Rep Denominator>
+  constexpr fixed_rational<Rep, Denominator> operator * (typename fixed_rational<Rep, Denominator>::rep const lhs,
+                                                         fixed_rational<Rep, Denominator> rhs) noexcept
+    {
+    return rhs *= lhs;
+    }
+
+  /**
+   * Divide two cpa::fixed_rational objects
+   *
+   * \note
+   * The same guarantees as for cpa::operator*(fixed_rational<Rep, Denominator>, fixed_rational<Rep, Denominator>) apply.
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff rhs is equal to 0.
+   */
+  template<typename Rep, Rep Denominator>
+  constexpr fixed_rational<Rep, Denominator> operator / (fixed_rational<Rep, Denominator> lhs,
+                                                         fixed_rational<Rep, Denominator> const & rhs)
+    {
+    return lhs /= rhs;
+    }
+
+  template<typename Rep, Rep Denominator>
+  constexpr bool operator == (fixed_rational<Rep, Denominator> const & lhs, fixed_rational<Rep, Denominator> const & rhs) noexcept
+    {
+    return lhs.numerator() == rhs.numerator();
+    }
+
+  template<typename Rep, Rep Denominator>
+  constexpr bool operator != (fixed_rational<Rep, Denominator> const & lhs, fixed_rational<Rep, Denominator> const & rhs) noexcept
+    {
+    return lhs.numerator() != rhs.numerator();
+    }
+
+  template<typename Rep, Rep Denominator>
+  constexpr bool operator < (fixed_rational<Rep, Denominator> const & lhs, fixed_rational<Rep, Denominator> const & rhs) noexcept
+    {
+    return lhs.numerator() < rhs.numerator();
+    }
+
+  template<typename Rep, Rep Denominator>
+  constexpr bool operator > (fixed_rational<Rep, Denominator> const & lhs, fixed_rational<Rep, Denominator> const & rhs) noexcept
+    {
+    return rhs < lhs;
+    }
+
+  template<typename Rep, Rep Denominator>
+  constexpr bool operator <= (fixed_rational<Rep, Denominator> const & lhs, fixed_rational<Rep, Denominator> const & rhs) noexcept
+    {
+    return !(rhs < lhs);
+    }
+
+  template<typename Rep, Rep Denominator>
+  constexpr bool operator >= (fixed_rational<Rep, Denominator> const & lhs, fixed_rational<Rep, Denominator> const & rhs) noexcept
+    {
+    return !(lhs < rhs);
+    }
+
+  }
+
+namespace std
+  {
+
+  template<typename Rep, Rep Denominator>
+  struct hash<cpa::fixed_rational<Rep, Denominator>>
+    {
+    std::size_t operator()(cpa::fixed_rational<Rep, Denominator> const & value) const
+      {
+      return static_cast<std::size_t>(cpa::__cpa_hash_value(value.numerator()));
+      }
+    };
+
+  }
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef __CPA__INSTRUMENTATION
+#define __CPA__INSTRUMENTATION
+
+#include <__impl/instrumentation.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * \file instrumentation.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief Access to the hot-path instrumentation counters of the library.
+ *
+ * If the macro \p CPA_INSTRUMENTATION is defined (the CMake option \p CPA_ENABLE_INSTRUMENTATION does so for all targets),
+ * the library counts the calls of cpa::gcd, cpa::lcm, cpa::basic_rational::reduce, cpa::basic_rational::common and
+ * cpa::basic_rational::expand, the loop iterations of the GCD algorithms, and the magnitudes of the results. Every thread counts
+ * into its own set of counters, which are only aggregated when a snapshot is taken. Without the macro, all hooks compile to
+ * nothing and snapshots are always empty.
+ *
+ * \note
+ * The macro must be defined consistently for all translation units of a program.
+ */
+
+namespace cpa
+  {
+
+  namespace instrumentation
+    {
+
+    /**
+     * Whether the library was compiled with instrumentation
+     */
+#if defined(CPA_INSTRUMENTATION)
+    constexpr bool enabled = true;
+#else
+    constexpr bool enabled = false;
+#endif
+
+    /**
+     * The instrumented operations
+     *
+     * \note
+     * The GCD counters include the GCDs calculated internally, for example by cpa::basic_rational::reduce or cpa::lcm, and
+     * the GCDs of the batched overloads. Loop iterations are only counted for the GCD algorithms, since all other operations
+     * are free of loops.
+     */
+    using operation = __cpa_operation;
+
+    /**
+     * The number of buckets of the magnitude histograms
+     *
+     * Bucket \p n counts the results whose magnitude requires exactly \p n bits. For cpa::basic_rational results, the larger
+     * magnitude of the numerator and the denominator is used. Results of types other than integral types are not recorded in
+     * the histograms.
+     */
+    constexpr std::size_t magnitude_buckets = __cpa_magnitude_buckets;
+
+    /**
+     * The aggregated counters of a single operation
+     */
+    struct counters
+      {
+      std::uint64_t calls;
+      std::uint64_t iterations;
+      std::array<std::uint64_t, magnitude_buckets> magnitudes;
+      };
+
+    /**
+     * The aggregated counters of all operations
+     */
+    struct report
+      {
+      counters const & operator [] (operation const which) const noexcept
+        {
+        return operations[static_cast<std::size_t>(which)];
+        }
+
+      std::array<counters, __cpa_operation_count> operations;
+      };
+
+    /**
+     * Sum up the counters of all threads, including threads that have already exited
+     *
+     * \note
+     * Counts recorded by other threads while the snapshot is taken may or may not be included.
+     */
+    inline report snapshot()
+      {
+      auto result = report{};
+
+#if defined(CPA_INSTRUMENTATION)
+      auto & registry = __cpa_counters();
+      std::lock_guard<std::mutex> lock{registry.mutex};
+
+      for(std::size_t index{}; index < __cpa_operation_count; ++index)
+        {
+        auto & totals = result.operations[index];
+        totals.calls = registry.calls[index];
+        totals.iterations = registry.iterations[index];
+
+        for(std::size_t bucket{}; bucket < magnitude_buckets; ++bucket)
+          {
+          totals.magnitudes[bucket] = registry.magnitudes[index][bucket];
+          }
+
+        for(auto const thread : registry.threads)
+          {
+          totals.calls += thread->calls[index].load(std::memory_order_relaxed);
+          totals.iterations += thread->iterations[index].load(std::memory_order_relaxed);
+
+          for(std::size_t bucket{}; bucket < magnitude_buckets; ++bucket)
+            {
+            totals.magnitudes[bucket] += thread->magnitudes[index][bucket].load(std::memory_order_relaxed);
+            }
+          }
+        }
+#endif
+
+      return result;
+      }
+
+    /**
+     * Reset the counters of all threads to zero
+     *
+     * \note
+     * Threads that record counts while the counters are reset may keep parts of their previous counts. Reset the counters
+     * while the instrumented operations are quiescent to get exact results.
+     */
+    inline void reset()
+      {
+#if defined(CPA_INSTRUMENTATION)
+      auto & registry = __cpa_counters();
+      std::lock_guard<std::mutex> lock{registry.mutex};
+
+      for(std::size_t index{}; index < __cpa_operation_count; ++index)
+        {
+        registry.calls[index] = 0;
+        registry.iterations[index] = 0;
+
+        for(auto & bucket : registry.magnitudes[index])
+          {
+          bucket = 0;
+          }
+
+        for(auto const thread : registry.threads)
+          {
+          thread->calls[index].store(0, std::memory_order_relaxed);
+          thread->iterations[index].store(0, std::memory_order_relaxed);
+
+          for(auto & bucket : thread->magnitudes[index])
+            {
+            bucket.store(0, std::memory_order_relaxed);
+            }
+          }
+        }
+#endif
+      }
+
+    }
+
+  }
+
+#endif
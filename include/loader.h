@@ -0,0 +1,181 @@
+#ifndef __CPA__LOADER
+#define __CPA__LOADER
+
+#include <charconv.h>
+#include <parallel.h>
+#include <rational.h>
+#include <__impl/mapped_file.h>
+#include <__impl/thread_pool.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+/**
+ * \file loader.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief Multi-threaded parsing of text containing one cpa::basic_rational per line.
+ *
+ * The text is split into chunks ending at line boundaries. In a first parallel pass, the lines of each chunk are counted,
+ * which determines where the values of each chunk are stored in the result. In a second parallel pass, every chunk is parsed
+ * with cpa::from_chars, directly into its part of the result. No intermediate strings are created.
+ */
+
+namespace cpa
+  {
+
+  namespace parallel
+    {
+
+    /*
+     * Texts are split into chunks of at least this number of bytes, but into no more than four chunks per thread.
+     */
+    constexpr std::size_t __cpa_minimum_text_chunk_size = 64 * 1024;
+
+    /*
+     * Call line(begin, end) for every non-empty line in [first, last). Line endings are either "\n" or "\r\n", and the last
+     * line does not need to be terminated.
+     */
+    template<typename Line>
+    void __cpa_for_each_line(char const * first, char const * const last, Line && line)
+      {
+      while(first != last)
+        {
+        auto const newline = static_cast<char const *>(std::memchr(first, '\n', static_cast<std::size_t>(last - first)));
+        auto const next = newline ? newline + 1 : last;
+        auto end = newline ? newline : last;
+
+        if(end != first && *(end - 1) == '\r')
+          {
+          --end;
+          }
+
+        if(end != first)
+          {
+          line(first, end);
+          }
+
+        first = next;
+        }
+      }
+
+    /*
+     * Split [first, last) into at most count chunks, each of which ends right after a newline or at last.
+     */
+    inline std::vector<char const *> __cpa_split_lines(char const * const first, char const * const last,
+                                                       std::size_t const count)
+      {
+      auto const size = static_cast<std::size_t>(last - first);
+      auto boundaries = std::vector<char const *>{first};
+
+      for(std::size_t chunk{1}; chunk < count; ++chunk)
+        {
+        auto const nominal = std::max(first + chunk * size / count, boundaries.back());
+        auto const newline = static_cast<char const *>(std::memchr(nominal, '\n', static_cast<std::size_t>(last - nominal)));
+
+        if(!newline)
+          {
+          break;
+          }
+
+        boundaries.push_back(newline + 1);
+        }
+
+      boundaries.push_back(last);
+      return boundaries;
+      }
+
+    /**
+     * Parse the text in [\p first, \p last), containing one cpa::basic_rational per line, using up to \p threads threads
+     *
+     * Every non-empty line must contain exactly one value in the form accepted by cpa::from_chars. Lines may end in "\n" or
+     * "\r\n". The values are reduced while parsing.
+     *
+     * \note
+     * This function will throw an instance of std::domain_error iff a line does not contain a valid value, or a value can not
+     * be represented by the representation type of \p Rational.
+     *
+     * \return
+     * The values in the order of their lines.
+     */
+    template<typename Rational = rational>
+    std::vector<Rational> parse(char const * const first, char const * const last,
+                                unsigned const threads = __cpa_default_threads())
+      {
+      auto const size = static_cast<std::size_t>(last - first);
+
+      if(!size)
+        {
+        return {};
+        }
+
+      auto const workers = static_cast<std::size_t>(threads ? threads : 1);
+      auto const by_size = (size + __cpa_minimum_text_chunk_size - 1) / __cpa_minimum_text_chunk_size;
+      auto const boundaries = __cpa_split_lines(first, last, std::min(by_size, workers * __cpa_chunks_per_thread));
+      auto const chunks = boundaries.size() - 1;
+
+      auto offsets = std::vector<std::size_t>(chunks + 1);
+
+      __cpa_run_work_stealing(chunks, workers, [&](std::size_t const chunk)
+        {
+        auto count = std::size_t{};
+        __cpa_for_each_line(boundaries[chunk], boundaries[chunk + 1], [&](char const *, char const *) { ++count; });
+        offsets[chunk + 1] = count;
+        });
+
+      std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+      auto values = std::vector<Rational>(offsets.back());
+
+      __cpa_run_work_stealing(chunks, workers, [&](std::size_t const chunk)
+        {
+        auto output = values.begin() + static_cast<std::ptrdiff_t>(offsets[chunk]);
+
+        __cpa_for_each_line(boundaries[chunk], boundaries[chunk + 1], [&](char const * const begin, char const * const end)
+          {
+          auto const result = cpa::from_chars(begin, end, *output++);
+
+          if(result.ec == std::errc::result_out_of_range)
+            {
+            throw std::domain_error{"The value is not representable with the given representation type"};
+            }
+          else if(result.ec != std::errc{} || result.ptr != end)
+            {
+            throw std::domain_error{"Line does not contain a valid rational number"};
+            }
+          });
+        });
+
+      return values;
+      }
+
+    /**
+     * Load the file at \p path, containing one cpa::basic_rational per line, using up to \p threads threads
+     *
+     * The file is mapped into memory and parsed like by cpa::parallel::parse.
+     *
+     * \note
+     * This function will throw an instance of std::system_error iff the file can not be opened or mapped, and an instance of
+     * std::domain_error under the same conditions as cpa::parallel::parse.
+     *
+     * \return
+     * The values in the order of their lines.
+     */
+    template<typename Rational = rational>
+    std::vector<Rational> load(char const * const path, unsigned const threads = __cpa_default_threads())
+      {
+      __cpa_mapped_file const file{path};
+      return parse<Rational>(file.data(), file.data() + file.size(), threads);
+      }
+
+    }
+
+  }
+
+#endif
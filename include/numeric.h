@@ -2,10 +2,13 @@
 #define __CPA__NUMERIC
 
 #include <type_traits.h>
+#include <__impl/batch_gcd.h>
+#include <__impl/checked.h>
+#include <__impl/extern_templates.h>
+#include <__impl/numeric.h>
 
+#include <cstddef>
 #include <cstdint>
-#include <iostream>
-#include <sstream>
 #include <stdexcept>
 
 /**
@@ -36,55 +39,645 @@ namespace cpa
     return val;
     }
 
+  /**
+   * Function object calculating the GCD of two numbers using the Euclidean algorithm
+   *
+   * \note
+   * This algorithm works for every type that is Negatable, LessThanComparable and supports the operators \p % and \p %=. It is
+   * the fallback used by cpa::gcd for user-defined types.
+   */
+  struct euclidean_gcd
+    {
+    template<typename Type>
+    constexpr Type operator()(Type const lhs, Type const rhs) const
+      {
+      if(!lhs && !rhs)
+        {
+        __CPA_INSTRUMENT(gcd, 0, 0);
+        return 0;
+        }
+
+      Type left = abs(lhs);
+      Type right = abs(rhs);
+      std::uint64_t iterations{};
+
+      while(left && right)
+        {
+        ++iterations;
+
+        if(left > right)
+          {
+          left %= right;
+          }
+        else
+          {
+          right %= left;
+          }
+        }
+
+      Type const result = right > left ? right : left;
+      __CPA_INSTRUMENT(gcd, iterations, __cpa_magnitude_bits(result));
+      return result;
+      }
+    };
+
+  /**
+   * Function object calculating the GCD of two integral numbers using the binary (Stein's) algorithm
+   *
+   * \note
+   * Instead of divisions, this algorithm only uses subtractions and shifts by the number of trailing zero bits. The
+   * calculation is carried out on the magnitudes of the operands, so it is well-defined for the most negative value of a signed
+   * type, as long as the result is representable.
+   */
+  struct binary_gcd
+    {
+    template<typename Integral>
+    constexpr Integral operator()(Integral const lhs, Integral const rhs) const noexcept
+      {
+      static_assert(__cpa_is_binary_gcd_capable<Integral>::value, "binary_gcd requires a non-bool integral type");
+      return static_cast<Integral>(__cpa_binary_gcd(__cpa_magnitude(lhs), __cpa_magnitude(rhs)));
+      }
+    };
+
+  /**
+   * Function object calculating the GCD of two integral numbers using the Euclidean algorithm, narrowing the operands to
+   * 32 bits as soon as both of them fit
+   *
+   * \note
+   * This algorithm is beneficial on targets where wide integer division is considerably slower than 32-bit division, but
+   * counting trailing zeros is not supported by the hardware.
+   */
+  struct narrowing_gcd
+    {
+    template<typename Integral>
+    constexpr Integral operator()(Integral const lhs, Integral const rhs) const noexcept
+      {
+      static_assert(__cpa_is_binary_gcd_capable<Integral>::value, "narrowing_gcd requires a non-bool integral type");
+      return static_cast<Integral>(__cpa_narrowing_gcd(__cpa_magnitude(lhs), __cpa_magnitude(rhs)));
+      }
+    };
+
+  /**
+   * Select the algorithm used by cpa::gcd for a given type
+   *
+   * Provides a member typedef \p type naming a function object type like cpa::euclidean_gcd. Integral types other than \p bool
+   * default to cpa::binary_gcd, all other types default to cpa::euclidean_gcd.
+   *
+   * \note Applications might specialize this struct for user-defined types.
+   */
+  template<typename Type>
+  struct gcd_algorithm
+    {
+    using type = std::conditional_t<__cpa_is_binary_gcd_capable<Type>::value, binary_gcd, euclidean_gcd>;
+    };
+
+  /**
+   * Alias for the type member of cpa::gcd_algorithm<Type>
+   */
+  template<typename Type>
+  using gcd_algorithm_t = typename gcd_algorithm<Type>::type;
+
+  /*
+   * The result type of the functions of two numbers, which do not participate in overload resolution for iterators, so that
+   * they do not hide the functions of ranges.
+   */
+  template<typename Left, typename Right>
+  using __cpa_scalar_result_t = std::enable_if_t<!__cpa_is_iterator<Left>::value, std::common_type_t<Left, Right>>;
+
+  /*
+   * Convert an operand of cpa::gcd to the common type of the operands. If the common type is unsigned, a signed operand is
+   * converted via its magnitude, since the conversion of a negative value would wrap around and change the divisors.
+   */
+  template<typename Common, typename Type>
+  constexpr Common __cpa_gcd_operand(Type const value, std::true_type)
+    {
+    return static_cast<Common>(__cpa_magnitude(value));
+    }
+
+  template<typename Common, typename Type>
+  constexpr Common __cpa_gcd_operand(Type const value, std::false_type)
+    {
+    return static_cast<Common>(value);
+    }
+
+  template<typename Common, typename Type>
+  constexpr Common __cpa_gcd_operand(Type const value)
+    {
+    return __cpa_gcd_operand<Common>(value, std::integral_constant<bool, __cpa_is_signed_integral<Type>::value &&
+                                                                          __cpa_is_unsigned_integral<Common>::value>{});
+    }
+
   /**
    * Get the GCD of two numbers
    *
    * \note lhs and rhs must have a common type
+   * \note The algorithm used for the calculation is selected via cpa::gcd_algorithm
+   * \note Applications might specialize this function iff at least one of \p Left or \p Right is a user-defined type, otherwise
+   * the program is ill-formed.
+   */
+  template<typename Left, typename Right>
+  constexpr __cpa_scalar_result_t<Left, Right> gcd(Left lhs, Right rhs)
+    {
+    using common_t = std::common_type_t<Left, Right>;
+    return gcd_algorithm_t<common_t>{}(__cpa_gcd_operand<common_t>(lhs), __cpa_gcd_operand<common_t>(rhs));
+    }
+
+  /**
+   * Get the LCM of two numbers
+   *
+   * \note \p lhs and \p rhs must have a common type
    * \note Applications might specialize this function iff at least one of \p Left or \p Right is a user-defined type, otherwise
    * the program is ill-formed.
    */
   template<typename Left, typename Right>
-  constexpr std::common_type_t<Left, Right> gcd(Left lhs, Right rhs)
+  constexpr __cpa_scalar_result_t<Left, Right> lcm(Left lhs, Right rhs)
+    {
+    std::common_type_t<Left, Right> const result = (lhs / gcd(lhs, rhs)) * rhs;
+    __CPA_INSTRUMENT(lcm, 0, __cpa_magnitude_bits(result));
+    return result;
+    }
+
+  /**
+   * The result of cpa::extended_gcd
+   *
+   * The members satisfy \p gcd == lhs * \p x + rhs * \p y for the arguments lhs and rhs of cpa::extended_gcd.
+   */
+  template<typename Integral>
+  struct extended_gcd_result
+    {
+    Integral gcd;
+    Integral x;
+    Integral y;
+    };
+
+  /*
+   * The extended Euclidean algorithm on magnitudes. The coefficients of the remainders alternate in sign, so only their
+   * magnitudes are tracked, and the sign of the final ones is determined by the number of steps. All values stay below the
+   * larger argument, so no step can overflow.
+   */
+  template<typename Unsigned>
+  constexpr Unsigned __cpa_extended_euclid(Unsigned lhs, Unsigned rhs, Unsigned & lhs_coefficient, Unsigned & rhs_coefficient,
+                                           std::uint64_t & iterations) noexcept
+    {
+    Unsigned lhs_next{0};
+    Unsigned rhs_next{1};
+    lhs_coefficient = 1;
+    rhs_coefficient = 0;
+
+    for(; rhs; ++iterations)
+      {
+      auto const quotient = static_cast<Unsigned>(lhs / rhs);
+      auto const remainder = static_cast<Unsigned>(lhs - quotient * rhs);
+      auto const lhs_step = static_cast<Unsigned>(lhs_coefficient + quotient * lhs_next);
+      auto const rhs_step = static_cast<Unsigned>(rhs_coefficient + quotient * rhs_next);
+
+      lhs = rhs;
+      rhs = remainder;
+      lhs_coefficient = lhs_next;
+      lhs_next = lhs_step;
+      rhs_coefficient = rhs_next;
+      rhs_next = rhs_step;
+      }
+
+    return lhs;
+    }
+
+  /**
+   * Get the GCD of two integers together with the coefficients of Bezout's identity
+   *
+   * \note \p Left and \p Right must have a signed integral common type.
+   * \note The GCD is not negative, and the coefficients are minimal: unless one argument divides the other, |x| <= |rhs| / (2
+   * gcd) and |y| <= |lhs| / (2 gcd). If the GCD can not be represented, like for the most negative value and 0, the behavior is
+   * undefined.
+   */
+  template<typename Left, typename Right>
+  constexpr extended_gcd_result<std::common_type_t<Left, Right>> extended_gcd(Left lhs, Right rhs)
     {
     using common_t = std::common_type_t<Left, Right>;
+    using unsigned_t = __cpa_make_unsigned_t<common_t>;
+    static_assert(__cpa_is_signed_integral<common_t>::value, "extended_gcd requires a signed integral type");
+
+    auto const lhs_value = static_cast<common_t>(lhs);
+    auto const rhs_value = static_cast<common_t>(rhs);
+    unsigned_t lhs_coefficient{};
+    unsigned_t rhs_coefficient{};
+    std::uint64_t iterations{};
+
+    auto const gcd = __cpa_extended_euclid(__cpa_magnitude(lhs_value), __cpa_magnitude(rhs_value), lhs_coefficient,
+                                           rhs_coefficient, iterations);
+    auto const odd = static_cast<bool>(iterations & 1);
+
+    __CPA_INSTRUMENT(gcd, iterations, __cpa_magnitude_bits(gcd));
+    return {static_cast<common_t>(gcd),
+            __cpa_apply_sign<common_t>(lhs_coefficient, odd != __cpa_is_negative(lhs_value)),
+            __cpa_apply_sign<common_t>(rhs_coefficient, !odd != __cpa_is_negative(rhs_value))};
+    }
+
+  /*
+   * Reduce value to the range [0, modulus).
+   */
+  template<typename Integral, typename Unsigned = __cpa_make_unsigned_t<Integral>>
+  constexpr Unsigned __cpa_reduce_modulo(Integral const value, Unsigned const modulus) noexcept
+    {
+    auto const remainder = static_cast<Unsigned>(__cpa_magnitude(value) % modulus);
+    return __cpa_is_negative(value) && remainder ? static_cast<Unsigned>(modulus - remainder) : remainder;
+    }
+
+  template<typename Unsigned>
+  constexpr Unsigned __cpa_multiply_modulo(Unsigned const lhs, Unsigned const rhs, Unsigned const modulus, std::true_type)
+    noexcept
+    {
+    using wide_t = __cpa_widened_t<Unsigned>;
+    return static_cast<Unsigned>(static_cast<wide_t>(static_cast<wide_t>(lhs) * rhs) % modulus);
+    }
+
+  template<typename Unsigned>
+  constexpr Unsigned __cpa_multiply_modulo(Unsigned lhs, Unsigned rhs, Unsigned const modulus, std::false_type) noexcept
+    {
+    Unsigned result{};
+
+    for(; rhs; rhs >>= 1)
+      {
+      if(rhs & 1)
+        {
+        result = result >= modulus - lhs ? static_cast<Unsigned>(result - (modulus - lhs)) : static_cast<Unsigned>(result + lhs);
+        }
+
+      lhs = lhs >= modulus - lhs ? static_cast<Unsigned>(lhs - (modulus - lhs)) : static_cast<Unsigned>(lhs + lhs);
+      }
+
+    return result;
+    }
+
+  /*
+   * Multiply two values in [0, modulus) modulo modulus. The product is formed in the type of twice the width if there is one,
+   * and by doubling and adding otherwise.
+   */
+  template<typename Unsigned>
+  constexpr Unsigned __cpa_multiply_modulo(Unsigned const lhs, Unsigned const rhs, Unsigned const modulus) noexcept
+    {
+    using has_wider_t = std::integral_constant<bool, !std::is_void<__cpa_widened_t<Unsigned>>::value>;
+    return __cpa_multiply_modulo(lhs, rhs, modulus, has_wider_t{});
+    }
+
+  /*
+   * Invert value, which must be in [0, modulus), modulo modulus.
+   */
+  template<typename Unsigned>
+  constexpr Unsigned __cpa_inverse_modulo(Unsigned const value, Unsigned const modulus)
+    {
+    Unsigned coefficient{};
+    Unsigned unused{};
+    std::uint64_t iterations{};
+
+    if(__cpa_extended_euclid(value, modulus, coefficient, unused, iterations) != Unsigned{1})
+      {
+      throw std::domain_error{"value is not invertible modulo the modulus"};
+      }
+
+    __CPA_INSTRUMENT(gcd, iterations, 1);
+    return (iterations & 1) && coefficient ? static_cast<Unsigned>(modulus - coefficient) : coefficient;
+    }
+
+  template<typename Integral>
+  constexpr __cpa_make_unsigned_t<Integral> __cpa_checked_modulus(Integral const modulus)
+    {
+    if(!modulus || __cpa_is_negative(modulus))
+      {
+      throw std::domain_error{"modulus must be positive"};
+      }
+
+    return static_cast<__cpa_make_unsigned_t<Integral>>(modulus);
+    }
+
+  /**
+   * Get the modular multiplicative inverse of \p value modulo \p modulus
+   *
+   * \note \p Value and \p Modulus must have an integral common type. Negative values are reduced to [0, \p modulus) first.
+   * \note This function will throw an instance of std::domain_error iff \p modulus is not positive, or \p value and \p modulus
+   * are not coprime.
+   *
+   * \return
+   * The inverse in the range [0, \p modulus)
+   */
+  template<typename Value, typename Modulus>
+  constexpr std::common_type_t<Value, Modulus> mod_inverse(Value value, Modulus modulus)
+    {
+    using common_t = std::common_type_t<Value, Modulus>;
+    static_assert(__cpa_is_binary_gcd_capable<common_t>::value, "mod_inverse requires a non-bool integral type");
+
+    auto const checked = __cpa_checked_modulus(static_cast<common_t>(modulus));
+    return static_cast<common_t>(__cpa_inverse_modulo(__cpa_reduce_modulo(value, checked), checked));
+    }
+
+  template<typename Common>
+  struct __cpa_batch_gcd_finish
+    {
+    constexpr Common operator()(Common const, Common const, Common const gcd) const noexcept
+      {
+      return gcd;
+      }
+    };
+
+  template<typename Common>
+  struct __cpa_batch_lcm_finish
+    {
+    constexpr Common operator()(Common const lhs, Common const rhs, Common const gcd) const noexcept
+      {
+      auto const result = gcd ? static_cast<Common>((lhs / gcd) * rhs) : Common{0};
+      __CPA_INSTRUMENT(lcm, 0, __cpa_magnitude_bits(result));
+      return result;
+      }
+    };
+
+  template<typename InputIt1, typename InputIt2, typename OutputIt, template<typename> class Finish>
+  OutputIt __cpa_batch_gcd(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt destination, std::true_type)
+    {
+    using common_t = std::common_type_t<__cpa_iterator_value_t<InputIt1>, __cpa_iterator_value_t<InputIt2>>;
+    return __cpa_batch_gcd_transform(first1, last1, first2, destination, Finish<common_t>{});
+    }
+
+  template<typename InputIt1, typename InputIt2, typename OutputIt, template<typename> class Finish>
+  OutputIt __cpa_batch_gcd(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt destination, std::false_type)
+    {
+    using common_t = std::common_type_t<__cpa_iterator_value_t<InputIt1>, __cpa_iterator_value_t<InputIt2>>;
+
+    for(; first1 != last1; ++first1, ++first2, ++destination)
+      {
+      common_t const lhs = *first1;
+      common_t const rhs = *first2;
+      *destination = Finish<common_t>{}(lhs, rhs, cpa::gcd(lhs, rhs));
+      }
+
+    return destination;
+    }
+
+  template<typename InputIt1, typename InputIt2>
+  using __cpa_batch_gcd_capable_t =
+    __cpa_is_batch_gcd_capable<std::common_type_t<__cpa_iterator_value_t<InputIt1>, __cpa_iterator_value_t<InputIt2>>>;
+
+  /**
+   * Calculate the GCDs of the corresponding elements of two ranges
+   *
+   * Writes the GCD of each element of [\p first1, \p last1) and the corresponding element of the range beginning at \p first2
+   * to the range beginning at \p destination.
+   *
+   * \note
+   * If the common type of the elements is an integral type of at most 64 bits, the GCDs are calculated in batches by a
+   * vectorized binary GCD. On x86 processors, the implementation is selected at runtime based on the support for AVX2 and
+   * SSE4.2. Otherwise, cpa::gcd is applied to each pair of elements.
+   *
+   * \return
+   * An iterator past the last element written
+   */
+  template<typename InputIt1, typename InputIt2, typename OutputIt>
+  OutputIt gcd(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt destination)
+    {
+    return __cpa_batch_gcd<InputIt1, InputIt2, OutputIt, __cpa_batch_gcd_finish>(first1, last1, first2, destination,
+                                                                                  __cpa_batch_gcd_capable_t<InputIt1, InputIt2>{});
+    }
+
+  /**
+   * Calculate the LCMs of the corresponding elements of two ranges
+   *
+   * Writes the LCM of each element of [\p first1, \p last1) and the corresponding element of the range beginning at \p first2
+   * to the range beginning at \p destination. The GCDs required for the calculation are determined like in
+   * cpa::gcd(InputIt1, InputIt1, InputIt2, OutputIt).
+   *
+   * \note
+   * Unlike cpa::lcm(Left, Right), the LCM of two zeros is defined to be 0.
+   *
+   * \return
+   * An iterator past the last element written
+   */
+  template<typename InputIt1, typename InputIt2, typename OutputIt>
+  OutputIt lcm(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt destination)
+    {
+    return __cpa_batch_gcd<InputIt1, InputIt2, OutputIt, __cpa_batch_lcm_finish>(first1, last1, first2, destination,
+                                                                                  __cpa_batch_gcd_capable_t<InputIt1, InputIt2>{});
+    }
+
+  /**
+   * Calculate the GCD of all elements of a range
+   *
+   * The elements are folded using cpa::gcd. Since the GCD can only shrink, the fold stops as soon as it reaches 1, which for
+   * most ranges of unrelated values happens after the first few elements.
+   *
+   * \note
+   * The GCD of an empty range is 0.
+   */
+  template<typename InputIt>
+  std::enable_if_t<__cpa_is_iterator<InputIt>::value, __cpa_iterator_value_t<InputIt>> gcd(InputIt first, InputIt last)
+    {
+    using value_t = __cpa_iterator_value_t<InputIt>;
+    auto result = value_t{0};
+
+    for(; first != last; ++first)
+      {
+      result = cpa::gcd(result, static_cast<value_t>(*first));
+
+      if(result == value_t{1})
+        {
+        break;
+        }
+      }
+
+    return result;
+    }
+
+  /*
+   * Calculate the LCM of two non-zero magnitudes, throwing an instance of std::domain_error if it can not be represented.
+   */
+  template<typename Unsigned>
+  Unsigned __cpa_checked_lcm(Unsigned const lhs, Unsigned const rhs)
+    {
+    Unsigned result{};
+
+    if(__cpa_multiply_overflow(static_cast<Unsigned>(lhs / __cpa_binary_gcd(lhs, rhs)), rhs, result))
+      {
+      throw std::domain_error{"result is not representable by the representation type"};
+      }
+
+    __CPA_INSTRUMENT(lcm, 0, __cpa_magnitude_bits(result));
+    return result;
+    }
+
+  template<typename Result, typename InputIt>
+  using __cpa_range_lcm_t = std::conditional_t<std::is_void<Result>::value, __cpa_iterator_value_t<InputIt>, Result>;
+
+  /**
+   * Calculate the LCM of all elements of a range
+   *
+   * The partial LCMs are combined in a balanced tree, like in a pairwise summation, so that the operands of each step cover
+   * about the same number of elements and stay as small as possible. Every step is checked for overflow, and the calculation
+   * stops at the first element equal to 0.
+   *
+   * \tparam Result
+   * The integral type in which the LCM is calculated and returned. It defaults to the element type, and can be set to a wider
+   * type if the LCM of the elements might exceed it, as in cpa::lcm<std::int64_t>(first, last) for 32-bit elements.
+   *
+   * \note
+   * The LCM is not negative. The LCM of an empty range is 1, and the LCM of a range containing 0 is 0.
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff the LCM can not be represented by \p Result.
+   */
+  template<typename Result = void, typename InputIt>
+  std::enable_if_t<__cpa_is_iterator<InputIt>::value, __cpa_range_lcm_t<Result, InputIt>> lcm(InputIt first, InputIt last)
+    {
+    using result_t = __cpa_range_lcm_t<Result, InputIt>;
+    using unsigned_t = __cpa_make_unsigned_t<result_t>;
+    static_assert(__cpa_is_binary_gcd_capable<result_t>::value, "lcm of a range requires a non-bool integral type");
 
-    if(!lhs && !rhs)
+    constexpr auto levels = sizeof(std::size_t) * 8;
+    unsigned_t partial[levels] = {};
+    std::size_t count{};
+
+    for(; first != last; ++first, ++count)
       {
-      return 0;
+      auto value = __cpa_magnitude(static_cast<result_t>(*first));
+
+      if(!value)
+        {
+        return result_t{0};
+        }
+
+      auto level = std::size_t{};
+      for(; count & (std::size_t{1} << level); ++level)
+        {
+        value = __cpa_checked_lcm(partial[level], value);
+        }
+
+      partial[level] = value;
       }
 
-    common_t left = abs(lhs);
-    common_t right = abs(rhs);
+    auto result = unsigned_t{1};
 
-    while(left && right)
+    for(auto level = std::size_t{}; level < levels; ++level)
       {
-      if(left > right)
+      if(count & (std::size_t{1} << level))
         {
-        left %= right;
+        result = __cpa_checked_lcm(partial[level], result);
         }
-      else
+      }
+
+    if(result > static_cast<unsigned_t>(__cpa_max_value<result_t>()))
+      {
+      throw std::domain_error{"result is not representable by the representation type"};
+      }
+
+    return static_cast<result_t>(result);
+    }
+
+  /*
+   * Montgomery's trick: the running products of a block of elements are formed, only their total is inverted, and the
+   * individual inverses are recovered walking backwards. The elements and products of a block are kept in local buffers, so
+   * each range is traversed once and every element is read before its inverse is written, at the cost of one inversion per
+   * block.
+   */
+  template<typename Common, typename InputIt, typename OutputIt, typename Unsigned>
+  OutputIt __cpa_batch_inverse(InputIt first, InputIt const last, OutputIt destination, Unsigned const modulus, std::true_type)
+    {
+    constexpr std::size_t block_size = 64;
+    Unsigned values[block_size];
+    Unsigned products[block_size];
+
+    while(first != last)
+      {
+      auto product = static_cast<Unsigned>(1 % modulus);
+      std::size_t count{};
+
+      for(; first != last && count < block_size; ++first, ++count)
         {
-        right %= left;
+        values[count] = __cpa_reduce_modulo(static_cast<__cpa_iterator_value_t<InputIt>>(*first), modulus);
+        products[count] = product;
+        product = __cpa_multiply_modulo(product, values[count], modulus);
         }
+
+      auto inverse = __cpa_inverse_modulo(product, modulus);
+
+      for(auto index = count; index--;)
+        {
+        auto const value = values[index];
+        values[index] = __cpa_multiply_modulo(inverse, products[index], modulus);
+        inverse = __cpa_multiply_modulo(inverse, value, modulus);
+        }
+
+      for(std::size_t index{}; index < count; ++index, ++destination)
+        {
+        *destination = static_cast<Common>(values[index]);
+        }
+      }
+
+    return destination;
+    }
+
+  /*
+   * Without a type of twice the width, a modular multiplication is more expensive than an inversion, so every element is
+   * inverted on its own.
+   */
+  template<typename Common, typename InputIt, typename OutputIt, typename Unsigned>
+  OutputIt __cpa_batch_inverse(InputIt first, InputIt const last, OutputIt destination, Unsigned const modulus, std::false_type)
+    {
+    for(; first != last; ++first, ++destination)
+      {
+      auto const value = __cpa_reduce_modulo(static_cast<__cpa_iterator_value_t<InputIt>>(*first), modulus);
+      *destination = static_cast<Common>(__cpa_inverse_modulo(value, modulus));
       }
 
-    return right > left ? right : left;
+    return destination;
     }
 
   /**
-   * Get the LCM of two numbers
+   * Calculate the modular multiplicative inverses of all elements of a range
    *
-   * \note \p lhs and \p rhs must have a common type
-   * \note Applications might specialize this function iff at least one of \p Left or \p Right is a user-defined type, otherwise
-   * the program is ill-formed.
+   * Writes the inverse modulo \p modulus of each element of [\p first, \p last) to the range beginning at \p destination.
+   * Using Montgomery's trick, the inversions of a block of elements, each requiring a full extended Euclidean algorithm, are
+   * replaced by one inversion and three modular multiplications per element.
+   *
+   * \note
+   * Like for std::transform, \p destination may be equal to \p first. The same guarantees as for cpa::mod_inverse(Value,
+   * Modulus) apply to each element, and this function will throw an instance of std::domain_error iff \p modulus is not
+   * positive or any element is not invertible. In that case, the contents of the destination range are unspecified.
+   *
+   * \note
+   * The modular multiplications require an integral type of twice the width of the common type of the elements and the
+   * modulus. If there is none, like for 128-bit integers, each element is inverted on its own.
+   *
+   * \return
+   * An iterator past the last element written
    */
-  template<typename Left, typename Right>
-  constexpr std::common_type_t<Left, Right> lcm(Left lhs, Right rhs)
+  template<typename InputIt, typename OutputIt, typename Modulus>
+  OutputIt mod_inverse(InputIt first, InputIt last, OutputIt destination, Modulus modulus)
     {
-    return (lhs / gcd(lhs, rhs)) * rhs;
+    using common_t = std::common_type_t<__cpa_iterator_value_t<InputIt>, Modulus>;
+    using unsigned_t = __cpa_make_unsigned_t<common_t>;
+    using has_wider_t = std::integral_constant<bool, !std::is_void<__cpa_widened_t<unsigned_t>>::value>;
+    static_assert(__cpa_is_binary_gcd_capable<common_t>::value, "mod_inverse requires a non-bool integral type");
+
+    auto const checked = __cpa_checked_modulus(static_cast<common_t>(modulus));
+
+    if(first == last)
+      {
+      return destination;
+      }
+
+    return __cpa_batch_inverse<common_t>(first, last, destination, checked, has_wider_t{});
     }
 
   }
 
+#if defined(__CPA_USE_EXTERN_TEMPLATES)
+#define __CPA_NUMERIC_EXTERN_TEMPLATES(Rep) \
+  __CPA_EXTERN_TEMPLATE Rep gcd<Rep, Rep>(Rep, Rep); \
+  __CPA_EXTERN_TEMPLATE Rep lcm<Rep, Rep>(Rep, Rep);
+
+namespace cpa
+  {
+  __CPA_FOR_EACH_EXTERN_REP(__CPA_NUMERIC_EXTERN_TEMPLATES)
+  }
+
+#undef __CPA_NUMERIC_EXTERN_TEMPLATES
 #endif
 
+#endif
@@ -0,0 +1,234 @@
+#ifndef __CPA__PARALLEL
+#define __CPA__PARALLEL
+
+#include <algorithm.h>
+#include <checked.h>
+#include <rational.h>
+#include <__impl/batch_gcd.h>
+#include <__impl/thread_pool.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * \file parallel.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief Multi-threaded algorithms operating on whole ranges of cpa::basic_rational objects.
+ *
+ * The algorithms in this file split their input range into chunks, which are processed by a work-stealing pool of threads.
+ * The result of each chunk is calculated locally, and the results of the chunks are merged in a balanced tree on the calling
+ * thread. Since rational arithmetic is exact, the results do not depend on the number of threads or on how the work is
+ * distributed among them.
+ */
+
+namespace cpa
+  {
+
+  namespace parallel
+    {
+
+    /*
+     * Ranges are split into chunks of at least this number of elements, but into no more than four chunks per thread.
+     */
+    constexpr std::size_t __cpa_minimum_chunk_size = 4096;
+    constexpr std::size_t __cpa_chunks_per_thread = 4;
+
+    inline unsigned __cpa_default_threads() noexcept
+      {
+      auto const threads = std::thread::hardware_concurrency();
+      return threads ? threads : 1;
+      }
+
+    /*
+     * Apply chunk(first, last) to the chunks of [first, last) in parallel, and merge the results in a balanced tree.
+     */
+    template<typename RandomIt, typename Result, typename Chunk, typename Merge>
+    Result __cpa_parallel_reduce(RandomIt const first, RandomIt const last, Result const & empty, unsigned const threads,
+                                 Chunk const & chunk, Merge const & merge)
+      {
+      auto const size = static_cast<std::size_t>(std::distance(first, last));
+
+      if(!size)
+        {
+        return empty;
+        }
+
+      auto const workers = static_cast<std::size_t>(threads ? threads : 1);
+      auto const by_size = (size + __cpa_minimum_chunk_size - 1) / __cpa_minimum_chunk_size;
+      auto const chunks = std::min(by_size, workers * __cpa_chunks_per_thread);
+      auto partials = std::vector<Result>(chunks, empty);
+
+      __cpa_run_work_stealing(chunks, workers, [&](std::size_t const index)
+        {
+        auto const begin = first + static_cast<std::ptrdiff_t>(index * size / chunks);
+        auto const end = first + static_cast<std::ptrdiff_t>((index + 1) * size / chunks);
+        partials[index] = chunk(begin, end);
+        });
+
+      for(auto count = partials.size(); count > 1; count = (count + 1) / 2)
+        {
+        for(std::size_t position{}; position < count / 2; ++position)
+          {
+          partials[position] = merge(partials[2 * position], partials[2 * position + 1]);
+          }
+
+        if(count % 2)
+          {
+          partials[count / 2] = partials[count - 1];
+          }
+        }
+
+      return partials.front();
+      }
+
+    template<typename Rep, typename Policy>
+    basic_rational<Rep, Policy> __cpa_merge_sum(basic_rational<Rep, Policy> const & lhs, basic_rational<Rep, Policy> const & rhs,
+                                                std::true_type)
+      {
+      return checked_add(lhs, rhs);
+      }
+
+    template<typename Rep, typename Policy>
+    basic_rational<Rep, Policy> __cpa_merge_sum(basic_rational<Rep, Policy> const & lhs, basic_rational<Rep, Policy> const & rhs,
+                                                std::false_type)
+      {
+      return lhs + rhs;
+      }
+
+    template<typename Rep, typename Policy>
+    basic_rational<Rep, Policy> __cpa_merge_product(basic_rational<Rep, Policy> const & lhs,
+                                                    basic_rational<Rep, Policy> const & rhs, std::true_type)
+      {
+      return checked_multiply(lhs, rhs);
+      }
+
+    template<typename Rep, typename Policy>
+    basic_rational<Rep, Policy> __cpa_merge_product(basic_rational<Rep, Policy> const & lhs,
+                                                    basic_rational<Rep, Policy> const & rhs, std::false_type)
+      {
+      return lhs * rhs;
+      }
+
+    /**
+     * Calculate the exact sum of the cpa::basic_rational objects in the range [\p first, \p last) using up to \p threads
+     * threads
+     *
+     * Each chunk is summed like by cpa::sum(InputIt, InputIt), and the sums of the chunks are merged in a balanced tree. If the
+     * representation type is integral, both the partial sums within a chunk and the sums of the chunks are added using
+     * cpa::checked_add, otherwise the regular addition is used.
+     *
+     * \note
+     * If the representation type is integral, this function will throw an instance of std::domain_error iff an intermediate
+     * sum can not be represented. Overflow is detected however the range is split, but since the intermediate sums depend on
+     * the split, a range whose sum is representable may still overflow for some numbers of threads.
+     *
+     * \return
+     * The reduced sum, or 0 if the range is empty.
+     */
+    template<typename RandomIt>
+    typename std::iterator_traits<RandomIt>::value_type sum(RandomIt first, RandomIt last,
+                                                            unsigned const threads = __cpa_default_threads())
+      {
+      using rational_t = typename std::iterator_traits<RandomIt>::value_type;
+
+      auto const merge = [](rational_t const & lhs, rational_t const & rhs)
+        {
+        return __cpa_merge_sum(lhs, rhs, __cpa_is_binary_gcd_capable<typename rational_t::rep>{});
+        };
+
+      return __cpa_parallel_reduce(first, last, rational_t{}, threads,
+                                   [&merge](RandomIt const begin, RandomIt const end)
+                                     {
+                                     return cpa::__cpa_sum(begin, end, merge);
+                                     },
+                                   merge);
+      }
+
+    /**
+     * Calculate the exact product of the cpa::basic_rational objects in the range [\p first, \p last) using up to
+     * \p threads threads
+     *
+     * If the representation type is integral, both the elements of a chunk and the products of the chunks are multiplied
+     * using cpa::checked_multiply, otherwise the regular multiplication is used.
+     *
+     * \note
+     * This function will throw an instance of std::domain_error iff an intermediate product can not be represented.
+     *
+     * \return
+     * The reduced product, or 1 if the range is empty.
+     */
+    template<typename RandomIt>
+    typename std::iterator_traits<RandomIt>::value_type product(RandomIt first, RandomIt last,
+                                                                unsigned const threads = __cpa_default_threads())
+      {
+      using rational_t = typename std::iterator_traits<RandomIt>::value_type;
+      using rep_t = typename rational_t::rep;
+
+      auto result = __cpa_parallel_reduce(first, last, rational_t{__cpa_unchecked{}, rep_t{1}, rep_t{1}, true}, threads,
+                                           [](RandomIt begin, RandomIt const end)
+                                             {
+                                             auto product = *begin;
+
+                                             for(++begin; begin != end; ++begin)
+                                               {
+                                               product = __cpa_merge_product(product, *begin, __cpa_is_binary_gcd_capable<rep_t>{});
+                                               }
+
+                                             return product;
+                                             },
+                                           [](rational_t const & lhs, rational_t const & rhs)
+                                             {
+                                             return __cpa_merge_product(lhs, rhs, __cpa_is_binary_gcd_capable<rep_t>{});
+                                             });
+
+      return result.reduce();
+      }
+
+    /**
+     * Apply \p transform to every element of the range [\p first, \p last) and combine the results and \p init using
+     * \p reduce, using up to \p threads threads
+     *
+     * \note
+     * Like for std::transform_reduce, the order in which the elements are combined is unspecified, so \p reduce must be
+     * associative and commutative. This is the case for the exact arithmetic on cpa::basic_rational.
+     *
+     * \note
+     * If \p transform or \p reduce throw an exception, the first exception thrown is rethrown on the calling thread.
+     */
+    template<typename RandomIt, typename Type, typename Reduce, typename Transform>
+    Type transform_reduce(RandomIt first, RandomIt last, Type init, Reduce reduce, Transform transform,
+                          unsigned const threads = __cpa_default_threads())
+      {
+      if(first == last)
+        {
+        return init;
+        }
+
+      auto const total = __cpa_parallel_reduce(first, last, init, threads,
+                                               [&](RandomIt begin, RandomIt const end)
+                                                 {
+                                                 Type result = transform(*begin);
+
+                                                 for(++begin; begin != end; ++begin)
+                                                   {
+                                                   result = reduce(result, transform(*begin));
+                                                   }
+
+                                                 return result;
+                                                 },
+                                               reduce);
+
+      return reduce(init, total);
+      }
+
+    }
+
+  }
+
+#endif
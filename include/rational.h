@@ -2,8 +2,12 @@
 #define __CPA__RATIONAL
 
 #include <numeric.h>
+#include <__impl/checked.h>
+#include <__impl/extern_templates.h>
 
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <stdexcept>
 #include <type_traits>
 
@@ -25,10 +29,127 @@ namespace cpa
            typename IsIntegralType = std::enable_if_t<std::is_integral<Rep>::value, Rep>>
   struct __rational_constraint { };
 
-  template<typename Rep>
-  struct basic_rational
+  /*
+   * Tag to select the constructor of cpa::basic_rational that does not check the denominator. It is reserved for operations
+   * that can guarantee a non-zero denominator by construction.
+   */
+  struct __cpa_unchecked { };
+
+  /**
+   * Normalization policy for cpa::basic_rational leaving all normalization to the user
+   *
+   * Objects are only ever reduced by explicit calls to cpa::basic_rational::reduce(), which keeps the sign of the denominator.
+   * This policy does not add any state to cpa::basic_rational and is the default policy.
+   */
+  struct manual_normalization
+    {
+    struct state
+      {
+      constexpr bool canonical() const noexcept
+        {
+        return false;
+        }
+
+      constexpr void canonical(bool const) noexcept
+        {
+        }
+      };
+    };
+
+  /**
+   * Normalization policy for cpa::basic_rational reducing objects only when necessary
+   *
+   * Objects track whether they are known to be in canonical form, so that repeated calls to cpa::basic_rational::reduce() are
+   * free. The results of arithmetic operations are only canonicalized if their numerator or denominator exceeds
+   * cpa::lazy_normalization::threshold<Rep>(), or if they have to be compared or printed.
+   */
+  struct lazy_normalization
+    {
+    struct state
+      {
+      constexpr bool canonical() const noexcept
+        {
+        return m_canonical;
+        }
+
+      constexpr void canonical(bool const canonical) noexcept
+        {
+        m_canonical = canonical;
+        }
+
+      private:
+        bool m_canonical{true};
+      };
+
+    /**
+     * Get the magnitude above which the numerator or denominator of a result triggers a reduction
+     *
+     * \note
+     * For bounded types, the product of two values below this threshold can be represented, with one bit to spare. Unbounded
+     * types have no threshold.
+     */
+    template<typename Rep>
+    static constexpr Rep threshold() noexcept
+      {
+      return std::numeric_limits<Rep>::max() >> (std::numeric_limits<Rep>::digits / 2 + 1);
+      }
+
+    /**
+     * Check if the magnitude of \p value exceeds cpa::lazy_normalization::threshold<Rep>()
+     */
+    template<typename Rep>
+    static constexpr bool exceeds_threshold(Rep const & value)
+      {
+      return exceeds_threshold(value, std::integral_constant<bool, std::numeric_limits<Rep>::is_bounded>{});
+      }
+
+    private:
+      template<typename Rep>
+      static constexpr bool exceeds_threshold(Rep const & value, std::true_type)
+        {
+        return value > threshold<Rep>() || (__cpa_is_negative(value) && -threshold<Rep>() > value);
+        }
+
+      template<typename Rep>
+      static constexpr bool exceeds_threshold(Rep const &, std::false_type)
+        {
+        return false;
+        }
+    };
+
+  /**
+   * Normalization policy for cpa::basic_rational keeping objects in canonical form at all times
+   *
+   * An object in canonical form is reduced and has a positive denominator. Operations that would produce a different
+   * representation, like cpa::basic_rational::expand, are canonicalized immediately.
+   */
+  struct eager_normalization
+    {
+    struct state
+      {
+      constexpr bool canonical() const noexcept
+        {
+        return true;
+        }
+
+      constexpr void canonical(bool const) noexcept
+        {
+        }
+      };
+    };
+
+  /**
+   * A rational number with a numerator and a denominator of type \p Rep
+   *
+   * \note
+   * The \p Policy determines when objects are normalized and must be one of cpa::manual_normalization (the default),
+   * cpa::lazy_normalization or cpa::eager_normalization.
+   */
+  template<typename Rep, typename Policy = manual_normalization>
+  struct basic_rational : private Policy::state
     {
     using rep = Rep;
+    using policy = Policy;
 
     /**
      * Construct a cpa::basic_rational representing 0.
@@ -53,21 +174,24 @@ namespace cpa
     constexpr basic_rational(basic_rational const & other) noexcept(std::is_nothrow_copy_constructible<Rep>::value) = default;
 
     /**
-     * Copy construct a cpa::basic_rational from another cpa::basic_rational with a different representation type.
+     * Copy construct a cpa::basic_rational from another cpa::basic_rational with a different representation type or
+     * normalization policy.
      *
      * \note
-     * Just as with cpa::basic_rational::basic_rational(basic_rational const &) no simplications are applied. If the Rep can
-     * not represent the value contained in \p other, the behavior is undefined.
+     * Just as with cpa::basic_rational::basic_rational(basic_rational const &) no simplications are applied, unless required by
+     * the normalization policy. If the Rep can not represent the value contained in \p other, the behavior is undefined.
      *
      * \note
      * This constructor does not throw if Rep is NothrowConstructible with a value of type OtherRep
      */
-    template<typename OtherRep>
-    constexpr basic_rational(basic_rational<OtherRep> const & other) noexcept(std::is_nothrow_constructible<Rep, OtherRep>::value)
-      : m_numerator{other.m_numerator},
-        m_denominator{other.m_denominator}
+    template<typename OtherRep, typename OtherPolicy>
+    constexpr basic_rational(basic_rational<OtherRep, OtherPolicy> const & other)
+      noexcept(std::is_nothrow_constructible<Rep, OtherRep>::value)
+      : m_numerator{static_cast<Rep>(other.numerator())},
+        m_denominator{static_cast<Rep>(other.denominator())}
       {
       static_assert(is_convertible_v<OtherRep, Rep>, "Incompatible types in conversion");
+      settle(other.known_canonical(), Policy{});
       }
 
     /**
@@ -77,7 +201,7 @@ namespace cpa
      * \note
      * This constructor will throw an object of type std::domain_error iff denominator is 0
      */
-    explicit constexpr basic_rational(std::intmax_t const numerator, std::intmax_t const denominator = 1)
+    explicit constexpr basic_rational(rep const numerator, rep const denominator = 1)
       : m_numerator{numerator},
         m_denominator{denominator}
       {
@@ -85,6 +209,16 @@ namespace cpa
         {
         throw std::domain_error{"denominator must not be 0"};
         }
+
+      settle(denominator == rep{1}, Policy{});
+      }
+
+    constexpr basic_rational(__cpa_unchecked, rep const numerator, rep const denominator, bool const reduced = false)
+      noexcept(std::is_nothrow_copy_constructible<Rep>::value)
+      : m_numerator{numerator},
+        m_denominator{denominator}
+      {
+      settle(reduced, Policy{});
       }
 
     /**
@@ -95,7 +229,7 @@ namespace cpa
      */
     explicit constexpr operator bool() const
       {
-      return m_numerator;
+      return static_cast<bool>(m_numerator);
       }
 
     /**
@@ -104,38 +238,142 @@ namespace cpa
      * \note
      * This conversion will most probably loose precission. The maximum precission achievable is dependend of on the compiler.
      *
+     * \note
+     * For a correctly rounded conversion to double or float, see cpa::to_double and cpa::to_float in conversion.h.
+     *
      * \return
      * A value of type long double approximating the value held by the cpa::basic_rational object.
      */
     explicit constexpr operator long double() const
       {
-      return (long double)m_numerator / m_denominator;
+      return static_cast<long double>(m_numerator) / static_cast<long double>(m_denominator);
+      }
+
+    /**
+     * Create an object of type cpa::basic_rational representing the negation of the current object
+     *
+     * \note
+     * This function will not throw if the Rep is NothrowCopyConstructible
+     */
+    constexpr basic_rational operator - () const noexcept(std::is_nothrow_copy_constructible<Rep>::value)
+      {
+      return basic_rational{__cpa_unchecked{}, static_cast<rep>(-m_numerator), m_denominator, known_canonical()};
+      }
+
+    /**
+     * Add \p other to the current object
+     *
+     * \note
+     * See cpa::operator+(basic_rational<LeftRep, Policy> const &, basic_rational<RightRep, Policy> const &) for details. If Rep
+     * can not represent the result, the behavior is undefined.
+     */
+    template<typename OtherRep>
+    basic_rational & operator += (basic_rational<OtherRep, Policy> const & other)
+      {
+      return *this = *this + other;
+      }
+
+    /**
+     * Subtract \p other from the current object
+     *
+     * \note
+     * See cpa::operator-(basic_rational<LeftRep, Policy> const &, basic_rational<RightRep, Policy> const &) for details. If Rep
+     * can not represent the result, the behavior is undefined.
+     */
+    template<typename OtherRep>
+    basic_rational & operator -= (basic_rational<OtherRep, Policy> const & other)
+      {
+      return *this = *this - other;
+      }
+
+    /**
+     * Multiply the current object by \p other
+     *
+     * \note
+     * See cpa::operator*(basic_rational<LeftRep, Policy> const &, basic_rational<RightRep, Policy> const &) for details. If Rep
+     * can not represent the result, the behavior is undefined.
+     *
+     * \note
+     * This function will not throw if Rep is NothrowCopyConstructible
+     */
+    template<typename OtherRep>
+    basic_rational & operator *= (basic_rational<OtherRep, Policy> const & other)
+      noexcept(std::is_nothrow_copy_constructible<Rep>::value)
+      {
+      return *this = *this * other;
+      }
+
+    /**
+     * Divide the current object by \p other
+     *
+     * \note
+     * See cpa::operator/(basic_rational<LeftRep, Policy> const &, basic_rational<RightRep, Policy> const &) for details. If Rep
+     * can not represent the result, the behavior is undefined.
+     *
+     * \note
+     * This function will throw an instance of std::domain_error iff other is equal to 0.
+     */
+    template<typename OtherRep>
+    basic_rational & operator /= (basic_rational<OtherRep, Policy> const & other)
+      {
+      return *this = *this / other;
       }
 
     /**
      * Create an object of type cpa::basic_rational representing a reduction of the current object
+     *
+     * \note
+     * With cpa::manual_normalization, the sign of the denominator is retained. With the other policies, the result is in
+     * canonical form and no work is done if the current object is already known to be canonical.
      */
     constexpr basic_rational reduce() const
       {
+      if(known_canonical())
+        {
+        __CPA_INSTRUMENT(reduce, 0, __cpa_magnitude_bits(*this));
+        return *this;
+        }
+
       auto const gcd = cpa::gcd(m_numerator, m_denominator);
-      auto const numerator = m_numerator / gcd;
-      auto const denominator = m_denominator / gcd;
+      rep const numerator = m_numerator / gcd;
+      rep const denominator = m_denominator / gcd;
 
-      return basic_rational{numerator, denominator};
+      basic_rational const result{__cpa_unchecked{}, numerator, denominator, true};
+      __CPA_INSTRUMENT(reduce, 0, __cpa_magnitude_bits(result));
+      return result;
       }
 
     /**
      * Reduce the current object
+     *
+     * \note
+     * See cpa::basic_rational::reduce() const for the effects of the normalization policy.
      */
     basic_rational & reduce()
       {
-      auto const gcd = cpa::gcd(m_numerator, m_denominator);
-      m_numerator /= gcd;
-      m_denominator /= gcd;
+      if(!known_canonical())
+        {
+        auto const gcd = cpa::gcd(m_numerator, m_denominator);
+        m_numerator /= gcd;
+        m_denominator /= gcd;
+        settle(true, Policy{});
+        }
 
+      __CPA_INSTRUMENT(reduce, 0, __cpa_magnitude_bits(*this));
       return *this;
       }
 
+    /**
+     * Check if the current object is known to be in canonical form
+     *
+     * An object in canonical form is reduced and has a positive denominator. Objects using cpa::manual_normalization never know
+     * if they are in canonical form, while objects using cpa::eager_normalization always are.
+     */
+    constexpr bool known_canonical() const noexcept
+      {
+      return Policy::state::canonical();
+      }
+
     /**
      * Create an object of type cpa::basic_rational representing an expansion to the common denominator of the current object
      * and \p other
@@ -146,7 +384,9 @@ namespace cpa
       auto const numerator = m_numerator * factor;
       auto const denominator = m_denominator * factor;
 
-      return basic_rational{numerator, denominator};
+      basic_rational const result{static_cast<rep>(numerator), static_cast<rep>(denominator)};
+      __CPA_INSTRUMENT(common, 0, __cpa_magnitude_bits(result));
+      return result;
       }
 
     /**
@@ -157,7 +397,9 @@ namespace cpa
       auto const factor = cpa::lcm(m_denominator, other.m_denominator) / m_denominator;
       m_numerator *= factor;
       m_denominator *= factor;
+      settle(factor == rep{1} && known_canonical(), Policy{});
 
+      __CPA_INSTRUMENT(common, 0, __cpa_magnitude_bits(*this));
       return *this;
       }
 
@@ -171,14 +413,16 @@ namespace cpa
      * \note
      * This function will throw an instance of std::domain_error iff factor is equal to 0.
      */
-    constexpr basic_rational expand(std::intmax_t const factor) const
+    constexpr basic_rational expand(rep const factor) const
       {
       if(!factor)
         {
         throw std::domain_error{"expansion by 0 would result in an undefined value"};
         }
 
-      return basic_rational{m_numerator * factor, m_denominator * factor};
+      basic_rational const result{static_cast<rep>(m_numerator * factor), static_cast<rep>(m_denominator * factor)};
+      __CPA_INSTRUMENT(expand, 0, __cpa_magnitude_bits(result));
+      return result;
       }
 
     /**
@@ -190,7 +434,7 @@ namespace cpa
      * \note
      * This function will throw an instance of std::domain_error iff factor is equal to 0.
      */
-    basic_rational & expand(std::intmax_t const factor)
+    basic_rational & expand(rep const factor)
       {
       if(!factor)
         {
@@ -199,7 +443,9 @@ namespace cpa
 
       m_numerator *= factor;
       m_denominator *= factor;
+      settle(false, Policy{});
 
+      __CPA_INSTRUMENT(expand, 0, __cpa_magnitude_bits(*this));
       return *this;
       }
 
@@ -227,36 +473,624 @@ namespace cpa
 
 
     private:
-      rep m_numerator;
-      rep m_denominator;
+      constexpr void settle(bool const, manual_normalization) noexcept
+        {
+        }
+
+      constexpr void settle(bool const reduced, lazy_normalization)
+        {
+        if(reduced)
+          {
+          make_denominator_positive();
+          Policy::state::canonical(true);
+          }
+        else if(lazy_normalization::exceeds_threshold(m_numerator) || lazy_normalization::exceeds_threshold(m_denominator))
+          {
+          canonicalize();
+          }
+        else
+          {
+          Policy::state::canonical(false);
+          }
+        }
+
+      constexpr void settle(bool const reduced, eager_normalization)
+        {
+        if(reduced)
+          {
+          make_denominator_positive();
+          }
+        else
+          {
+          canonicalize();
+          }
+        }
+
+      constexpr void canonicalize()
+        {
+        auto const gcd = cpa::gcd(m_numerator, m_denominator);
+        m_numerator /= gcd;
+        m_denominator /= gcd;
+        make_denominator_positive();
+        Policy::state::canonical(true);
+        }
+
+      constexpr void make_denominator_positive()
+        {
+        if(__cpa_is_negative(m_denominator))
+          {
+          m_numerator = -m_numerator;
+          m_denominator = -m_denominator;
+          }
+        }
+
+      rep m_numerator{};
+      rep m_denominator{1};
     };
 
+  /*
+   * Get the bucket of a cpa::basic_rational object in the magnitude histograms of the instrumentation, which is determined by
+   * the larger magnitude of its numerator and denominator.
+   */
+  template<typename Rep, typename Policy>
+  constexpr int __cpa_magnitude_bits(basic_rational<Rep, Policy> const & value)
+    {
+    auto const numerator = __cpa_magnitude_bits(value.numerator());
+    auto const denominator = __cpa_magnitude_bits(value.denominator());
+    return numerator > denominator ? numerator : denominator;
+    }
+
   /**
    * Calculate the GCD of two cpa::basic_rational objects
    *
    * \note
    * This is a specialization of cpa::gcd found in numeric.h
    */
-  template<typename LeftRep, typename RightRep>
-  constexpr auto gcd(basic_rational<LeftRep> const & lhs, basic_rational<RightRep> const & rhs)
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr auto gcd(basic_rational<LeftRep, Policy> const & lhs, basic_rational<RightRep, Policy> const & rhs)
     {
-    using target_type = basic_rational<std::common_type_t<LeftRep, RightRep>>;
+    using target_type = basic_rational<std::common_type_t<LeftRep, RightRep>, Policy>;
     return target_type{cpa::gcd(lhs.numerator(), rhs.numerator()), cpa::lcm(lhs.denominator(), rhs.denominator())};
     }
 
+  /*
+   * Add (Sign = 1) or subtract (Sign = -1) two fractions using the algorithm described in Knuth, TAOCP Vol. 2, 4.5.1. Only
+   * one full GCD of the denominators is required and all divisions happen before the multiplications, which keeps the
+   * intermediate values small. If both operands are reduced, so is the result.
+   */
+  template<int Sign, typename Rep, typename Policy>
+  constexpr basic_rational<Rep, Policy> __cpa_add(Rep const lhs_numerator, Rep const lhs_denominator,
+                                                  Rep const rhs_numerator, Rep const rhs_denominator,
+                                                  bool const reduced)
+    noexcept(std::is_nothrow_copy_constructible<Rep>::value)
+    {
+    auto const gcd = cpa::gcd(lhs_denominator, rhs_denominator);
+
+    if(gcd == Rep{1})
+      {
+      Rep const numerator = Sign > 0 ? lhs_numerator * rhs_denominator + rhs_numerator * lhs_denominator
+                                     : lhs_numerator * rhs_denominator - rhs_numerator * lhs_denominator;
+      Rep const denominator = lhs_denominator * rhs_denominator;
+      return basic_rational<Rep, Policy>{__cpa_unchecked{}, numerator, denominator, reduced};
+      }
+
+    Rep const lhs_factor = lhs_denominator / gcd;
+    Rep const rhs_factor = rhs_denominator / gcd;
+    Rep const numerator = Sign > 0 ? lhs_numerator * rhs_factor + rhs_numerator * lhs_factor
+                                   : lhs_numerator * rhs_factor - rhs_numerator * lhs_factor;
+    auto const common = cpa::gcd(numerator, gcd);
+    Rep const reduced_numerator = numerator / common;
+    Rep const reduced_denominator = lhs_factor * (rhs_denominator / common);
+
+    return basic_rational<Rep, Policy>{__cpa_unchecked{}, reduced_numerator, reduced_denominator, reduced};
+    }
+
   /**
    * Add two cpa::basic_rational objects
    *
    * \note
-   * No simplifications will be applied to the result.
+   * The result is calculated using only a single GCD of the denominators and a GCD of a small intermediate value. If both
+   * operands are reduced, the result will be reduced as well. If the common representation type can not represent the
+   * result, the behavior is undefined.
+   *
+   * \note
+   * This function will not throw if the common representation type is NothrowCopyConstructible
    */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> operator + (basic_rational<LeftRep, Policy> const & lhs,
+                                                                                      basic_rational<RightRep, Policy> const & rhs)
+    noexcept(std::is_nothrow_copy_constructible<std::common_type_t<LeftRep, RightRep>>::value)
+    {
+    using common_t = std::common_type_t<LeftRep, RightRep>;
+    return __cpa_add<1, common_t, Policy>(lhs.numerator(), lhs.denominator(), rhs.numerator(), rhs.denominator(),
+                                          lhs.known_canonical() && rhs.known_canonical());
+    }
+
+  /**
+   * Subtract two cpa::basic_rational objects
+   *
+   * \note
+   * The same guarantees as for cpa::operator+(basic_rational<LeftRep, Policy> const &, basic_rational<RightRep, Policy> const &)
+   * apply.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> operator - (basic_rational<LeftRep, Policy> const & lhs,
+                                                                                      basic_rational<RightRep, Policy> const & rhs)
+    noexcept(std::is_nothrow_copy_constructible<std::common_type_t<LeftRep, RightRep>>::value)
+    {
+    using common_t = std::common_type_t<LeftRep, RightRep>;
+    return __cpa_add<-1, common_t, Policy>(lhs.numerator(), lhs.denominator(), rhs.numerator(), rhs.denominator(),
+                                           lhs.known_canonical() && rhs.known_canonical());
+    }
+
+  /*
+   * Multiply two fractions, cancelling the GCDs of each numerator and the opposite denominator before multiplying. If both
+   * operands are reduced, so is the result.
+   */
+  template<typename Rep, typename Policy>
+  constexpr basic_rational<Rep, Policy> __cpa_multiply(Rep const lhs_numerator, Rep const lhs_denominator,
+                                                       Rep const rhs_numerator, Rep const rhs_denominator,
+                                                       bool const reduced)
+    noexcept(std::is_nothrow_copy_constructible<Rep>::value)
+    {
+    auto const lhs_gcd = cpa::gcd(lhs_numerator, rhs_denominator);
+    auto const rhs_gcd = cpa::gcd(rhs_numerator, lhs_denominator);
+    Rep const numerator = (lhs_numerator / lhs_gcd) * (rhs_numerator / rhs_gcd);
+    Rep const denominator = (lhs_denominator / rhs_gcd) * (rhs_denominator / lhs_gcd);
+
+    return basic_rational<Rep, Policy>{__cpa_unchecked{}, numerator, denominator, reduced};
+    }
+
+  /**
+   * Multiply two cpa::basic_rational objects
+   *
+   * \note
+   * Common factors of each numerator and the opposite denominator are cancelled before multiplying, which keeps the
+   * intermediate values small. If both operands are reduced, the result will be reduced as well. If the common
+   * representation type can not represent the result, the behavior is undefined.
+   *
+   * \note
+   * This function will not throw if the common representation type is NothrowCopyConstructible
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> operator * (basic_rational<LeftRep, Policy> const & lhs,
+                                                                                      basic_rational<RightRep, Policy> const & rhs)
+    noexcept(std::is_nothrow_copy_constructible<std::common_type_t<LeftRep, RightRep>>::value)
+    {
+    using common_t = std::common_type_t<LeftRep, RightRep>;
+    return __cpa_multiply<common_t, Policy>(lhs.numerator(), lhs.denominator(), rhs.numerator(), rhs.denominator(),
+                                            lhs.known_canonical() && rhs.known_canonical());
+    }
+
+  /**
+   * Divide two cpa::basic_rational objects
+   *
+   * \note
+   * The same guarantees as for cpa::operator*(basic_rational<LeftRep, Policy> const &, basic_rational<RightRep, Policy> const &)
+   * apply.
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff rhs is equal to 0.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr basic_rational<std::common_type_t<LeftRep, RightRep>, Policy> operator / (basic_rational<LeftRep, Policy> const & lhs,
+                                                                                      basic_rational<RightRep, Policy> const & rhs)
+    {
+    using common_t = std::common_type_t<LeftRep, RightRep>;
+
+    if(!rhs)
+      {
+      throw std::domain_error{"division by 0 would result in an undefined value"};
+      }
+
+    return __cpa_multiply<common_t, Policy>(lhs.numerator(), lhs.denominator(), rhs.denominator(), rhs.numerator(),
+                                            lhs.known_canonical() && rhs.known_canonical());
+    }
+
+  template<typename Left, typename Right>
+  constexpr bool __cpa_same_value(Left const & lhs, Right const & rhs, std::true_type) noexcept
+    {
+    return __cpa_is_negative(lhs) == __cpa_is_negative(rhs) && __cpa_magnitude(lhs) == __cpa_magnitude(rhs);
+    }
+
+  template<typename Left, typename Right>
+  constexpr bool __cpa_same_value(Left const & lhs, Right const & rhs, std::false_type)
+    {
+    return lhs == rhs;
+    }
+
+  /*
+   * Compare two values for equality. Integral values are compared by sign and magnitude, so that values of mixed signedness
+   * compare correctly.
+   */
+  template<typename Left, typename Right>
+  constexpr bool __cpa_same_value(Left const & lhs, Right const & rhs)
+    {
+    return __cpa_same_value(lhs, rhs, std::integral_constant<bool, __cpa_is_binary_gcd_capable<Left>::value &&
+                                                                   __cpa_is_binary_gcd_capable<Right>::value>{});
+    }
+
+  /*
+   * Get the numerator and the denominator of the canonical form of value, which is reduced and has a positive denominator. No
+   * GCD is calculated if value is known to be canonical.
+   */
+  template<typename Rep, typename Policy>
+  constexpr void __cpa_canonical_parts(basic_rational<Rep, Policy> const & value, Rep & numerator, Rep & denominator)
+    {
+    numerator = value.numerator();
+    denominator = value.denominator();
+
+    if(value.known_canonical())
+      {
+      return;
+      }
+
+    auto const gcd = cpa::gcd(numerator, denominator);
+    numerator /= gcd;
+    denominator /= gcd;
+
+    if(__cpa_is_negative(denominator))
+      {
+      numerator = -numerator;
+      denominator = -denominator;
+      }
+    }
+
+  /*
+   * The canonical form of a cpa::basic_rational with an integral representation, as its sign and the magnitudes of its reduced
+   * numerator and denominator.
+   */
+  template<typename Unsigned>
+  struct __cpa_canonical_form
+    {
+    bool negative;
+    Unsigned numerator;
+    Unsigned denominator;
+    };
+
+  /*
+   * Get the canonical form of value. Unlike __cpa_canonical_parts, no part is negated, so that this is well-defined if the
+   * denominator is the most negative value of Rep. No GCD is calculated if value is known to be canonical.
+   */
+  template<typename Rep, typename Policy>
+  constexpr __cpa_canonical_form<__cpa_make_unsigned_t<Rep>> __cpa_canonical(basic_rational<Rep, Policy> const & value)
+    {
+    auto numerator = __cpa_magnitude(value.numerator());
+    auto denominator = __cpa_magnitude(value.denominator());
+    auto const negative = numerator && __cpa_is_negative(value.numerator()) != __cpa_is_negative(value.denominator());
+
+    if(!value.known_canonical())
+      {
+      auto const gcd = cpa::gcd(numerator, denominator);
+      numerator /= gcd;
+      denominator /= gcd;
+      }
+
+    return {negative, numerator, denominator};
+    }
+
+  template<typename Rep>
+  constexpr void __cpa_positive_denominator(Rep & numerator, Rep & denominator, std::true_type)
+    {
+    using unsigned_t = __cpa_make_unsigned_t<Rep>;
+
+    if(!__cpa_is_negative(denominator))
+      {
+      return;
+      }
+
+    auto numerator_magnitude = __cpa_magnitude(numerator);
+    auto denominator_magnitude = __cpa_magnitude(denominator);
+    auto const negative = numerator_magnitude && !__cpa_is_negative(numerator);
+    auto const maximum = static_cast<unsigned_t>(__cpa_max_value<Rep>());
+
+    if(numerator_magnitude > maximum || denominator_magnitude > maximum)
+      {
+      auto const gcd = __cpa_binary_gcd(numerator_magnitude, denominator_magnitude);
+      numerator_magnitude /= gcd;
+      denominator_magnitude /= gcd;
+
+      if(denominator_magnitude > maximum || (numerator_magnitude > maximum && !negative))
+        {
+        throw std::domain_error{"value is not representable with a positive denominator"};
+        }
+      }
+
+    numerator = __cpa_apply_sign<Rep>(numerator_magnitude, negative);
+    denominator = static_cast<Rep>(denominator_magnitude);
+    }
+
   template<typename Rep>
-  constexpr auto operator + (basic_rational<Rep> const & lhs, basic_rational<Rep> const & rhs)
+  constexpr void __cpa_positive_denominator(Rep & numerator, Rep & denominator, std::false_type)
+    {
+    if(__cpa_is_negative(denominator))
+      {
+      numerator = -numerator;
+      denominator = -denominator;
+      }
+    }
+
+  /*
+   * Move the sign of a negative denominator to the numerator. Integral parts are negated as magnitudes, and if the most negative
+   * value of Rep is involved, they are divided by their GCD first. This function will throw an instance of std::domain_error
+   * iff the value can not be represented with a positive denominator, like 1 / INT64_MIN.
+   */
+  template<typename Rep>
+  constexpr void __cpa_positive_denominator(Rep & numerator, Rep & denominator)
+    {
+    __cpa_positive_denominator(numerator, denominator, __cpa_is_binary_gcd_capable<Rep>{});
+    }
+
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr bool __cpa_equal(basic_rational<LeftRep, Policy> const & lhs, basic_rational<RightRep, Policy> const & rhs,
+                             std::true_type)
+    {
+    auto const lhs_form = __cpa_canonical(lhs);
+    auto const rhs_form = __cpa_canonical(rhs);
+
+    return lhs_form.negative == rhs_form.negative && lhs_form.numerator == rhs_form.numerator &&
+           lhs_form.denominator == rhs_form.denominator;
+    }
+
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr bool __cpa_equal(basic_rational<LeftRep, Policy> const & lhs, basic_rational<RightRep, Policy> const & rhs,
+                             std::false_type)
+    {
+    LeftRep lhs_numerator{};
+    LeftRep lhs_denominator{};
+    RightRep rhs_numerator{};
+    RightRep rhs_denominator{};
+    __cpa_canonical_parts(lhs, lhs_numerator, lhs_denominator);
+    __cpa_canonical_parts(rhs, rhs_numerator, rhs_denominator);
+
+    return __cpa_same_value(lhs_numerator, rhs_numerator) && __cpa_same_value(lhs_denominator, rhs_denominator);
+    }
+
+  /**
+   * Check if two cpa::basic_rational objects represent the same value
+   *
+   * Objects are equal if their canonical forms are equal, so that for example 2/4, 1/2 and -1/-2 compare equal.
+   *
+   * \note
+   * If the denominators are equal, only the numerators are compared. If both objects are known to be in canonical form,
+   * their parts are compared directly. Otherwise, one GCD is calculated for each object that is not known to be canonical.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr bool operator == (basic_rational<LeftRep, Policy> const & lhs, basic_rational<RightRep, Policy> const & rhs)
+    {
+    if(__cpa_same_value(lhs.denominator(), rhs.denominator()))
+      {
+      return __cpa_same_value(lhs.numerator(), rhs.numerator());
+      }
+
+    return __cpa_equal(lhs, rhs, std::integral_constant<bool, __cpa_is_binary_gcd_capable<LeftRep>::value &&
+                                                              __cpa_is_binary_gcd_capable<RightRep>::value>{});
+    }
+
+  /**
+   * Check if two cpa::basic_rational objects represent different values
+   *
+   * \note
+   * See cpa::operator==(basic_rational<LeftRep, Policy> const &, basic_rational<RightRep, Policy> const &) for details.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr bool operator != (basic_rational<LeftRep, Policy> const & lhs, basic_rational<RightRep, Policy> const & rhs)
+    {
+    return !(lhs == rhs);
+    }
+
+  /*
+   * Compare the non-negative fractions lhs_numerator / lhs_denominator and rhs_numerator / rhs_denominator by cross
+   * multiplication in an integral type of twice the width, returning -1, 0 or 1.
+   */
+  template<typename Unsigned>
+  constexpr int __cpa_compare_magnitudes(Unsigned const lhs_numerator, Unsigned const lhs_denominator,
+                                         Unsigned const rhs_numerator, Unsigned const rhs_denominator, std::false_type) noexcept
+    {
+    using wide_t = __cpa_widened_t<Unsigned>;
+
+    auto const lhs = static_cast<wide_t>(lhs_numerator) * static_cast<wide_t>(rhs_denominator);
+    auto const rhs = static_cast<wide_t>(rhs_numerator) * static_cast<wide_t>(lhs_denominator);
+    return (lhs > rhs) - (lhs < rhs);
+    }
+
+  /*
+   * Compare the non-negative fractions lhs_numerator / lhs_denominator and rhs_numerator / rhs_denominator by expanding them
+   * into continued fractions, until the first partial quotients differ. Only divisions are used, so that no intermediate
+   * value can overflow.
+   */
+  template<typename Unsigned>
+  constexpr int __cpa_compare_magnitudes(Unsigned lhs_numerator, Unsigned lhs_denominator,
+                                         Unsigned rhs_numerator, Unsigned rhs_denominator, std::true_type) noexcept
+    {
+    auto sign = 1;
+
+    while(true)
+      {
+      auto const lhs_quotient = static_cast<Unsigned>(lhs_numerator / lhs_denominator);
+      auto const rhs_quotient = static_cast<Unsigned>(rhs_numerator / rhs_denominator);
+
+      if(lhs_quotient != rhs_quotient)
+        {
+        return lhs_quotient < rhs_quotient ? -sign : sign;
+        }
+
+      auto const lhs_remainder = static_cast<Unsigned>(lhs_numerator % lhs_denominator);
+      auto const rhs_remainder = static_cast<Unsigned>(rhs_numerator % rhs_denominator);
+
+      if(!lhs_remainder || !rhs_remainder)
+        {
+        return sign * ((lhs_remainder != 0) - (rhs_remainder != 0));
+        }
+
+      lhs_numerator = lhs_denominator;
+      lhs_denominator = lhs_remainder;
+      rhs_numerator = rhs_denominator;
+      rhs_denominator = rhs_remainder;
+      sign = -sign;
+      }
+    }
+
+  template<typename Integral>
+  constexpr int __cpa_sign(Integral const numerator, Integral const denominator) noexcept
+    {
+    return !numerator ? 0 : (__cpa_is_negative(numerator) != __cpa_is_negative(denominator) ? -1 : 1);
+    }
+
+  template<typename LeftRep, typename RightRep>
+  constexpr int __cpa_compare(LeftRep const lhs_numerator, LeftRep const lhs_denominator,
+                              RightRep const rhs_numerator, RightRep const rhs_denominator, std::true_type) noexcept
+    {
+    using lhs_unsigned_t = __cpa_make_unsigned_t<LeftRep>;
+    using rhs_unsigned_t = __cpa_make_unsigned_t<RightRep>;
+    using unsigned_t = std::conditional_t<(sizeof(lhs_unsigned_t) >= sizeof(rhs_unsigned_t)), lhs_unsigned_t, rhs_unsigned_t>;
+
+    auto const lhs_sign = __cpa_sign(lhs_numerator, lhs_denominator);
+    auto const rhs_sign = __cpa_sign(rhs_numerator, rhs_denominator);
+
+    if(lhs_sign != rhs_sign || !lhs_sign)
+      {
+      return (lhs_sign > rhs_sign) - (lhs_sign < rhs_sign);
+      }
+
+    return lhs_sign * __cpa_compare_magnitudes<unsigned_t>(__cpa_magnitude(lhs_numerator), __cpa_magnitude(lhs_denominator),
+                                                           __cpa_magnitude(rhs_numerator), __cpa_magnitude(rhs_denominator),
+                                                           std::is_void<__cpa_widened_t<unsigned_t>>{});
+    }
+
+  template<typename LeftRep, typename RightRep>
+  constexpr int __cpa_compare(LeftRep const & lhs_numerator, LeftRep const & lhs_denominator,
+                              RightRep const & rhs_numerator, RightRep const & rhs_denominator, std::false_type)
+    {
+    auto const lhs = lhs_numerator * rhs_denominator;
+    auto const rhs = rhs_numerator * lhs_denominator;
+    auto const order = (rhs < lhs) - (lhs < rhs);
+    return __cpa_is_negative(lhs_denominator) != __cpa_is_negative(rhs_denominator) ? -order : order;
+    }
+
+  /*
+   * Compare the values of two cpa::basic_rational objects, returning -1, 0 or 1. Integral representations are compared by
+   * sign first. Their magnitudes are compared by cross multiplication in a type of twice the width if there is one, and as
+   * continued fractions otherwise. Other representations are compared by plain cross multiplication.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr int __cpa_compare(basic_rational<LeftRep, Policy> const & lhs, basic_rational<RightRep, Policy> const & rhs)
+    {
+    using integral = std::integral_constant<bool, __cpa_is_binary_gcd_capable<LeftRep>::value &&
+                                                  __cpa_is_binary_gcd_capable<RightRep>::value>;
+
+    return __cpa_compare(lhs.numerator(), lhs.denominator(), rhs.numerator(), rhs.denominator(), integral{});
+    }
+
+  /**
+   * Check if the value of \p lhs is less than the value of \p rhs
+   *
+   * \note
+   * The comparison is exact for the full range of the representation types. For integral representations of up to 64
+   * bits, the cross products are calculated in an integral type of twice the width. Wider integral representations are
+   * compared by expanding both values into continued fractions, which can not overflow.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr bool operator < (basic_rational<LeftRep, Policy> const & lhs, basic_rational<RightRep, Policy> const & rhs)
+    {
+    return __cpa_compare(lhs, rhs) < 0;
+    }
+
+  /**
+   * Check if the value of \p lhs is greater than the value of \p rhs
+   *
+   * \note
+   * See cpa::operator<(basic_rational<LeftRep, Policy> const &, basic_rational<RightRep, Policy> const &) for details.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr bool operator > (basic_rational<LeftRep, Policy> const & lhs, basic_rational<RightRep, Policy> const & rhs)
+    {
+    return __cpa_compare(lhs, rhs) > 0;
+    }
+
+  /**
+   * Check if the value of \p lhs is less than or equal to the value of \p rhs
+   *
+   * \note
+   * See cpa::operator<(basic_rational<LeftRep, Policy> const &, basic_rational<RightRep, Policy> const &) for details.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr bool operator <= (basic_rational<LeftRep, Policy> const & lhs, basic_rational<RightRep, Policy> const & rhs)
+    {
+    return __cpa_compare(lhs, rhs) <= 0;
+    }
+
+  /**
+   * Check if the value of \p lhs is greater than or equal to the value of \p rhs
+   *
+   * \note
+   * See cpa::operator<(basic_rational<LeftRep, Policy> const &, basic_rational<RightRep, Policy> const &) for details.
+   */
+  template<typename LeftRep, typename RightRep, typename Policy>
+  constexpr bool operator >= (basic_rational<LeftRep, Policy> const & lhs, basic_rational<RightRep, Policy> const & rhs)
+    {
+    return __cpa_compare(lhs, rhs) >= 0;
+    }
+
+  /**
+   * A cpa::basic_rational is signed iff its representation type is signed
+   */
+  template<typename Rep, typename Policy>
+  constexpr bool is_signed_v<basic_rational<Rep, Policy>> = is_signed_v<Rep> || __cpa_is_signed_integral<Rep>::value;
+
+  /*
+   * Mix the bits of an integral value into a well distributed hash, using the finalizer of SplitMix64. 128-bit values are
+   * folded into 64 bits first.
+   */
+  template<typename Integral>
+  constexpr std::uint64_t __cpa_hash_value(Integral const & value, std::true_type) noexcept
     {
-    auto const & cl = lhs.common(rhs);
-    auto const & cr = rhs.common(lhs);
+    using unsigned_t = __cpa_make_unsigned_t<Integral>;
 
-    return basic_rational<Rep>{cl.numerator() + cr.numerator(), cl.denominator()};
+    auto const bits = static_cast<unsigned_t>(value);
+    auto mixed = static_cast<std::uint64_t>(bits) ^ static_cast<std::uint64_t>(bits >> 16 >> 16 >> 16 >> 16);
+    mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ull;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebull;
+    return mixed ^ (mixed >> 31);
+    }
+
+  template<typename Type>
+  std::uint64_t __cpa_hash_value(Type const & value, std::false_type)
+    {
+    return std::hash<Type>{}(value);
+    }
+
+  template<typename Type>
+  std::uint64_t __cpa_hash_value(Type const & value)
+    {
+    return __cpa_hash_value(value, __cpa_is_binary_gcd_capable<Type>{});
+    }
+
+  /*
+   * Hash the canonical form of value. For integral representations, the numerator is hashed as the bits of its signed value,
+   * so that the hash is the same as for the canonical parts whenever those are representable.
+   */
+  template<typename Rep, typename Policy>
+  std::uint64_t __cpa_hash_rational(basic_rational<Rep, Policy> const & value, std::true_type) noexcept
+    {
+    using unsigned_t = __cpa_make_unsigned_t<Rep>;
+
+    auto const form = __cpa_canonical(value);
+    auto const numerator = form.negative ? static_cast<unsigned_t>(unsigned_t{0} - form.numerator) : form.numerator;
+
+    auto const seed = __cpa_hash_value(numerator);
+    return seed ^ (__cpa_hash_value(form.denominator) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+
+  template<typename Rep, typename Policy>
+  std::uint64_t __cpa_hash_rational(basic_rational<Rep, Policy> const & value, std::false_type)
+    {
+    Rep numerator{};
+    Rep denominator{};
+    __cpa_canonical_parts(value, numerator, denominator);
+
+    auto const seed = __cpa_hash_value(numerator);
+    return seed ^ (__cpa_hash_value(denominator) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
     }
 
   /*
@@ -266,4 +1100,64 @@ namespace cpa
 
   }
 
+namespace std
+  {
+
+  /**
+   * Specialization of std::hash for cpa::basic_rational
+   *
+   * The hash is calculated from the canonical form, so that objects comparing equal have equal hashes.
+   *
+   * \note
+   * No GCD is calculated for objects known to be in canonical form. Keys using cpa::eager_normalization or reduced keys using
+   * cpa::lazy_normalization are therefore hashed without any division. If Rep is not an integral type, std::hash<Rep> is used
+   * to hash the parts.
+   */
+  template<typename Rep, typename Policy>
+  struct hash<cpa::basic_rational<Rep, Policy>>
+    {
+    std::size_t operator()(cpa::basic_rational<Rep, Policy> const & value) const
+      {
+      return static_cast<std::size_t>(cpa::__cpa_hash_rational(value, cpa::__cpa_is_binary_gcd_capable<Rep>{}));
+      }
+    };
+
+  }
+
+#if defined(__CPA_USE_EXTERN_TEMPLATES)
+#define __CPA_RATIONAL_EXTERN_TEMPLATES(Rep) \
+  __CPA_EXTERN_TEMPLATE struct basic_rational<Rep>; \
+  __CPA_EXTERN_TEMPLATE basic_rational<Rep> & basic_rational<Rep>::operator += <Rep>(basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE basic_rational<Rep> & basic_rational<Rep>::operator -= <Rep>(basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE basic_rational<Rep> & basic_rational<Rep>::operator *= <Rep>(basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE basic_rational<Rep> & basic_rational<Rep>::operator /= <Rep>(basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE basic_rational<Rep> operator + <Rep, Rep, manual_normalization>( \
+      basic_rational<Rep> const &, basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE basic_rational<Rep> operator - <Rep, Rep, manual_normalization>( \
+      basic_rational<Rep> const &, basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE basic_rational<Rep> operator * <Rep, Rep, manual_normalization>( \
+      basic_rational<Rep> const &, basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE basic_rational<Rep> operator / <Rep, Rep, manual_normalization>( \
+      basic_rational<Rep> const &, basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE bool operator == <Rep, Rep, manual_normalization>( \
+      basic_rational<Rep> const &, basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE bool operator != <Rep, Rep, manual_normalization>( \
+      basic_rational<Rep> const &, basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE bool operator < <Rep, Rep, manual_normalization>( \
+      basic_rational<Rep> const &, basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE bool operator > <Rep, Rep, manual_normalization>( \
+      basic_rational<Rep> const &, basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE bool operator <= <Rep, Rep, manual_normalization>( \
+      basic_rational<Rep> const &, basic_rational<Rep> const &); \
+  __CPA_EXTERN_TEMPLATE bool operator >= <Rep, Rep, manual_normalization>( \
+      basic_rational<Rep> const &, basic_rational<Rep> const &);
+
+namespace cpa
+  {
+  __CPA_FOR_EACH_EXTERN_REP(__CPA_RATIONAL_EXTERN_TEMPLATES)
+  }
+
+#undef __CPA_RATIONAL_EXTERN_TEMPLATES
+#endif
+
 #endif
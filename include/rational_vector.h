@@ -0,0 +1,527 @@
+#ifndef __CPA__RATIONAL_VECTOR
+#define __CPA__RATIONAL_VECTOR
+
+#include <rational.h>
+#include <__impl/aligned_allocator.h>
+#include <__impl/batch_gcd.h>
+#include <__impl/checked.h>
+#include <__impl/numeric.h>
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/**
+ * \file rational_vector.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief A sequence container storing cpa::basic_rational objects as a structure of arrays.
+ */
+
+namespace cpa
+  {
+
+  /**
+   * A sequence of rational numbers, storing the numerators and the denominators in two separate arrays
+   *
+   * Both arrays are aligned to cpa::rational_vector::alignment bytes, so that loops scanning only numerators or only
+   * denominators can be vectorized. Elements are accessed through proxy objects converting to and from
+   * cpa::basic_rational<Rep, Policy>.
+   *
+   * A cpa::rational_vector can record that all of its elements share a common (positive) denominator, in which case only the
+   * numerators are stored. In this mode, adding a scalar with the same denominator and scaling by a scalar are plain integer
+   * operations on the numerators.
+   *
+   * \note
+   * If Rep can not represent the result of an operation, the behavior is undefined.
+   */
+  template<typename Rep, typename Policy = manual_normalization>
+  struct rational_vector
+    {
+    using rep = Rep;
+    using policy = Policy;
+    using value_type = basic_rational<Rep, Policy>;
+    using size_type = std::size_t;
+
+    static constexpr std::size_t alignment = 64;
+
+    /**
+     * Proxy for an element of a cpa::rational_vector
+     */
+    struct reference
+      {
+      operator value_type() const
+        {
+        return m_container->get(m_index);
+        }
+
+      rep numerator() const
+        {
+        return m_container->m_numerators[m_index];
+        }
+
+      rep denominator() const
+        {
+        return m_container->denominator_at(m_index);
+        }
+
+      reference & operator = (value_type const & value)
+        {
+        m_container->set(m_index, value);
+        return *this;
+        }
+
+      reference & operator = (reference const & other)
+        {
+        return *this = static_cast<value_type>(other);
+        }
+
+      private:
+        friend rational_vector;
+
+        reference(rational_vector * const container, size_type const index) noexcept
+          : m_container{container},
+            m_index{index}
+          {
+          }
+
+        rational_vector * m_container;
+        size_type m_index;
+      };
+
+    /**
+     * Construct an empty cpa::rational_vector
+     */
+    rational_vector() = default;
+
+    size_type size() const noexcept
+      {
+      return m_numerators.size();
+      }
+
+    bool empty() const noexcept
+      {
+      return m_numerators.empty();
+      }
+
+    void reserve(size_type const capacity)
+      {
+      m_numerators.reserve(capacity);
+
+      if(!m_common)
+        {
+        m_denominators.reserve(capacity);
+        }
+      }
+
+    void clear() noexcept
+      {
+      m_numerators.clear();
+      m_denominators.clear();
+      m_common = false;
+      }
+
+    /**
+     * Append \p value to the end of the container
+     *
+     * \note
+     * If the container records a common denominator different from the denominator of \p value, it stops doing so.
+     */
+    void push_back(value_type const & value)
+      {
+      if(m_common && !(value.denominator() == m_denominator))
+        {
+        materialize();
+        }
+
+      m_numerators.push_back(value.numerator());
+
+      if(!m_common)
+        {
+        m_denominators.push_back(value.denominator());
+        }
+      }
+
+    reference operator [] (size_type const index) noexcept
+      {
+      return reference{this, index};
+      }
+
+    value_type operator [] (size_type const index) const
+      {
+      return get(index);
+      }
+
+    /**
+     * Get a pointer to the aligned array of numerators
+     */
+    rep const * numerators() const noexcept
+      {
+      return m_numerators.data();
+      }
+
+    /**
+     * Get a pointer to the aligned array of denominators
+     *
+     * \note
+     * If the container records a common denominator, the denominators are not stored and the returned pointer must not be
+     * dereferenced.
+     */
+    rep const * denominators() const noexcept
+      {
+      return m_denominators.data();
+      }
+
+    /**
+     * Check if the container records a common denominator
+     */
+    bool has_common_denominator() const noexcept
+      {
+      return m_common;
+      }
+
+    /**
+     * Get the common denominator of all elements
+     *
+     * \note
+     * This function will throw an instance of std::domain_error iff the container does not record a common denominator.
+     */
+    rep common_denominator() const
+      {
+      if(!m_common)
+        {
+        throw std::domain_error{"rational_vector does not have a common denominator"};
+        }
+
+      return m_denominator;
+      }
+
+    /**
+     * Expand all elements to the positive LCM of their denominators and record it as the common denominator
+     *
+     * \note
+     * This function will throw an instance of std::domain_error iff an element can not be represented with a positive
+     * denominator, like 1 / INT64_MIN.
+     */
+    void unify_denominators()
+      {
+      if(m_common)
+        {
+        return;
+        }
+
+      auto common = rep{1};
+
+      for(size_type index{}; index < size(); ++index)
+        {
+        __cpa_positive_denominator(m_numerators[index], m_denominators[index]);
+        common = cpa::lcm(common, m_denominators[index]);
+        }
+
+      for(size_type index{}; index < size(); ++index)
+        {
+        m_numerators[index] *= common / m_denominators[index];
+        }
+
+      m_denominators.clear();
+      m_denominators.shrink_to_fit();
+      m_denominator = common;
+      m_common = true;
+      }
+
+    /**
+     * Reduce every element
+     *
+     * The effect is the same as calling cpa::basic_rational::reduce() on each element. If the container records a common
+     * denominator, it stops doing so.
+     *
+     * \note
+     * If Rep is an integral type of at most 64 bits, the GCDs are calculated in batches, using the same vectorized
+     * implementation as cpa::gcd(InputIt1, InputIt1, InputIt2, OutputIt).
+     */
+    void reduce()
+      {
+      materialize();
+      reduce(__cpa_is_batch_gcd_capable<rep>{});
+      }
+
+    /**
+     * Add \p value to every element
+     *
+     * \note
+     * If the container records a common denominator, it is replaced by its LCM with the denominator of \p value and the
+     * container continues to record it. If the denominators are equal, only the numerators are added.
+     *
+     * \note
+     * This function will throw an instance of std::domain_error iff \p value can not be represented with a positive
+     * denominator, like 1 / INT64_MIN.
+     */
+    rational_vector & add(value_type const & value)
+      {
+      auto numerator = value.numerator();
+      auto denominator = value.denominator();
+
+      __cpa_positive_denominator(numerator, denominator);
+
+      if(m_common)
+        {
+        auto const gcd = cpa::gcd(m_denominator, denominator);
+        rep const factor = denominator / gcd;
+        rep const addend = numerator * (m_denominator / gcd);
+
+        if(factor == rep{1})
+          {
+          for(auto & element : m_numerators)
+            {
+            element += addend;
+            }
+          }
+        else
+          {
+          for(auto & element : m_numerators)
+            {
+            element = element * factor + addend;
+            }
+
+          m_denominator *= factor;
+          }
+
+        return *this;
+        }
+
+      for(size_type index{}; index < size(); ++index)
+        {
+        store(index, __cpa_add<1, rep, policy>(m_numerators[index], m_denominators[index], numerator, denominator, false));
+        }
+
+      return *this;
+      }
+
+    /**
+     * Add the elements of \p other to the corresponding elements of the current container
+     *
+     * \note
+     * If both containers record a common denominator, so does the result, and the elements are added as integers.
+     *
+     * \note
+     * This function will throw an instance of std::domain_error iff the sizes of the containers differ.
+     */
+    rational_vector & add(rational_vector const & other)
+      {
+      if(size() != other.size())
+        {
+        throw std::domain_error{"rational_vector sizes must match"};
+        }
+
+      if(m_common && other.m_common)
+        {
+        auto const gcd = cpa::gcd(m_denominator, other.m_denominator);
+        rep const factor = other.m_denominator / gcd;
+        rep const other_factor = m_denominator / gcd;
+
+        for(size_type index{}; index < size(); ++index)
+          {
+          m_numerators[index] = m_numerators[index] * factor + other.m_numerators[index] * other_factor;
+          }
+
+        m_denominator *= factor;
+        return *this;
+        }
+
+      materialize();
+
+      for(size_type index{}; index < size(); ++index)
+        {
+        store(index, __cpa_add<1, rep, policy>(m_numerators[index], m_denominators[index], other.m_numerators[index],
+                                                other.denominator_at(index), false));
+        }
+
+      return *this;
+      }
+
+    /**
+     * Multiply every element by \p factor
+     *
+     * \note
+     * If the container records a common denominator, it is multiplied by the denominator of \p factor, and only the
+     * numerators are multiplied by the numerator of \p factor.
+     *
+     * \note
+     * This function will throw an instance of std::domain_error iff \p factor can not be represented with a positive
+     * denominator, like 1 / INT64_MIN.
+     */
+    rational_vector & scale(value_type const & factor)
+      {
+      auto numerator = factor.numerator();
+      auto denominator = factor.denominator();
+
+      __cpa_positive_denominator(numerator, denominator);
+
+      if(m_common)
+        {
+        for(auto & element : m_numerators)
+          {
+          element *= numerator;
+          }
+
+        m_denominator *= denominator;
+        return *this;
+        }
+
+      for(size_type index{}; index < size(); ++index)
+        {
+        store(index, __cpa_multiply<rep, policy>(m_numerators[index], m_denominators[index], numerator, denominator, false));
+        }
+
+      return *this;
+      }
+
+    /**
+     * Compare every element with \p value
+     *
+     * Writes -1, 0 or 1 to the range beginning at \p destination, depending on whether the corresponding element is less than,
+     * equal to or greater than \p value.
+     *
+     * \note
+     * The comparison is exact, like the comparison operators of cpa::basic_rational. Elements with the same denominator as
+     * \p value are compared by their numerators.
+     *
+     * \return
+     * An iterator past the last element written
+     */
+    template<typename OutputIt>
+    OutputIt compare(value_type const & value, OutputIt destination) const
+      {
+      using integral = std::integral_constant<bool, __cpa_is_binary_gcd_capable<rep>::value>;
+
+      auto const numerator = value.numerator();
+      auto const denominator = value.denominator();
+
+      for(size_type index{}; index < size(); ++index, ++destination)
+        {
+        auto const element_denominator = denominator_at(index);
+
+        if(element_denominator == denominator)
+          {
+          auto const element_numerator = m_numerators[index];
+          auto const order = (element_numerator > numerator) - (element_numerator < numerator);
+          *destination = __cpa_is_negative(denominator) ? -order : order;
+          continue;
+          }
+
+        *destination = __cpa_compare(m_numerators[index], element_denominator, numerator, denominator, integral{});
+        }
+
+      return destination;
+      }
+
+    private:
+      using storage_t = std::vector<rep, __cpa_aligned_allocator<rep, alignment>>;
+
+      rep denominator_at(size_type const index) const
+        {
+        return m_common ? m_denominator : m_denominators[index];
+        }
+
+      value_type get(size_type const index) const
+        {
+        return value_type{__cpa_unchecked{}, m_numerators[index], denominator_at(index)};
+        }
+
+      void set(size_type const index, value_type const & value)
+        {
+        if(m_common && !(value.denominator() == m_denominator))
+          {
+          materialize();
+          }
+
+        m_numerators[index] = value.numerator();
+
+        if(!m_common)
+          {
+          m_denominators[index] = value.denominator();
+          }
+        }
+
+      void store(size_type const index, value_type const & value)
+        {
+        m_numerators[index] = value.numerator();
+        m_denominators[index] = value.denominator();
+        }
+
+      /*
+       * Stop recording a common denominator, storing it for every element instead.
+       */
+      void materialize()
+        {
+        if(m_common)
+          {
+          m_denominators.assign(size(), m_denominator);
+          m_common = false;
+          }
+        }
+
+      void reduce(std::true_type)
+        {
+        using lane_t = __cpa_gcd_lane_t<rep>;
+
+        lane_t numerators[__cpa_gcd_batch_size];
+        lane_t denominators[__cpa_gcd_batch_size];
+
+        for(size_type first{}; first < size(); first += __cpa_gcd_batch_size)
+          {
+          auto const count = size() - first < __cpa_gcd_batch_size ? size() - first : __cpa_gcd_batch_size;
+
+          for(size_type index{}; index < count; ++index)
+            {
+            numerators[index] = __cpa_magnitude(m_numerators[first + index]);
+            denominators[index] = __cpa_magnitude(m_denominators[first + index]);
+            }
+
+          __cpa_gcd_lanes(numerators, denominators, count);
+
+          for(size_type index{}; index < count; ++index)
+            {
+            auto const gcd = static_cast<rep>(numerators[index]);
+            m_numerators[first + index] /= gcd;
+            m_denominators[first + index] /= gcd;
+            __CPA_INSTRUMENT(reduce, 0, magnitude_bits(first + index));
+            }
+          }
+        }
+
+      void reduce(std::false_type)
+        {
+        for(size_type index{}; index < size(); ++index)
+          {
+          auto const gcd = cpa::gcd(m_numerators[index], m_denominators[index]);
+          m_numerators[index] /= gcd;
+          m_denominators[index] /= gcd;
+          __CPA_INSTRUMENT(reduce, 0, magnitude_bits(index));
+          }
+        }
+
+      /*
+       * Get the bucket of the element at index in the magnitude histograms of the instrumentation
+       */
+      int magnitude_bits(size_type const index) const
+        {
+        auto const numerator = __cpa_magnitude_bits(m_numerators[index]);
+        auto const denominator = __cpa_magnitude_bits(m_denominators[index]);
+        return numerator > denominator ? numerator : denominator;
+        }
+
+      storage_t m_numerators{};
+      storage_t m_denominators{};
+      rep m_denominator{1};
+      bool m_common{};
+    };
+
+  template<typename Rep, typename Policy>
+  constexpr std::size_t rational_vector<Rep, Policy>::alignment;
+
+  }
+
+#endif
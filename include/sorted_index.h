@@ -0,0 +1,154 @@
+#ifndef __CPA__SORTED_INDEX
+#define __CPA__SORTED_INDEX
+
+#include <algorithm.h>
+#include <conversion.h>
+#include <rational.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/**
+ * \file sorted_index.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief A flat, sorted and immutable sequence of cpa::basic_rational objects supporting fast lookups.
+ */
+
+namespace cpa
+  {
+
+  /**
+   * A sorted sequence of cpa::basic_rational objects, stored in a contiguous array
+   *
+   * Next to every element, its correctly rounded double is stored in a separate array. Lookups first perform a binary search
+   * on the array of doubles, which only involves floating point comparisons. Only the elements whose double is equal to the
+   * double of the key are then searched using the exact comparison.
+   *
+   * \note
+   * Rep must be an integral type.
+   */
+  template<typename Rep, typename Policy = manual_normalization>
+  struct sorted_index
+    {
+    using rep = Rep;
+    using policy = Policy;
+    using value_type = basic_rational<Rep, Policy>;
+    using size_type = std::size_t;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    static_assert(__cpa_is_binary_gcd_capable<Rep>::value, "sorted_index requires an integral representation type");
+
+    /**
+     * Construct an empty cpa::sorted_index
+     */
+    sorted_index() = default;
+
+    /**
+     * Construct a cpa::sorted_index holding the elements of the range [\p first, \p last)
+     *
+     * \note
+     * The elements are sorted using cpa::sort(RandomIt, RandomIt).
+     */
+    template<typename InputIt>
+    sorted_index(InputIt first, InputIt last)
+      : m_values(first, last)
+      {
+      cpa::sort(m_values.begin(), m_values.end());
+      m_keys.reserve(m_values.size());
+
+      for(auto const & value : m_values)
+        {
+        m_keys.push_back(cpa::to_double(value));
+        }
+      }
+
+    size_type size() const noexcept
+      {
+      return m_values.size();
+      }
+
+    bool empty() const noexcept
+      {
+      return m_values.empty();
+      }
+
+    const_iterator begin() const noexcept
+      {
+      return m_values.begin();
+      }
+
+    const_iterator end() const noexcept
+      {
+      return m_values.end();
+      }
+
+    value_type const & operator [] (size_type const index) const noexcept
+      {
+      return m_values[index];
+      }
+
+    /**
+     * Find the first element that is not less than \p key
+     *
+     * \return
+     * An iterator to the first element whose value is not less than the value of \p key, or end() if there is no such element.
+     */
+    template<typename OtherRep>
+    const_iterator lower_bound(basic_rational<OtherRep, Policy> const & key) const
+      {
+      auto const run = candidates(key);
+      return std::lower_bound(run.first, run.second, key);
+      }
+
+    /**
+     * Find the first element that is greater than \p key
+     *
+     * \return
+     * An iterator to the first element whose value is greater than the value of \p key, or end() if there is no such element.
+     */
+    template<typename OtherRep>
+    const_iterator upper_bound(basic_rational<OtherRep, Policy> const & key) const
+      {
+      auto const run = candidates(key);
+      return std::upper_bound(run.first, run.second, key);
+      }
+
+    /**
+     * Find an element with the same value as \p key
+     *
+     * \return
+     * An iterator to an element whose value is equal to the value of \p key, or end() if there is no such element.
+     */
+    template<typename OtherRep>
+    const_iterator find(basic_rational<OtherRep, Policy> const & key) const
+      {
+      auto const found = lower_bound(key);
+      return found != end() && *found == key ? found : end();
+      }
+
+    private:
+      /*
+       * Get the elements whose double is equal to the double of key. Since the conversion to double preserves the order, all
+       * elements before them are less than key and all elements after them are greater than key.
+       */
+      template<typename OtherRep>
+      std::pair<const_iterator, const_iterator> candidates(basic_rational<OtherRep, Policy> const & key) const
+        {
+        auto const approximation = cpa::to_double(key);
+        auto const keys = std::equal_range(m_keys.begin(), m_keys.end(), approximation);
+
+        return {begin() + (keys.first - m_keys.begin()), begin() + (keys.second - m_keys.begin())};
+        }
+
+      std::vector<value_type> m_values{};
+      std::vector<double> m_keys{};
+    };
+
+  }
+
+#endif
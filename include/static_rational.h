@@ -0,0 +1,409 @@
+#ifndef __CPA__STATIC_RATIONAL
+#define __CPA__STATIC_RATIONAL
+
+#include <rational.h>
+#include <__impl/checked.h>
+#include <__impl/numeric.h>
+
+#include <cstdint>
+#include <ratio>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * \file static_rational.h
+ * \author Felix Morgner
+ * \copyright 3-Clause-BSD
+ *
+ * \brief Rational constants that are reduced at compile time.
+ *
+ * A cpa::static_rational encodes its value in its type, much like std::ratio. All arithmetic between cpa::static_rational
+ * objects happens at compile time, and overflows are diagnosed by the compiler. Arithmetic between a cpa::basic_rational and
+ * a cpa::static_rational uses the fact that the constant is known to be in canonical form, and replaces the GCDs involving
+ * the constant by a remainder of a constant divisor, which compilers implement without a division.
+ */
+
+namespace cpa
+  {
+
+  /**
+   * A rational constant with the value \p Numerator / \p Denominator
+   *
+   * The value is reduced and the sign is moved to the numerator at compile time, so that cpa::static_rational<2, -4> and
+   * cpa::static_rational<-1, 2> name the same value. The member \p type names the canonical specialization.
+   *
+   * \note
+   * A \p Denominator of 0 is rejected at compile time.
+   */
+  template<std::intmax_t Numerator, std::intmax_t Denominator = 1>
+  struct static_rational
+    {
+    static_assert(Denominator != 0, "denominator must not be 0");
+
+    private:
+      static constexpr std::intmax_t gcd = cpa::gcd(Numerator, Denominator);
+      static constexpr std::intmax_t sign = Denominator < 0 ? -1 : 1;
+
+    public:
+      static constexpr std::intmax_t num = sign * (Numerator / gcd);
+      static constexpr std::intmax_t den = sign * (Denominator / gcd);
+
+      using type = static_rational<num, den>;
+      using ratio = std::ratio<num, den>;
+
+      /**
+       * Get the numerator of the reduced value
+       */
+      static constexpr std::intmax_t numerator() noexcept
+        {
+        return num;
+        }
+
+      /**
+       * Get the (always positive) denominator of the reduced value
+       */
+      static constexpr std::intmax_t denominator() noexcept
+        {
+        return den;
+        }
+
+      /**
+       * Convert a cpa::static_rational to a cpa::basic_rational
+       *
+       * \note
+       * The conversion neither checks the denominator nor calculates a GCD. If \p Rep can not represent the numerator or the
+       * denominator, the behavior is undefined.
+       */
+      template<typename Rep, typename Policy>
+      constexpr operator basic_rational<Rep, Policy>() const noexcept(std::is_nothrow_copy_constructible<Rep>::value)
+        {
+        return basic_rational<Rep, Policy>{__cpa_unchecked{}, static_cast<Rep>(num), static_cast<Rep>(den), true};
+        }
+    };
+
+  template<std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr std::intmax_t static_rational<Numerator, Denominator>::gcd;
+
+  template<std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr std::intmax_t static_rational<Numerator, Denominator>::sign;
+
+  template<std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr std::intmax_t static_rational<Numerator, Denominator>::num;
+
+  template<std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr std::intmax_t static_rational<Numerator, Denominator>::den;
+
+  /**
+   * Alias for the cpa::static_rational with the same value as the std::ratio specialization \p Ratio
+   */
+  template<typename Ratio>
+  using static_rational_from_ratio = typename static_rational<Ratio::num, Ratio::den>::type;
+
+  /*
+   * Arithmetic helpers for compile-time evaluation. An overflow makes the expression non-constant, which turns it into a
+   * compile-time error when used in a template argument.
+   */
+  constexpr std::intmax_t __cpa_static_add(std::intmax_t const lhs, std::intmax_t const rhs)
+    {
+    std::intmax_t result{};
+    return __cpa_add_overflow(lhs, rhs, result) ? throw std::domain_error{"overflow in static_rational arithmetic"} : result;
+    }
+
+  constexpr std::intmax_t __cpa_static_multiply(std::intmax_t const lhs, std::intmax_t const rhs)
+    {
+    std::intmax_t result{};
+    return __cpa_multiply_overflow(lhs, rhs, result) ? throw std::domain_error{"overflow in static_rational arithmetic"} : result;
+    }
+
+  template<typename Lhs, typename Rhs>
+  struct __cpa_static_sum
+    {
+    static constexpr std::intmax_t gcd = cpa::gcd(Lhs::den, Rhs::den);
+    using type = typename static_rational<__cpa_static_add(__cpa_static_multiply(Lhs::num, Rhs::den / gcd),
+                                                           __cpa_static_multiply(Rhs::num, Lhs::den / gcd)),
+                                          __cpa_static_multiply(Lhs::den, Rhs::den / gcd)>::type;
+    };
+
+  template<typename Lhs, typename Rhs>
+  struct __cpa_static_product
+    {
+    static constexpr std::intmax_t lhs_gcd = cpa::gcd(Lhs::num, Rhs::den);
+    static constexpr std::intmax_t rhs_gcd = cpa::gcd(Rhs::num, Lhs::den);
+    using type = typename static_rational<__cpa_static_multiply(Lhs::num / lhs_gcd, Rhs::num / rhs_gcd),
+                                          __cpa_static_multiply(Lhs::den / rhs_gcd, Rhs::den / lhs_gcd)>::type;
+    };
+
+  template<std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr typename static_rational<-static_rational<Numerator, Denominator>::num, static_rational<Numerator, Denominator>::den>::type
+  operator - (static_rational<Numerator, Denominator>) noexcept
+    {
+    return {};
+    }
+
+  /**
+   * Add two cpa::static_rational objects at compile time
+   */
+  template<std::intmax_t LeftNumerator, std::intmax_t LeftDenominator, std::intmax_t RightNumerator, std::intmax_t RightDenominator>
+  constexpr typename __cpa_static_sum<static_rational<LeftNumerator, LeftDenominator>, static_rational<RightNumerator, RightDenominator>>::type
+  operator + (static_rational<LeftNumerator, LeftDenominator>, static_rational<RightNumerator, RightDenominator>) noexcept
+    {
+    return {};
+    }
+
+  /**
+   * Subtract two cpa::static_rational objects at compile time
+   */
+  template<std::intmax_t LeftNumerator, std::intmax_t LeftDenominator, std::intmax_t RightNumerator, std::intmax_t RightDenominator>
+  constexpr typename __cpa_static_sum<static_rational<LeftNumerator, LeftDenominator>,
+                                      decltype(-static_rational<RightNumerator, RightDenominator>{})>::type
+  operator - (static_rational<LeftNumerator, LeftDenominator>, static_rational<RightNumerator, RightDenominator>) noexcept
+    {
+    return {};
+    }
+
+  /**
+   * Multiply two cpa::static_rational objects at compile time
+   */
+  template<std::intmax_t LeftNumerator, std::intmax_t LeftDenominator, std::intmax_t RightNumerator, std::intmax_t RightDenominator>
+  constexpr typename __cpa_static_product<static_rational<LeftNumerator, LeftDenominator>,
+                                          static_rational<RightNumerator, RightDenominator>>::type
+  operator * (static_rational<LeftNumerator, LeftDenominator>, static_rational<RightNumerator, RightDenominator>) noexcept
+    {
+    return {};
+    }
+
+  /**
+   * Divide two cpa::static_rational objects at compile time
+   *
+   * \note
+   * A division by 0 is rejected at compile time.
+   */
+  template<std::intmax_t LeftNumerator, std::intmax_t LeftDenominator, std::intmax_t RightNumerator, std::intmax_t RightDenominator>
+  constexpr typename __cpa_static_product<static_rational<LeftNumerator, LeftDenominator>,
+                                          static_rational<RightDenominator, RightNumerator>>::type
+  operator / (static_rational<LeftNumerator, LeftDenominator>, static_rational<RightNumerator, RightDenominator>) noexcept
+    {
+    return {};
+    }
+
+  template<std::intmax_t LeftNumerator, std::intmax_t LeftDenominator, std::intmax_t RightNumerator, std::intmax_t RightDenominator>
+  constexpr bool operator == (static_rational<LeftNumerator, LeftDenominator>, static_rational<RightNumerator, RightDenominator>) noexcept
+    {
+    return is_same_v<typename static_rational<LeftNumerator, LeftDenominator>::type,
+                     typename static_rational<RightNumerator, RightDenominator>::type>;
+    }
+
+  template<std::intmax_t LeftNumerator, std::intmax_t LeftDenominator, std::intmax_t RightNumerator, std::intmax_t RightDenominator>
+  constexpr bool operator != (static_rational<LeftNumerator, LeftDenominator> lhs, static_rational<RightNumerator, RightDenominator> rhs) noexcept
+    {
+    return !(lhs == rhs);
+    }
+
+  /*
+   * Calculate the GCD of value and a constant. Instead of a full GCD, only a remainder of the constant divisor is required,
+   * and the remaining steps operate on values not exceeding the constant, which are narrowed to 32 bits where possible. For
+   * powers of two, the GCD is determined by counting trailing zeros.
+   */
+  template<std::uintmax_t Constant, typename Unsigned>
+  constexpr Unsigned __cpa_constant_gcd(Unsigned const value) noexcept
+    {
+    using narrow_t = std::conditional_t<(Constant <= UINT32_MAX), std::uint32_t, Unsigned>;
+
+    if(Constant == 1)
+      {
+      return 1;
+      }
+
+    if(!value || !Constant)
+      {
+      return static_cast<Unsigned>(value | Constant);
+      }
+
+    if(!(Constant & (Constant - 1)))
+      {
+      auto const trailing = __cpa_ctz(value);
+      auto const shift = __cpa_ctz(Constant);
+      return static_cast<Unsigned>(Unsigned{1} << (trailing < shift ? trailing : shift));
+      }
+
+    auto const remainder = static_cast<narrow_t>(value % Constant);
+    return static_cast<Unsigned>(__cpa_binary_gcd(static_cast<narrow_t>(Constant), remainder));
+    }
+
+  template<std::intmax_t Numerator, std::intmax_t Denominator, typename Rep, typename Policy>
+  constexpr basic_rational<Rep, Policy> __cpa_scale(Rep const numerator, Rep const denominator, bool const reduced, std::true_type)
+    noexcept(std::is_nothrow_copy_constructible<Rep>::value)
+    {
+    if(!Numerator)
+      {
+      return basic_rational<Rep, Policy>{__cpa_unchecked{}, Rep{0}, Rep{1}, true};
+      }
+
+    auto const numerator_gcd = static_cast<Rep>(__cpa_constant_gcd<__cpa_magnitude(Denominator)>(__cpa_magnitude(numerator)));
+    auto const denominator_gcd = static_cast<Rep>(__cpa_constant_gcd<__cpa_magnitude(Numerator)>(__cpa_magnitude(denominator)));
+    Rep const result_numerator = (numerator / numerator_gcd) * (static_cast<Rep>(Numerator) / denominator_gcd);
+    Rep const result_denominator = (denominator / denominator_gcd) * (static_cast<Rep>(Denominator) / numerator_gcd);
+
+    return basic_rational<Rep, Policy>{__cpa_unchecked{}, result_numerator, result_denominator, reduced};
+    }
+
+  template<std::intmax_t Numerator, std::intmax_t Denominator, typename Rep, typename Policy>
+  constexpr basic_rational<Rep, Policy> __cpa_scale(Rep const numerator, Rep const denominator, bool const reduced, std::false_type)
+    {
+    return basic_rational<Rep, Policy>{__cpa_unchecked{}, numerator, denominator, reduced} *
+           static_cast<basic_rational<Rep, Policy>>(static_rational<Numerator, Denominator>{});
+    }
+
+  /*
+   * Multiply numerator / denominator by the canonical constant Numerator / Denominator
+   */
+  template<std::intmax_t Numerator, std::intmax_t Denominator, typename Rep, typename Policy>
+  constexpr basic_rational<Rep, Policy> __cpa_scale(Rep const numerator, Rep const denominator, bool const reduced)
+    {
+    return __cpa_scale<Numerator, Denominator, Rep, Policy>(numerator, denominator, reduced, __cpa_is_binary_gcd_capable<Rep>{});
+    }
+
+  template<int Sign, std::intmax_t Numerator, std::intmax_t Denominator, typename Rep, typename Policy>
+  constexpr basic_rational<Rep, Policy> __cpa_add_constant(Rep const numerator, Rep const denominator, bool const reduced,
+                                                           std::true_type)
+    noexcept(std::is_nothrow_copy_constructible<Rep>::value)
+    {
+    auto const gcd = static_cast<Rep>(__cpa_constant_gcd<Denominator>(__cpa_magnitude(denominator)));
+    auto const constant_numerator = static_cast<Rep>(Sign > 0 ? Numerator : -Numerator);
+    auto const constant_denominator = static_cast<Rep>(Denominator);
+
+    if(gcd == Rep{1})
+      {
+      Rep const result_numerator = numerator * constant_denominator + constant_numerator * denominator;
+      Rep const result_denominator = denominator * constant_denominator;
+      return basic_rational<Rep, Policy>{__cpa_unchecked{}, result_numerator, result_denominator, reduced};
+      }
+
+    Rep const factor = denominator / gcd;
+    Rep const sum = numerator * (constant_denominator / gcd) + constant_numerator * factor;
+    auto const common = cpa::gcd(sum, gcd);
+    Rep const result_numerator = sum / common;
+    Rep const result_denominator = factor * (constant_denominator / common);
+
+    return basic_rational<Rep, Policy>{__cpa_unchecked{}, result_numerator, result_denominator, reduced};
+    }
+
+  template<int Sign, std::intmax_t Numerator, std::intmax_t Denominator, typename Rep, typename Policy>
+  constexpr basic_rational<Rep, Policy> __cpa_add_constant(Rep const numerator, Rep const denominator, bool const reduced,
+                                                           std::false_type)
+    {
+    auto const value = basic_rational<Rep, Policy>{__cpa_unchecked{}, numerator, denominator, reduced};
+    auto const constant = static_cast<basic_rational<Rep, Policy>>(static_rational<Numerator, Denominator>{});
+    return Sign > 0 ? value + constant : value - constant;
+    }
+
+  /*
+   * Add (Sign = 1) or subtract (Sign = -1) the canonical constant Numerator / Denominator to numerator / denominator. This
+   * is the algorithm used by cpa::__cpa_add, with the GCD of the denominators replaced by cpa::__cpa_constant_gcd.
+   */
+  template<int Sign, std::intmax_t Numerator, std::intmax_t Denominator, typename Rep, typename Policy>
+  constexpr basic_rational<Rep, Policy> __cpa_add_constant(Rep const numerator, Rep const denominator, bool const reduced)
+    {
+    return __cpa_add_constant<Sign, Numerator, Denominator, Rep, Policy>(numerator, denominator, reduced,
+                                                                         __cpa_is_binary_gcd_capable<Rep>{});
+    }
+
+  /**
+   * Add a cpa::basic_rational and a cpa::static_rational
+   *
+   * \note
+   * No GCD involving the constant is calculated at runtime. If both operands are reduced, the result will be reduced as well.
+   * If \p Rep can not represent the result, the behavior is undefined.
+   */
+  template<typename Rep, typename Policy, std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr basic_rational<Rep, Policy> operator + (basic_rational<Rep, Policy> const & lhs, static_rational<Numerator, Denominator>)
+    {
+    using constant_t = static_rational<Numerator, Denominator>;
+    return __cpa_add_constant<1, constant_t::num, constant_t::den, Rep, Policy>(lhs.numerator(), lhs.denominator(),
+                                                                                lhs.known_canonical());
+    }
+
+  template<typename Rep, typename Policy, std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr basic_rational<Rep, Policy> operator + (static_rational<Numerator, Denominator> lhs, basic_rational<Rep, Policy> const & rhs)
+    {
+    return rhs + lhs;
+    }
+
+  /**
+   * Subtract a cpa::static_rational from a cpa::basic_rational
+   *
+   * \note
+   * The same guarantees as for cpa::operator+(basic_rational<Rep, Policy> const &, static_rational<Numerator, Denominator>)
+   * apply.
+   */
+  template<typename Rep, typename Policy, std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr basic_rational<Rep, Policy> operator - (basic_rational<Rep, Policy> const & lhs, static_rational<Numerator, Denominator>)
+    {
+    using constant_t = static_rational<Numerator, Denominator>;
+    return __cpa_add_constant<-1, constant_t::num, constant_t::den, Rep, Policy>(lhs.numerator(), lhs.denominator(),
+                                                                                 lhs.known_canonical());
+    }
+
+  template<typename Rep, typename Policy, std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr basic_rational<Rep, Policy> operator - (static_rational<Numerator, Denominator> lhs, basic_rational<Rep, Policy> const & rhs)
+    {
+    return -(rhs - lhs);
+    }
+
+  /**
+   * Multiply a cpa::basic_rational by a cpa::static_rational
+   *
+   * \note
+   * Common factors of the constant and the operand are cancelled using only remainders of constant divisors. If the operand
+   * is reduced, the result will be reduced as well. If \p Rep can not represent the result, the behavior is undefined.
+   */
+  template<typename Rep, typename Policy, std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr basic_rational<Rep, Policy> operator * (basic_rational<Rep, Policy> const & lhs, static_rational<Numerator, Denominator>)
+    {
+    using constant_t = static_rational<Numerator, Denominator>;
+    return __cpa_scale<constant_t::num, constant_t::den, Rep, Policy>(lhs.numerator(), lhs.denominator(), lhs.known_canonical());
+    }
+
+  template<typename Rep, typename Policy, std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr basic_rational<Rep, Policy> operator * (static_rational<Numerator, Denominator> lhs, basic_rational<Rep, Policy> const & rhs)
+    {
+    return rhs * lhs;
+    }
+
+  /**
+   * Divide a cpa::basic_rational by a cpa::static_rational
+   *
+   * \note
+   * The same guarantees as for cpa::operator*(basic_rational<Rep, Policy> const &, static_rational<Numerator, Denominator>)
+   * apply. A division by 0 is rejected at compile time.
+   */
+  template<typename Rep, typename Policy, std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr basic_rational<Rep, Policy> operator / (basic_rational<Rep, Policy> const & lhs, static_rational<Numerator, Denominator>)
+    {
+    using reciprocal_t = typename static_rational<Denominator, Numerator>::type;
+    return __cpa_scale<reciprocal_t::num, reciprocal_t::den, Rep, Policy>(lhs.numerator(), lhs.denominator(),
+                                                                          lhs.known_canonical());
+    }
+
+  /**
+   * Divide a cpa::static_rational by a cpa::basic_rational
+   *
+   * \note
+   * This function will throw an instance of std::domain_error iff rhs is equal to 0.
+   */
+  template<typename Rep, typename Policy, std::intmax_t Numerator, std::intmax_t Denominator>
+  constexpr basic_rational<Rep, Policy> operator / (static_rational<Numerator, Denominator>, basic_rational<Rep, Policy> const & rhs)
+    {
+    using constant_t = static_rational<Numerator, Denominator>;
+
+    if(!rhs)
+      {
+      throw std::domain_error{"division by 0 would result in an undefined value"};
+      }
+
+    return __cpa_scale<constant_t::num, constant_t::den, Rep, Policy>(rhs.denominator(), rhs.numerator(), rhs.known_canonical());
+    }
+
+  }
+
+#endif
@@ -0,0 +1,10 @@
+#define __CPA_DEFINE_EXTERN_TEMPLATES
+
+#include <numeric.h>
+#include <rational.h>
+
+/*
+ * Explicit instantiation definitions of the templates declared as extern by the headers if CPA_EXTERN_TEMPLATES is defined.
+ * The instantiations themselves are generated by the headers, using the list of representation types in
+ * __impl/extern_templates.h.
+ */
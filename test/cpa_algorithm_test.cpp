@@ -0,0 +1,246 @@
+#include <algorithm.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+void test_reduce_range_of_rationals()
+  {
+  auto values = std::vector<cpa::rational>{};
+
+  for(auto index = std::intmax_t{1}; index < 1000; ++index)
+    {
+    values.push_back(cpa::rational{index * 6 * (index % 3 ? 1 : -1), index * 4 + 2});
+    }
+
+  auto expected = values;
+  for(auto & value : expected)
+    {
+    value.reduce();
+    }
+
+  cpa::reduce(values.begin(), values.end());
+
+  for(auto index = std::size_t{}; index < values.size(); ++index)
+    {
+    ASSERT_EQUAL(expected[index].numerator(), values[index].numerator());
+    ASSERT_EQUAL(expected[index].denominator(), values[index].denominator());
+    }
+  }
+
+void test_reduce_range_keeps_signs()
+  {
+  auto values = std::list<cpa::rational>{cpa::rational{12, -8}, cpa::rational{-6, 14}, cpa::rational{0, 5}};
+
+  cpa::reduce(values.begin(), values.end());
+
+  auto current = values.begin();
+  ASSERT_EQUAL(3, current->numerator());
+  ASSERT_EQUAL(-2, current->denominator());
+
+  ++current;
+  ASSERT_EQUAL(-3, current->numerator());
+  ASSERT_EQUAL(7, current->denominator());
+
+  ++current;
+  ASSERT_EQUAL(0, current->numerator());
+  ASSERT_EQUAL(1, current->denominator());
+  }
+
+void test_reduce_range_of_narrow_rationals()
+  {
+  auto shorts = std::vector<cpa::basic_rational<std::int16_t>>{cpa::basic_rational<std::int16_t>{-30000, 12000},
+                                                               cpa::basic_rational<std::int16_t>{4096, 32}};
+  auto chars = std::vector<cpa::basic_rational<std::int8_t>>{cpa::basic_rational<std::int8_t>{-120, 45}};
+
+  cpa::reduce(shorts.begin(), shorts.end());
+  cpa::reduce(chars.begin(), chars.end());
+
+  ASSERT_EQUAL(-5, shorts[0].numerator());
+  ASSERT_EQUAL(2, shorts[0].denominator());
+  ASSERT_EQUAL(128, shorts[1].numerator());
+  ASSERT_EQUAL(1, shorts[1].denominator());
+  ASSERT_EQUAL(-8, chars[0].numerator());
+  ASSERT_EQUAL(3, chars[0].denominator());
+  }
+
+void test_reduce_empty_range()
+  {
+  auto values = std::vector<cpa::rational>{};
+  cpa::reduce(values.begin(), values.end());
+  ASSERT(values.empty());
+  }
+
+void test_sum_range_with_few_denominators()
+  {
+  auto values = std::vector<cpa::rational>{};
+
+  for(auto index = std::intmax_t{1}; index < 3000; ++index)
+    {
+    auto const denominator = std::intmax_t{index % 3 ? (index % 3 == 1 ? 6 : -10) : 15};
+    values.push_back(cpa::rational{index % 7 - 3, denominator});
+    }
+
+  auto const expected = std::accumulate(values.begin(), values.end(), cpa::rational{}).reduce();
+  auto const result = cpa::sum(values.begin(), values.end());
+
+  ASSERT_EQUAL(expected.numerator(), result.numerator());
+  ASSERT_EQUAL(expected.denominator(), result.denominator());
+  }
+
+void test_sum_range_with_many_denominators()
+  {
+  auto values = std::list<cpa::rational>{};
+
+  for(auto index = std::intmax_t{1}; index < 60; ++index)
+    {
+    values.push_back(cpa::rational{1, index * (index + 1)});
+    }
+
+  auto const result = cpa::sum(values.begin(), values.end());
+
+  ASSERT_EQUAL(59, result.numerator());
+  ASSERT_EQUAL(60, result.denominator());
+  }
+
+void test_sum_range_recovers_from_numerator_overflow()
+  {
+  auto constexpr big = 1 << 30;
+  auto const values = std::vector<cpa::basic_rational<int>>{cpa::basic_rational<int>{big, 4},
+                                                            cpa::basic_rational<int>{big, 4},
+                                                            cpa::basic_rational<int>{-big + 4, 4}};
+
+  auto const result = cpa::sum(values.begin(), values.end());
+
+  ASSERT_EQUAL((1 << 28) + 1, result.numerator());
+  ASSERT_EQUAL(1, result.denominator());
+  }
+
+void test_sum_range_with_most_negative_denominator()
+  {
+  using rational = cpa::basic_rational<std::int64_t>;
+  auto constexpr minimum = std::numeric_limits<std::int64_t>::min();
+
+  auto const values = std::vector<rational>{rational{2, minimum}, rational{minimum, minimum}, rational{3, std::int64_t{1} << 62}};
+  auto const result = cpa::sum(values.begin(), values.end());
+
+  ASSERT_EQUAL((std::int64_t{1} << 61) + 1, result.numerator());
+  ASSERT_EQUAL(std::int64_t{1} << 61, result.denominator());
+
+  auto const unrepresentable = std::vector<rational>{rational{1, 3}, rational{1, minimum}};
+  ASSERT_THROWS(cpa::sum(unrepresentable.begin(), unrepresentable.end()), std::domain_error);
+  }
+
+void test_sum_empty_range()
+  {
+  auto const values = std::vector<cpa::rational>{};
+  auto const result = cpa::sum(values.begin(), values.end());
+
+  ASSERT_EQUAL(0, result.numerator());
+  ASSERT_EQUAL(1, result.denominator());
+  }
+
+void test_sort_matches_exact_comparison()
+  {
+  auto engine = std::mt19937_64{11};
+  auto values = std::vector<cpa::rational>{};
+
+  for(auto index = 0; index < 20000; ++index)
+    {
+    auto const numerator = static_cast<std::intmax_t>(engine() >> (index % 63)) * (index % 2 ? 1 : -1);
+    auto const denominator = static_cast<std::intmax_t>(engine() >> (1 + index % 62)) | 1;
+    values.push_back(cpa::rational{numerator, index % 5 ? denominator : -denominator});
+    }
+
+  auto expected = values;
+  std::stable_sort(expected.begin(), expected.end());
+
+  cpa::sort(values.begin(), values.end());
+
+  for(std::size_t index{}; index < values.size(); ++index)
+    {
+    ASSERT((values[index] == expected[index]));
+    }
+  }
+
+void test_sort_breaks_ties_of_equal_keys()
+  {
+  auto const base = std::intmax_t{1} << 62;
+  auto values = std::vector<cpa::rational>{};
+
+  for(auto index = std::intmax_t{}; index < 1000; ++index)
+    {
+    values.push_back(cpa::rational{base + (index * 7919) % 1000, base});
+    }
+
+  cpa::sort(values.begin(), values.end());
+
+  for(std::size_t index{}; index < values.size(); ++index)
+    {
+    ASSERT_EQUAL(base + static_cast<std::intmax_t>(index), values[index].numerator());
+    }
+  }
+
+void test_sort_small_range()
+  {
+  using rational_t = cpa::basic_rational<int>;
+
+  auto values = std::vector<rational_t>{rational_t{1, 2}, rational_t{-1, 3}, rational_t{2, -3}, rational_t{1, 4}};
+
+  cpa::sort(values.begin(), values.end());
+
+  ASSERT_EQUAL(2, values[0].numerator());
+  ASSERT_EQUAL(-1, values[1].numerator());
+  ASSERT_EQUAL(4, values[2].denominator());
+  ASSERT_EQUAL(2, values[3].denominator());
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"Reduce a range of rationals",
+             test_reduce_range_of_rationals};
+  suite += T{"Reduce a range of rationals with negative numerators and denominators",
+             test_reduce_range_keeps_signs};
+  suite += T{"Reduce a range of 8-bit and 16-bit rationals",
+             test_reduce_range_of_narrow_rationals};
+  suite += T{"Reduce an empty range of rationals",
+             test_reduce_empty_range};
+  suite += T{"Sum a range of rationals sharing a few denominators",
+             test_sum_range_with_few_denominators};
+  suite += T{"Sum a range of rationals with many distinct denominators",
+             test_sum_range_with_many_denominators};
+  suite += T{"Sum a range of rationals whose numerators overflow when grouped",
+             test_sum_range_recovers_from_numerator_overflow};
+  suite += T{"Sum a range of rationals with the most negative denominator",
+             test_sum_range_with_most_negative_denominator};
+  suite += T{"Sum an empty range of rationals",
+             test_sum_empty_range};
+  suite += T{"Sort a range of rationals",
+             test_sort_matches_exact_comparison};
+  suite += T{"Sort rationals whose doubles are equal",
+             test_sort_breaks_ties_of_equal_keys};
+  suite += T{"Sort a small range of rationals",
+             test_sort_small_range};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::algorithm");
+  }
+
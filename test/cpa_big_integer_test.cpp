@@ -0,0 +1,205 @@
+#include <big_integer.h>
+#include <rational.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace
+  {
+  cpa::big_integer power(cpa::big_integer const & base, int exponent)
+    {
+    auto result = cpa::big_integer{1};
+
+    while(exponent--)
+      {
+      result *= base;
+      }
+
+    return result;
+    }
+  }
+
+void test_big_integer_satisfies_type_traits()
+  {
+  ASSERT(cpa::is_negatable_v<cpa::big_integer>);
+  ASSERT(cpa::is_lessthan_comparable_v<cpa::big_integer>);
+  ASSERT(!std::numeric_limits<cpa::big_integer>::is_bounded);
+  }
+
+void test_big_integer_small_arithmetic()
+  {
+  auto const a = cpa::big_integer{1234};
+  auto const b = cpa::big_integer{-56};
+
+  ASSERT_EQUAL(cpa::big_integer{1178}, a + b);
+  ASSERT_EQUAL(cpa::big_integer{1290}, a - b);
+  ASSERT_EQUAL(cpa::big_integer{-69104}, a * b);
+  ASSERT_EQUAL(cpa::big_integer{-22}, a / b);
+  ASSERT_EQUAL(cpa::big_integer{2}, a % b);
+  ASSERT_EQUAL(cpa::big_integer{-2}, -a % b);
+  ASSERT_EQUAL(cpa::big_integer{56}, -b);
+  }
+
+void test_big_integer_construction_from_extreme_values()
+  {
+  auto const minimum = cpa::big_integer{std::numeric_limits<std::int64_t>::min()};
+  auto const maximum = cpa::big_integer{std::numeric_limits<std::uint64_t>::max()};
+
+  ASSERT_EQUAL("-9223372036854775808", to_string(minimum));
+  ASSERT_EQUAL("18446744073709551615", to_string(maximum));
+  ASSERT_EQUAL("18446744073709551616", to_string(maximum + 1));
+  ASSERT_EQUAL(maximum, maximum + 1 - 1);
+  }
+
+void test_big_integer_comparison()
+  {
+  auto const large = power(10, 30);
+
+  ASSERT(cpa::big_integer{-1} < cpa::big_integer{1});
+  ASSERT(-large < cpa::big_integer{-1});
+  ASSERT(cpa::big_integer{std::numeric_limits<std::uint64_t>::max()} < large);
+  ASSERT(large > large - 1);
+  ASSERT(large <= large);
+  ASSERT(large != -large);
+  }
+
+void test_big_integer_large_multiplication_and_division()
+  {
+  auto const a = power(3, 300);
+  auto const b = power(7, 150) + 12345;
+
+  auto const product = a * b;
+
+  ASSERT_EQUAL(a, product / b);
+  ASSERT_EQUAL(b, product / a);
+  ASSERT_EQUAL(cpa::big_integer{0}, product % a);
+  ASSERT_EQUAL(cpa::big_integer{1}, (product + 1) % b);
+  ASSERT_EQUAL(-a, -product / b);
+  }
+
+void test_big_integer_karatsuba_matches_schoolbook()
+  {
+  auto const a = power(3, 2000) - 1;
+  auto const b = power(5, 1500) + 1;
+
+  auto const product = a * b;
+
+  ASSERT_EQUAL(product, b * a);
+  ASSERT_EQUAL(a, product / b);
+  ASSERT_EQUAL(cpa::big_integer{0}, product % b);
+  ASSERT_EQUAL(product - a, a * (b - 1));
+  }
+
+void test_big_integer_to_string()
+  {
+  ASSERT_EQUAL("0", to_string(cpa::big_integer{}));
+  ASSERT_EQUAL("1000000000000000000000000000000", to_string(power(10, 30)));
+  ASSERT_EQUAL("-1000000000000000000000000000001", to_string(-power(10, 30) - 1));
+  }
+
+void test_big_integer_division_by_zero()
+  {
+  ASSERT_THROWS(cpa::big_integer{1} / cpa::big_integer{}, std::domain_error);
+  ASSERT_THROWS(power(10, 30) % cpa::big_integer{}, std::domain_error);
+  }
+
+void test_big_integer_gcd()
+  {
+  auto const common = power(2, 70) * power(3, 40) * 17;
+  auto const a = common * (power(5, 60) + 2);
+  auto const b = -common * power(7, 45);
+
+  ASSERT_EQUAL(common, cpa::gcd(a, b));
+  ASSERT_EQUAL(common, cpa::gcd(b, a));
+  ASSERT_EQUAL(cpa::big_integer{6}, cpa::gcd(cpa::big_integer{-12}, cpa::big_integer{18}));
+  ASSERT_EQUAL(a, cpa::gcd(a, cpa::big_integer{}));
+  }
+
+void test_big_integer_gcd_of_consecutive_fibonacci_numbers()
+  {
+  auto previous = cpa::big_integer{1};
+  auto current = cpa::big_integer{1};
+
+  for(auto index = 0; index < 500; ++index)
+    {
+    auto next = previous + current;
+    previous = current;
+    current = next;
+    }
+
+  ASSERT_EQUAL(cpa::big_integer{1}, cpa::gcd(current, previous));
+  }
+
+void test_big_integer_as_rational_rep()
+  {
+  using rational = cpa::basic_rational<cpa::big_integer>;
+
+  auto const third = rational{power(10, 30), power(10, 30) * 3};
+  auto const half = rational{1, 2};
+
+  auto const r1 = (third + half).reduce();
+  auto const r2 = (third * half).reduce();
+
+  ASSERT_EQUAL(cpa::big_integer{5}, r1.numerator());
+  ASSERT_EQUAL(cpa::big_integer{6}, r1.denominator());
+  ASSERT_EQUAL(cpa::big_integer{1}, r2.numerator());
+  ASSERT_EQUAL(cpa::big_integer{6}, r2.denominator());
+  ASSERT_THROWS(half / rational{0}, std::domain_error);
+  }
+
+void test_big_integer_as_lazy_rational_rep()
+  {
+  using rational = cpa::basic_rational<cpa::big_integer, cpa::lazy_normalization>;
+
+  auto const r1 = rational{power(2, 100), power(2, 101)};
+
+  ASSERT(!r1.known_canonical());
+  ASSERT_EQUAL(cpa::big_integer{1}, r1.reduce().numerator());
+  ASSERT_EQUAL(cpa::big_integer{2}, r1.reduce().denominator());
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"big_integer satisfies the type traits required by cpa::abs",
+             test_big_integer_satisfies_type_traits};
+  suite += T{"Arithmetic on small big_integer objects",
+             test_big_integer_small_arithmetic};
+  suite += T{"Construct big_integer objects from extreme values",
+             test_big_integer_construction_from_extreme_values};
+  suite += T{"Compare big_integer objects",
+             test_big_integer_comparison};
+  suite += T{"Multiply and divide large big_integer objects",
+             test_big_integer_large_multiplication_and_division};
+  suite += T{"Multiply big_integer objects above the Karatsuba threshold",
+             test_big_integer_karatsuba_matches_schoolbook};
+  suite += T{"Convert big_integer objects to strings",
+             test_big_integer_to_string};
+  suite += T{"Division of big_integer objects by zero throws",
+             test_big_integer_division_by_zero};
+  suite += T{"Calculate the GCD of large big_integer objects",
+             test_big_integer_gcd};
+  suite += T{"Calculate the GCD of large consecutive Fibonacci numbers",
+             test_big_integer_gcd_of_consecutive_fibonacci_numbers};
+  suite += T{"Use big_integer as the representation of basic_rational",
+             test_big_integer_as_rational_rep};
+  suite += T{"Use big_integer as the representation of a lazily normalized basic_rational",
+             test_big_integer_as_lazy_rational_rep};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::big_integer");
+  }
@@ -0,0 +1,189 @@
+#include <charconv.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <system_error>
+
+namespace
+  {
+  template<typename Rep>
+  std::string format(cpa::basic_rational<Rep> const & value)
+    {
+    char buffer[96];
+    auto const result = cpa::to_chars(buffer, buffer + sizeof(buffer), value);
+    return result.ec == std::errc{} ? std::string(buffer, result.ptr) : std::string{"<error>"};
+    }
+
+  template<typename Rep>
+  cpa::from_chars_result parse(std::string const & text, cpa::basic_rational<Rep> & value, bool const reduce = true)
+    {
+    return cpa::from_chars(text.data(), text.data() + text.size(), value, reduce);
+    }
+  }
+
+void test_to_chars_writes_fractions_and_integers()
+  {
+  ASSERT_EQUAL("3/4", format(cpa::rational{3, 4}));
+  ASSERT_EQUAL("-3/4", format(cpa::rational{3, -4}));
+  ASSERT_EQUAL("3/4", format(cpa::rational{-3, -4}));
+  ASSERT_EQUAL("6/8", format(cpa::rational{6, 8}));
+  ASSERT_EQUAL("-42", format(cpa::rational{-42}));
+  ASSERT_EQUAL("-42", format(cpa::rational{42, -1}));
+  ASSERT_EQUAL("0/5", format(cpa::rational{0, -5}));
+  ASSERT_EQUAL("1234567890/987654321", format(cpa::rational{1234567890, 987654321}));
+  }
+
+void test_to_chars_canonicalizes_lazy_values()
+  {
+  using lazy = cpa::basic_rational<int, cpa::lazy_normalization>;
+  char buffer[32];
+
+  auto result = cpa::to_chars(buffer, buffer + sizeof(buffer), lazy{2, 4} * lazy{3});
+  ASSERT_EQUAL("3/2", std::string(buffer, result.ptr));
+
+  result = cpa::to_chars(buffer, buffer + sizeof(buffer), lazy{6, -8});
+  ASSERT_EQUAL("-3/4", std::string(buffer, result.ptr));
+
+  result = cpa::to_chars(buffer, buffer + sizeof(buffer), lazy{0, -5});
+  ASSERT_EQUAL("0", std::string(buffer, result.ptr));
+  }
+
+void test_to_chars_writes_extreme_values()
+  {
+  auto const min = std::numeric_limits<std::int64_t>::min();
+  auto const max = std::numeric_limits<std::int64_t>::max();
+
+  ASSERT_EQUAL("-9223372036854775808/9223372036854775807", format(cpa::basic_rational<std::int64_t>{min, max}));
+  ASSERT_EQUAL("-128/127", format(cpa::basic_rational<signed char>{-128, 127}));
+  ASSERT_EQUAL("18446744073709551615", format(cpa::basic_rational<std::uint64_t>{~std::uint64_t{0}}));
+
+#if defined(__SIZEOF_INT128__)
+  auto const huge = cpa::basic_rational<cpa::__cpa_int128>{-(cpa::__cpa_int128{1} << 100), 3};
+  ASSERT_EQUAL("-1267650600228229401496703205376/3", format(huge));
+#endif
+  }
+
+void test_to_chars_reports_small_buffers()
+  {
+  char buffer[8];
+  std::memset(buffer, 0, sizeof(buffer));
+
+  for(auto size = std::size_t{}; size < 6; ++size)
+    {
+    auto const result = cpa::to_chars(buffer, buffer + size, cpa::rational{-12, 34});
+
+    ASSERT_EQUAL(buffer + size, result.ptr);
+    ASSERT(result.ec == std::errc::value_too_large);
+    }
+
+  auto const result = cpa::to_chars(buffer, buffer + 6, cpa::rational{-12, 34});
+  ASSERT(result.ec == std::errc{});
+  ASSERT_EQUAL("-12/34", std::string(buffer, result.ptr));
+  }
+
+void test_from_chars_parses_fractions_and_integers()
+  {
+  auto value = cpa::rational{};
+
+  auto const text = std::string{"-6/8 rest"};
+  auto const fraction = parse(text, value);
+  ASSERT(fraction.ec == std::errc{});
+  ASSERT_EQUAL(4, fraction.ptr - text.data());
+  ASSERT_EQUAL(-3, value.numerator());
+  ASSERT_EQUAL(4, value.denominator());
+
+  auto const integer = parse("17", value);
+  ASSERT(integer.ec == std::errc{});
+  ASSERT_EQUAL(17, value.numerator());
+  ASSERT_EQUAL(1, value.denominator());
+
+  auto const unreduced = parse("6/8", value, false);
+  ASSERT(unreduced.ec == std::errc{});
+  ASSERT_EQUAL(6, value.numerator());
+  ASSERT_EQUAL(8, value.denominator());
+
+  auto const incomplete = std::string{"5/x"};
+  auto const trailing = parse(incomplete, value);
+  ASSERT(trailing.ec == std::errc{});
+  ASSERT_EQUAL(1, trailing.ptr - incomplete.data());
+  ASSERT_EQUAL(5, value.numerator());
+  ASSERT_EQUAL(1, value.denominator());
+  }
+
+void test_from_chars_reports_errors()
+  {
+  auto value = cpa::basic_rational<std::int8_t>{1, 2};
+
+  std::string const invalid[] = {"", "-", "+1", " 1", "/2", "1/0", "-x"};
+  for(auto const & text : invalid)
+    {
+    auto const result = parse(text, value);
+    ASSERT(result.ec == std::errc::invalid_argument);
+    ASSERT_EQUAL(static_cast<void const *>(text.data()), static_cast<void const *>(result.ptr));
+    }
+
+  auto const numerator = std::string{"128/3"};
+  auto const large_numerator = parse(numerator, value);
+  ASSERT(large_numerator.ec == std::errc::result_out_of_range);
+  ASSERT_EQUAL(3, large_numerator.ptr - numerator.data());
+
+  auto const denominator = std::string{"-1/128"};
+  auto const large_denominator = parse(denominator, value);
+  ASSERT(large_denominator.ec == std::errc::result_out_of_range);
+  ASSERT_EQUAL(6, large_denominator.ptr - denominator.data());
+
+  ASSERT_EQUAL(1, value.numerator());
+  ASSERT_EQUAL(2, value.denominator());
+
+  ASSERT(parse("-128", value).ec == std::errc{});
+  ASSERT_EQUAL(-128, value.numerator());
+
+  auto unsigned_value = cpa::basic_rational<unsigned>{};
+  ASSERT(parse("-1", unsigned_value).ec == std::errc::invalid_argument);
+  }
+
+void test_text_round_trip()
+  {
+  auto value = cpa::rational{};
+  auto const original = cpa::rational{-9223372036854775807 - 1, 9223372036854775807};
+
+  ASSERT(parse(format(original), value).ec == std::errc{});
+  ASSERT_EQUAL(original.numerator(), value.numerator());
+  ASSERT_EQUAL(original.denominator(), value.denominator());
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"Write fractions and integers with to_chars",
+             test_to_chars_writes_fractions_and_integers};
+  suite += T{"Write values with lazy normalization in canonical form with to_chars",
+             test_to_chars_canonicalizes_lazy_values};
+  suite += T{"Write extreme values with to_chars",
+             test_to_chars_writes_extreme_values};
+  suite += T{"to_chars reports buffers that are too small",
+             test_to_chars_reports_small_buffers};
+  suite += T{"Parse fractions and integers with from_chars",
+             test_from_chars_parses_fractions_and_integers};
+  suite += T{"from_chars reports errors",
+             test_from_chars_reports_errors};
+  suite += T{"Round trip rationals through text",
+             test_text_round_trip};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::charconv");
+  }
@@ -0,0 +1,145 @@
+#include <checked.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+void test_checked_add_without_overflow()
+  {
+  auto error = std::error_code{};
+  auto const r1 = cpa::checked_add(cpa::rational{1, 3}, cpa::rational{1, 6}, error);
+
+  ASSERT(!error);
+  ASSERT_EQUAL(1, r1.numerator());
+  ASSERT_EQUAL(2, r1.denominator());
+  }
+
+void test_checked_add_recovers_from_intermediate_overflow()
+  {
+  auto error = std::error_code{};
+  auto const r1 = cpa::checked_add(cpa::basic_rational<int>{1073741824, 5}, cpa::basic_rational<int>{-1073741821, 3}, error);
+
+  ASSERT(!error);
+  ASSERT_EQUAL(-2147483633, r1.numerator());
+  ASSERT_EQUAL(15, r1.denominator());
+  }
+
+void test_checked_subtract_recovers_from_intermediate_overflow_with_wide_types()
+  {
+  auto constexpr big = std::int64_t{1} << 62;
+  auto const r1 = cpa::checked_subtract(cpa::basic_rational<std::int64_t>{big, 5},
+                                        cpa::basic_rational<std::int64_t>{big - 3, 3});
+
+  ASSERT_EQUAL(std::int64_t{-9223372036854775807} + 14, r1.numerator());
+  ASSERT_EQUAL(15, r1.denominator());
+  }
+
+void test_checked_multiply_reports_overflow()
+  {
+  auto error = std::error_code{};
+  auto const r1 = cpa::checked_multiply(cpa::basic_rational<int>{65536, 3}, cpa::basic_rational<int>{65536, 5}, error);
+
+  ASSERT_EQUAL(std::make_error_code(std::errc::value_too_large), error);
+  ASSERT_EQUAL(0, r1.numerator());
+  ASSERT_THROWS(cpa::checked_multiply(cpa::basic_rational<int>{65536, 3}, cpa::basic_rational<int>{65536, 5}), std::domain_error);
+  }
+
+void test_checked_multiply_with_cross_cancellation()
+  {
+  auto const r1 = cpa::checked_multiply(cpa::basic_rational<int>{65536, 3}, cpa::basic_rational<int>{3, 65536});
+
+  ASSERT_EQUAL(1, r1.numerator());
+  ASSERT_EQUAL(1, r1.denominator());
+  }
+
+void test_checked_subtract_of_unsigned_reports_negative_results()
+  {
+  auto error = std::error_code{};
+  cpa::checked_subtract(cpa::basic_rational<unsigned>{1, 3}, cpa::basic_rational<unsigned>{1, 2}, error);
+
+  ASSERT_EQUAL(std::make_error_code(std::errc::value_too_large), error);
+  }
+
+void test_checked_divide_by_zero()
+  {
+  auto error = std::error_code{};
+  cpa::checked_divide(cpa::rational{1, 3}, cpa::rational{0}, error);
+
+  ASSERT_EQUAL(std::make_error_code(std::errc::invalid_argument), error);
+  ASSERT_THROWS(cpa::checked_divide(cpa::rational{1, 3}, cpa::rational{0}), std::domain_error);
+  }
+
+void test_checked_expand()
+  {
+  auto error = std::error_code{};
+  auto const r1 = cpa::checked_expand(cpa::basic_rational<int>{3, 7}, 5, error);
+
+  ASSERT(!error);
+  ASSERT_EQUAL(15, r1.numerator());
+  ASSERT_EQUAL(35, r1.denominator());
+
+  cpa::checked_expand(cpa::basic_rational<int>{3, 1 << 20}, 1 << 12, error);
+  ASSERT_EQUAL(std::make_error_code(std::errc::value_too_large), error);
+  ASSERT_THROWS(cpa::checked_expand(cpa::basic_rational<int>{3, 7}, 0), std::domain_error);
+  }
+
+void test_checked_common()
+  {
+  auto error = std::error_code{};
+  auto const r1 = cpa::checked_common(cpa::basic_rational<int>{1, -4}, cpa::basic_rational<int>{1, 6}, error);
+
+  ASSERT(!error);
+  ASSERT_EQUAL(-3, r1.numerator());
+  ASSERT_EQUAL(12, r1.denominator());
+
+  auto const r2 = cpa::checked_common(cpa::basic_rational<int>{5, 6}, cpa::basic_rational<int>{1, 3});
+  ASSERT_EQUAL(5, r2.numerator());
+  ASSERT_EQUAL(6, r2.denominator());
+
+  cpa::checked_common(cpa::basic_rational<int>{3, 1 << 20}, cpa::basic_rational<int>{1, 4095}, error);
+  ASSERT_EQUAL(std::make_error_code(std::errc::value_too_large), error);
+
+  auto constexpr minimum = std::numeric_limits<std::int64_t>::min();
+  ASSERT_THROWS(cpa::checked_common(cpa::basic_rational<std::int64_t>{1, 3}, cpa::basic_rational<std::int64_t>{1, minimum}),
+                std::domain_error);
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"Add two rationals without overflow",
+             test_checked_add_without_overflow};
+  suite += T{"Add two rationals whose intermediate values overflow",
+             test_checked_add_recovers_from_intermediate_overflow};
+  suite += T{"Subtract two 64-bit rationals whose intermediate values overflow",
+             test_checked_subtract_recovers_from_intermediate_overflow_with_wide_types};
+  suite += T{"Multiply two rationals whose product overflows",
+             test_checked_multiply_reports_overflow};
+  suite += T{"Multiply two rationals with common factors",
+             test_checked_multiply_with_cross_cancellation};
+  suite += T{"Subtract two unsigned rationals with a negative result",
+             test_checked_subtract_of_unsigned_reports_negative_results};
+  suite += T{"Divide a rational by zero",
+             test_checked_divide_by_zero};
+  suite += T{"Expand a rational",
+             test_checked_expand};
+  suite += T{"Expand a rational to a common denominator",
+             test_checked_common};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::checked");
+  }
+
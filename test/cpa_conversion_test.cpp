@@ -0,0 +1,152 @@
+#include <conversion.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+void test_to_double_of_small_values()
+  {
+  ASSERT_EQUAL_DELTA(0.75, cpa::to_double(cpa::rational{3, 4}), 0.0);
+  ASSERT_EQUAL_DELTA(-0.75, cpa::to_double(cpa::rational{3, -4}), 0.0);
+  ASSERT_EQUAL_DELTA(1.0 / 3.0, cpa::to_double(cpa::rational{1, 3}), 0.0);
+  ASSERT_EQUAL_DELTA(0.0, cpa::to_double(cpa::rational{0, 7}), 0.0);
+  ASSERT_EQUAL_DELTA(0.1f, cpa::to_float(cpa::basic_rational<int>{1, 10}), 0.0);
+  }
+
+void test_to_double_rounds_ties_to_even()
+  {
+  auto const two_53 = std::intmax_t{1} << 53;
+
+  ASSERT_EQUAL_DELTA(9007199254740992.0, cpa::to_double(cpa::rational{two_53 + 1}), 0.0);
+  ASSERT_EQUAL_DELTA(9007199254740996.0, cpa::to_double(cpa::rational{two_53 + 3}), 0.0);
+  ASSERT_EQUAL_DELTA(-9007199254740996.0, cpa::to_double(cpa::rational{-(two_53 + 3)}), 0.0);
+  ASSERT_EQUAL_DELTA(16777216.0f, cpa::to_float(cpa::basic_rational<std::int64_t>{(1 << 24) + 1}), 0.0);
+  ASSERT_EQUAL_DELTA(16777220.0f, cpa::to_float(cpa::basic_rational<std::int64_t>{(1 << 24) + 3}), 0.0);
+  }
+
+void test_to_double_rounds_large_quotients_correctly()
+  {
+  auto const max = std::numeric_limits<std::int64_t>::max();
+  auto const two_62 = std::int64_t{1} << 62;
+
+  ASSERT_EQUAL_DELTA(std::ldexp(1.0, 63), cpa::to_double(cpa::basic_rational<std::int64_t>{max}), 0.0);
+  ASSERT_EQUAL_DELTA(1.0, cpa::to_double(cpa::basic_rational<std::int64_t>{max, max - 1}), 0.0);
+  ASSERT_EQUAL_DELTA(1.0 + std::ldexp(1.0, -52), cpa::to_double(cpa::basic_rational<std::int64_t>{two_62 + 1025, two_62}), 0.0);
+  ASSERT_EQUAL_DELTA(1.0, cpa::to_double(cpa::basic_rational<std::int64_t>{two_62 + 512, two_62}), 0.0);
+  }
+
+#if defined(__SIZEOF_INT128__)
+void test_to_double_of_wide_representations()
+  {
+  using int128 = cpa::__cpa_int128;
+  using uint128 = cpa::__cpa_uint128;
+
+  auto engine = std::mt19937_64{42};
+
+  for(auto iteration = 0; iteration < 10000; ++iteration)
+    {
+    auto const numerator = static_cast<std::int64_t>(engine());
+    auto const denominator = static_cast<std::int64_t>(engine() >> (iteration % 60)) | 1;
+
+    auto const narrow = cpa::basic_rational<std::int64_t>{numerator, denominator};
+    auto const wide = cpa::basic_rational<int128>{numerator, denominator};
+
+    ASSERT_EQUAL_DELTA(cpa::to_double(narrow), cpa::to_double(wide), 0.0);
+    ASSERT_EQUAL_DELTA(cpa::to_float(narrow), cpa::to_float(wide), 0.0);
+    }
+
+  ASSERT_EQUAL_DELTA(std::ldexp(1.0f, -126), cpa::to_float(cpa::basic_rational<int128>{1, int128{1} << 126}), 0.0);
+  ASSERT_EQUAL_DELTA(std::ldexp(3.0f, -127), cpa::to_float(cpa::basic_rational<uint128>{3, uint128{1} << 127}), 0.0);
+  ASSERT(std::isinf(cpa::to_float(cpa::basic_rational<uint128>{~uint128{0}})));
+  ASSERT_EQUAL_DELTA(std::ldexp(1.0, 127), cpa::to_double(cpa::basic_rational<uint128>{~uint128{0} >> 1}), 0.0);
+  }
+#endif
+
+void test_from_double_is_exact_and_reduced()
+  {
+  auto const three_quarters = cpa::from_double(0.75);
+  auto const tenth = cpa::from_double(-0.1);
+  auto const large = cpa::from_double(std::ldexp(3.0, 60));
+
+  ASSERT_EQUAL(3, three_quarters.numerator());
+  ASSERT_EQUAL(4, three_quarters.denominator());
+  ASSERT_EQUAL(-3602879701896397, tenth.numerator());
+  ASSERT_EQUAL(36028797018963968, tenth.denominator());
+  ASSERT_EQUAL(std::intmax_t{3} << 60, large.numerator());
+  ASSERT_EQUAL(1, large.denominator());
+  ASSERT_EQUAL(0, cpa::from_double(-0.0).numerator());
+  ASSERT_EQUAL(1, cpa::from_double(-0.0).denominator());
+  }
+
+void test_from_double_with_narrow_representation()
+  {
+  auto const value = cpa::from_double<cpa::basic_rational<int>>(-2.5);
+  auto const single = cpa::from_float<cpa::basic_rational<int>>(0.375f);
+
+  ASSERT_EQUAL(-5, value.numerator());
+  ASSERT_EQUAL(2, value.denominator());
+  ASSERT_EQUAL(3, single.numerator());
+  ASSERT_EQUAL(8, single.denominator());
+  ASSERT_THROWS(cpa::from_double<cpa::basic_rational<int>>(0.1), std::domain_error);
+  ASSERT_THROWS(cpa::from_double<cpa::basic_rational<unsigned>>(-1.0), std::domain_error);
+  }
+
+void test_from_double_rejects_unrepresentable_values()
+  {
+  ASSERT_THROWS(cpa::from_double(std::numeric_limits<double>::infinity()), std::domain_error);
+  ASSERT_THROWS(cpa::from_double(std::numeric_limits<double>::quiet_NaN()), std::domain_error);
+  ASSERT_THROWS(cpa::from_double(1e300), std::domain_error);
+  ASSERT_THROWS(cpa::from_double(5e-324), std::domain_error);
+  }
+
+void test_double_round_trip()
+  {
+  auto engine = std::mt19937_64{7};
+
+  for(auto iteration = 0; iteration < 100000; ++iteration)
+    {
+    auto const mantissa = static_cast<double>(engine() >> 11);
+    auto const value = std::ldexp(iteration % 2 ? mantissa : -mantissa, -(iteration % 63));
+    ASSERT_EQUAL_DELTA(value, cpa::to_double(cpa::from_double(value)), 0.0);
+    }
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"Convert small rationals to double and float",
+             test_to_double_of_small_values};
+  suite += T{"Conversion to double rounds ties to even",
+             test_to_double_rounds_ties_to_even};
+  suite += T{"Conversion to double rounds large quotients correctly",
+             test_to_double_rounds_large_quotients_correctly};
+#if defined(__SIZEOF_INT128__)
+  suite += T{"Convert rationals with 128-bit representations to double and float",
+             test_to_double_of_wide_representations};
+#endif
+  suite += T{"Construct exact and reduced rationals from doubles",
+             test_from_double_is_exact_and_reduced};
+  suite += T{"Construct rationals with narrow representations from doubles",
+             test_from_double_with_narrow_representation};
+  suite += T{"Construction from doubles rejects unrepresentable values",
+             test_from_double_rejects_unrepresentable_values};
+  suite += T{"Round trip doubles through rationals",
+             test_double_round_trip};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::conversion");
+  }
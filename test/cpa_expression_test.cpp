@@ -0,0 +1,123 @@
+#include <expression.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <cstdint>
+#include <stdexcept>
+
+void test_fused_sum()
+  {
+  auto const a = cpa::rational{1, 2};
+  auto const b = cpa::rational{1, 3};
+  auto const c = cpa::rational{1, 6};
+  auto const d = cpa::rational{1};
+
+  cpa::rational const r1 = cpa::fuse(a) + b + c + d;
+
+  ASSERT_EQUAL(2, r1.numerator());
+  ASSERT_EQUAL(1, r1.denominator());
+  }
+
+void test_fused_sum_with_common_denominators()
+  {
+  auto const a = cpa::rational{5, 12};
+  auto const b = cpa::rational{-1, 12};
+  auto const c = cpa::rational{2, 12};
+
+  auto const expression = cpa::fuse(a) + b - c;
+  auto const fraction = expression.node().evaluate();
+
+  ASSERT_EQUAL(2, fraction.numerator);
+  ASSERT_EQUAL(12, fraction.denominator);
+  ASSERT_EQUAL(1, expression.evaluate().numerator());
+  ASSERT_EQUAL(6, expression.evaluate().denominator());
+  }
+
+void test_fused_sum_uses_least_common_denominator()
+  {
+  auto const a = cpa::rational{1, 65536 * 3};
+  auto const b = cpa::rational{1, 65536 * 5};
+  auto const c = cpa::rational{-1, 65536 * 15};
+
+  auto const expression = cpa::fuse(a) + b + c;
+  auto const fraction = expression.node().evaluate();
+
+  ASSERT_EQUAL(7, fraction.numerator);
+  ASSERT_EQUAL(65536 * 15, fraction.denominator);
+  ASSERT_EQUAL(7, expression.evaluate().numerator());
+  ASSERT_EQUAL(65536 * 15, expression.evaluate().denominator());
+  }
+
+void test_fused_mixed_expression()
+  {
+  auto const a = cpa::rational{3, 4};
+  auto const b = cpa::rational{2, 9};
+  auto const c = cpa::rational{5, 6};
+
+  auto const r1 = (cpa::fuse(a) * b - c / cpa::fuse(b)).evaluate();
+  auto const r2 = -(cpa::fuse(a) + b) * c;
+  auto const expected = a * b - c / b;
+
+  ASSERT_EQUAL(expected.numerator(), r1.numerator());
+  ASSERT_EQUAL(expected.denominator(), r1.denominator());
+  ASSERT_EQUAL(-175, r2.evaluate().numerator());
+  ASSERT_EQUAL(216, r2.evaluate().denominator());
+  }
+
+void test_fused_expression_is_constexpr()
+  {
+  constexpr auto r1 = (cpa::fuse(cpa::rational{1, 2}) * cpa::rational{2, 3} + cpa::rational{1, 6}).evaluate();
+
+  static_assert(r1.numerator() == 1, "1/2 * 2/3 + 1/6 must be 1/2");
+  static_assert(r1.denominator() == 2, "1/2 * 2/3 + 1/6 must be 1/2");
+  }
+
+void test_fused_division_by_zero()
+  {
+  auto const expression = cpa::fuse(cpa::rational{1, 2}) / cpa::rational{0};
+
+  ASSERT_THROWS(expression.evaluate(), std::domain_error);
+  }
+
+void test_fused_expression_with_lazy_policy()
+  {
+  using rational = cpa::basic_rational<std::int64_t, cpa::lazy_normalization>;
+
+  auto const r1 = (cpa::fuse(rational{3, 4}) / rational{-3, 8}).evaluate();
+
+  ASSERT(r1.known_canonical());
+  ASSERT_EQUAL(-2, r1.numerator());
+  ASSERT_EQUAL(1, r1.denominator());
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"Evaluate a fused sum",
+             test_fused_sum};
+  suite += T{"Evaluate a fused sum of terms with a common denominator",
+             test_fused_sum_with_common_denominators};
+  suite += T{"Evaluate a fused sum over the least common denominator",
+             test_fused_sum_uses_least_common_denominator};
+  suite += T{"Evaluate a fused expression of sums and products",
+             test_fused_mixed_expression};
+  suite += T{"Evaluate a fused expression at compile time",
+             test_fused_expression_is_constexpr};
+  suite += T{"A fused division by zero throws on evaluation",
+             test_fused_division_by_zero};
+  suite += T{"Evaluate a fused expression with lazy normalization",
+             test_fused_expression_with_lazy_policy};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::expression");
+  }
@@ -0,0 +1,109 @@
+// @CMAKE_CUTE_LIBRARY=cpa_extern_templates
+
+#include <numeric.h>
+#include <rational.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#if !defined(CPA_EXTERN_TEMPLATES)
+#error "Linking against cpa_extern_templates must define CPA_EXTERN_TEMPLATES"
+#endif
+
+namespace
+  {
+  template<typename Rep>
+  void check_arithmetic()
+    {
+    auto const half = cpa::basic_rational<Rep>{1, 2};
+    auto const third = cpa::basic_rational<Rep>{1, 3};
+
+    ASSERT_EQUAL((cpa::basic_rational<Rep>{5, 6}), half + third);
+    ASSERT_EQUAL((cpa::basic_rational<Rep>{1, 6}), half - third);
+    ASSERT_EQUAL((cpa::basic_rational<Rep>{1, 6}), half * third);
+    ASSERT_EQUAL((cpa::basic_rational<Rep>{3, 2}), half / third);
+
+    auto value = half;
+    value += third;
+    value -= half;
+    value *= half;
+    value /= third;
+    ASSERT_EQUAL(half, value.reduce());
+    }
+
+  template<typename Rep>
+  void check_comparison()
+    {
+    auto const half = cpa::basic_rational<Rep>{1, 2};
+    auto const third = cpa::basic_rational<Rep>{1, 3};
+
+    ASSERT(half == (cpa::basic_rational<Rep>{2, 4}));
+    ASSERT(half != third);
+    ASSERT(third < half);
+    ASSERT(half > third);
+    ASSERT(third <= half);
+    ASSERT(half >= half);
+    }
+  }
+
+void test_extern_instantiations_of_arithmetic()
+  {
+  check_arithmetic<int>();
+  check_arithmetic<long>();
+  check_arithmetic<long long>();
+  check_arithmetic<unsigned int>();
+  check_arithmetic<unsigned long>();
+  check_arithmetic<unsigned long long>();
+  }
+
+void test_extern_instantiations_of_comparison()
+  {
+  check_comparison<int>();
+  check_comparison<long>();
+  check_comparison<long long>();
+  check_comparison<unsigned int>();
+  check_comparison<unsigned long>();
+  check_comparison<unsigned long long>();
+  }
+
+void test_extern_instantiations_of_gcd_and_lcm()
+  {
+  ASSERT_EQUAL(6, cpa::gcd(-12, 18));
+  ASSERT_EQUAL(36l, cpa::lcm(12l, 18l));
+  ASSERT_EQUAL(6ull, cpa::gcd(12ull, 18ull));
+  ASSERT_EQUAL(36u, cpa::lcm(12u, 18u));
+  }
+
+void test_extern_instantiations_remain_constexpr()
+  {
+  constexpr auto sum = cpa::basic_rational<long>{1, 2} + cpa::basic_rational<long>{1, 3};
+  static_assert(sum.denominator() == 6, "explicitly instantiated operators must be usable in constant expressions");
+  static_assert(cpa::gcd(12, 18) == 6, "explicitly instantiated gcd must be usable in constant expressions");
+
+  ASSERT_EQUAL(5, sum.numerator());
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"Arithmetic operators of the explicitly instantiated representation types",
+             test_extern_instantiations_of_arithmetic};
+  suite += T{"Comparison operators of the explicitly instantiated representation types",
+             test_extern_instantiations_of_comparison};
+  suite += T{"gcd and lcm of the explicitly instantiated representation types",
+             test_extern_instantiations_of_gcd_and_lcm};
+  suite += T{"Explicitly instantiated functions remain usable in constant expressions",
+             test_extern_instantiations_remain_constexpr};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::extern_templates");
+  }
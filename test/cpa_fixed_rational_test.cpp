@@ -0,0 +1,213 @@
+#include <fixed_rational.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+namespace
+  {
+  using cents = cpa::decimal<std::int64_t, 2>;
+  using micros = cpa::decimal<std::int64_t, 6>;
+  using sixteenths = cpa::fixed_rational<std::int32_t, 16>;
+
+  __extension__ typedef __int128 int128;
+
+  constexpr cents operator "" _cents(unsigned long long const numerator)
+    {
+    return cents::from_numerator(static_cast<std::int64_t>(numerator));
+    }
+  }
+
+void test_fixed_rational_stores_only_the_numerator()
+  {
+  static_assert(sizeof(cents) == sizeof(std::int64_t), "a fixed_rational must have the size of its representation type");
+  static_assert(sizeof(sixteenths) == sizeof(std::int32_t), "a fixed_rational must have the size of its representation type");
+  static_assert(micros::denominator() == 1000000, "decimal<Rep, 6> must have the denominator 10^6");
+
+  constexpr auto value = cents{12};
+
+  ASSERT_EQUAL(1200, value.numerator());
+  ASSERT_EQUAL(100, value.denominator());
+  ASSERT_EQUAL(0, cents{}.numerator());
+  }
+
+void test_fixed_rational_addition_and_subtraction()
+  {
+  constexpr auto sum = 1999_cents + 1_cents;
+  static_assert(sum.numerator() == 2000, "addition must add the numerators");
+
+  auto balance = 10000_cents;
+  balance -= 2550_cents;
+  balance += 1_cents;
+
+  ASSERT_EQUAL(7451_cents, balance);
+  ASSERT_EQUAL(-7451, (-balance).numerator());
+  ASSERT_EQUAL(-449, (2550_cents - 2999_cents).numerator());
+  }
+
+void test_fixed_rational_multiplication_rounds_to_nearest()
+  {
+  ASSERT_EQUAL(3702_cents, 1234_cents * cents{3});
+  ASSERT_EQUAL(2_cents, 1_cents * 150_cents);
+  ASSERT_EQUAL(1_cents, 1_cents * 50_cents);
+  ASSERT_EQUAL(0_cents, 1_cents * 49_cents);
+  ASSERT_EQUAL(-2, (-1_cents * 150_cents).numerator());
+  ASSERT_EQUAL(-1, (1_cents * -50_cents).numerator());
+  ASSERT_EQUAL(2, (-1_cents * -150_cents).numerator());
+  }
+
+void test_fixed_rational_multiplication_by_a_power_of_two_denominator()
+  {
+  using sixteenth = sixteenths;
+
+  static_assert((sixteenth::from_numerator(24) * sixteenth::from_numerator(40)).numerator() == 60,
+                "1.5 * 2.5 must be 3.75");
+
+  ASSERT_EQUAL(1, (sixteenth::from_numerator(1) * sixteenth::from_numerator(8)).numerator());
+  ASSERT_EQUAL(0, (sixteenth::from_numerator(1) * sixteenth::from_numerator(7)).numerator());
+  ASSERT_EQUAL(-1, (sixteenth::from_numerator(-1) * sixteenth::from_numerator(8)).numerator());
+  }
+
+void test_fixed_rational_multiplication_of_wide_intermediates()
+  {
+  auto const price = micros::from_numerator(3000000123456);
+  auto const quantity = micros::from_numerator(2500000000);
+
+  ASSERT_EQUAL(7500000308640000, (price * quantity).numerator());
+  ASSERT_EQUAL(750000030864000, (price * 250).numerator());
+  ASSERT_EQUAL(750000030864000, (250 * price).numerator());
+  }
+
+void test_fixed_rational_division_rounds_to_nearest()
+  {
+  ASSERT_EQUAL(33_cents, cents{1} / cents{3});
+  ASSERT_EQUAL(67_cents, cents{2} / cents{3});
+  ASSERT_EQUAL(-67, (cents{-2} / cents{3}).numerator());
+  ASSERT_EQUAL(cents{4}, cents{10} / 250_cents);
+
+  auto const large = micros::from_numerator(std::numeric_limits<std::int64_t>::max() / 2);
+  ASSERT_EQUAL(large, large / micros{1});
+  }
+
+void test_fixed_rational_division_by_zero_throws()
+  {
+  ASSERT_THROWS(cents{1} / cents{}, std::domain_error);
+  }
+
+void test_fixed_rational_converts_losslessly_from_and_to_basic_rational()
+  {
+  auto const quarter = cents{cpa::rational{1, 4}};
+  auto const negative = cents{cpa::rational{3, -20}};
+
+  ASSERT_EQUAL(25_cents, quarter);
+  ASSERT_EQUAL(-15, negative.numerator());
+
+  cpa::rational const back = negative;
+  ASSERT_EQUAL((cpa::rational{-3, 20}), back);
+  ASSERT_EQUAL(100, back.denominator());
+
+  cpa::basic_rational<std::int64_t, cpa::eager_normalization> const canonical = quarter;
+  ASSERT_EQUAL(1, canonical.numerator());
+  ASSERT_EQUAL(4, canonical.denominator());
+  }
+
+void test_fixed_rational_rejects_lossy_conversions()
+  {
+  ASSERT_THROWS(cents{(cpa::rational{1, 3})}, std::domain_error);
+  ASSERT_THROWS(cents{(cpa::rational{std::numeric_limits<std::int64_t>::max(), 2})}, std::domain_error);
+
+  auto const minimum = cpa::fixed_rational<std::int64_t, 1>{(cpa::rational{std::numeric_limits<std::int64_t>::min()})};
+  ASSERT_EQUAL(std::numeric_limits<std::int64_t>::min(), minimum.numerator());
+  }
+
+void test_fixed_rational_rejects_conversions_without_a_wider_type()
+  {
+  using hundredths = cpa::fixed_rational<int128, 100>;
+  auto const large = (int128{1} << 126) + 1;
+
+  ASSERT_THROWS(hundredths{cpa::basic_rational<int128>{large}}, std::domain_error);
+  ASSERT_THROWS(hundredths::round(cpa::basic_rational<int128>{large, 3}), std::domain_error);
+
+  auto const cancelled = hundredths{cpa::basic_rational<int128>{large, 100}};
+  ASSERT(large == cancelled.numerator());
+
+  auto const rounded = hundredths::round(cpa::basic_rational<int128>{-large, 300});
+  ASSERT(-(large / 3 + 1) == rounded.numerator());
+  }
+
+void test_fixed_rational_round_from_basic_rational()
+  {
+  ASSERT_EQUAL(33_cents, cents::round(cpa::rational{1, 3}));
+  ASSERT_EQUAL(67_cents, cents::round(cpa::rational{2, 3}));
+  ASSERT_EQUAL(1_cents, cents::round(cpa::rational{1, 200}));
+  ASSERT_EQUAL(-1, cents::round(cpa::rational{-1, 200}).numerator());
+  ASSERT_EQUAL(25_cents, cents::round(cpa::rational{1, 4}));
+  }
+
+void test_fixed_rational_comparison()
+  {
+  ASSERT(1_cents < 2_cents);
+  ASSERT(2_cents > 1_cents);
+  ASSERT(2_cents <= 2_cents);
+  ASSERT(2_cents >= 1_cents);
+  ASSERT(2_cents != 1_cents);
+  ASSERT(cents{1} == 100_cents);
+  ASSERT(!cents{});
+  ASSERT(static_cast<bool>(1_cents));
+  ASSERT_EQUAL_DELTA(0.25l, static_cast<long double>(25_cents), 1e-12l);
+  }
+
+void test_fixed_rational_hash()
+  {
+  auto const hash = std::hash<cents>{};
+
+  ASSERT_EQUAL(hash(cents{1}), hash(100_cents));
+  ASSERT(hash(1_cents) != hash(2_cents));
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"A fixed_rational stores only its numerator",
+             test_fixed_rational_stores_only_the_numerator};
+  suite += T{"Add and subtract fixed_rational objects",
+             test_fixed_rational_addition_and_subtraction};
+  suite += T{"Multiplication of fixed_rational objects rounds to nearest",
+             test_fixed_rational_multiplication_rounds_to_nearest};
+  suite += T{"Multiply fixed_rational objects with a power of two denominator",
+             test_fixed_rational_multiplication_by_a_power_of_two_denominator};
+  suite += T{"Multiply fixed_rational objects whose product exceeds the representation type",
+             test_fixed_rational_multiplication_of_wide_intermediates};
+  suite += T{"Division of fixed_rational objects rounds to nearest",
+             test_fixed_rational_division_rounds_to_nearest};
+  suite += T{"Division of a fixed_rational by 0 throws",
+             test_fixed_rational_division_by_zero_throws};
+  suite += T{"Convert losslessly between fixed_rational and basic_rational",
+             test_fixed_rational_converts_losslessly_from_and_to_basic_rational};
+  suite += T{"Lossy conversions from basic_rational to fixed_rational throw",
+             test_fixed_rational_rejects_lossy_conversions};
+  suite += T{"Conversions to 128-bit fixed_rational objects reject overflows",
+             test_fixed_rational_rejects_conversions_without_a_wider_type};
+  suite += T{"Round a basic_rational to a fixed_rational",
+             test_fixed_rational_round_from_basic_rational};
+  suite += T{"Compare fixed_rational objects",
+             test_fixed_rational_comparison};
+  suite += T{"Hash fixed_rational objects",
+             test_fixed_rational_hash};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::fixed_rational");
+  }
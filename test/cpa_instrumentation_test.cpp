@@ -0,0 +1,230 @@
+// @CMAKE_CUTE_LIBRARY=pthread
+
+#if !defined(CPA_INSTRUMENTATION)
+#define CPA_INSTRUMENTATION
+#endif
+
+#include <instrumentation.h>
+#include <numeric.h>
+#include <parallel.h>
+#include <rational.h>
+#include <rational_vector.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace
+  {
+  using cpa::instrumentation::operation;
+
+  std::uint64_t calls(operation const which)
+    {
+    return cpa::instrumentation::snapshot()[which].calls;
+    }
+  }
+
+void test_gcd_counts_calls_iterations_and_magnitudes()
+  {
+  cpa::instrumentation::reset();
+
+  ASSERT_EQUAL(6, cpa::gcd(12, 18));
+  ASSERT_EQUAL(1u, cpa::gcd(21u, 13u));
+
+  auto const report = cpa::instrumentation::snapshot();
+  ASSERT_EQUAL(2u, report[operation::gcd].calls);
+  ASSERT(report[operation::gcd].iterations >= 2u);
+  ASSERT_EQUAL(1u, report[operation::gcd].magnitudes[3]);
+  ASSERT_EQUAL(1u, report[operation::gcd].magnitudes[1]);
+  ASSERT_EQUAL(0u, report[operation::lcm].calls);
+  }
+
+void test_fibonacci_operands_need_more_iterations()
+  {
+  cpa::instrumentation::reset();
+  cpa::gcd(std::uint64_t{12200160415121876738u}, std::uint64_t{7540113804746346429u});
+  auto const fibonacci = cpa::instrumentation::snapshot()[operation::gcd].iterations;
+
+  cpa::instrumentation::reset();
+  cpa::gcd(std::uint64_t{12200160415121876736u}, std::uint64_t{4096u});
+  auto const power_of_two = cpa::instrumentation::snapshot()[operation::gcd].iterations;
+
+  ASSERT(fibonacci > power_of_two);
+  }
+
+void test_lcm_counts_its_gcd()
+  {
+  cpa::instrumentation::reset();
+
+  ASSERT_EQUAL(36, cpa::lcm(12, 18));
+
+  auto const report = cpa::instrumentation::snapshot();
+  ASSERT_EQUAL(1u, report[operation::lcm].calls);
+  ASSERT_EQUAL(1u, report[operation::lcm].magnitudes[6]);
+  ASSERT_EQUAL(1u, report[operation::gcd].calls);
+  }
+
+void test_rational_operations_are_counted()
+  {
+  cpa::instrumentation::reset();
+
+  auto value = cpa::rational{6, 8};
+  auto const reduced = value.reduce();
+  value.reduce();
+  auto const common = reduced.common(cpa::rational{1, 6});
+  auto const expanded = reduced.expand(100);
+
+  ASSERT_EQUAL(12, common.denominator());
+  ASSERT_EQUAL(400, expanded.denominator());
+
+  auto const report = cpa::instrumentation::snapshot();
+  ASSERT_EQUAL(2u, report[operation::reduce].calls);
+  ASSERT_EQUAL(2u, report[operation::reduce].magnitudes[3]);
+  ASSERT_EQUAL(1u, report[operation::common].calls);
+  ASSERT_EQUAL(1u, report[operation::common].magnitudes[4]);
+  ASSERT_EQUAL(1u, report[operation::expand].calls);
+  ASSERT_EQUAL(1u, report[operation::expand].magnitudes[9]);
+  ASSERT_EQUAL(1u, report[operation::lcm].calls);
+  }
+
+void test_batched_operations_are_counted()
+  {
+  auto lhs = std::vector<std::int64_t>(100, 12);
+  auto rhs = std::vector<std::int64_t>(100, 18);
+  auto gcds = std::vector<std::int64_t>(100);
+
+  cpa::instrumentation::reset();
+  cpa::gcd(lhs.begin(), lhs.end(), rhs.begin(), gcds.begin());
+
+  auto const report = cpa::instrumentation::snapshot();
+  ASSERT_EQUAL(100u, report[operation::gcd].calls);
+  ASSERT_EQUAL(100u, report[operation::gcd].magnitudes[3]);
+  ASSERT(report[operation::gcd].iterations >= 100u);
+
+  auto values = cpa::rational_vector<std::int64_t>{};
+  for(int index{}; index < 10; ++index)
+    {
+    values.push_back(cpa::rational{2, 4});
+    }
+
+  cpa::instrumentation::reset();
+  values.reduce();
+
+  ASSERT_EQUAL(10u, calls(operation::reduce));
+  ASSERT_EQUAL(10u, calls(operation::gcd));
+  }
+
+void test_counters_of_all_threads_are_aggregated()
+  {
+  cpa::instrumentation::reset();
+
+  auto workers = std::vector<std::thread>{};
+  for(int worker{}; worker < 4; ++worker)
+    {
+    workers.emplace_back([]
+      {
+      for(int index{1}; index <= 1000; ++index)
+        {
+        cpa::gcd(index, 360);
+        }
+      });
+    }
+
+  for(auto & worker : workers)
+    {
+    worker.join();
+    }
+
+  ASSERT_EQUAL(4000u, calls(operation::gcd));
+
+  auto counted = std::promise<void>{};
+  auto finish = std::promise<void>{};
+  auto finished = finish.get_future();
+
+  auto live = std::thread{[&]
+    {
+    cpa::lcm(4, 6);
+    counted.set_value();
+    finished.wait();
+    }};
+
+  counted.get_future().wait();
+  ASSERT_EQUAL(1u, calls(operation::lcm));
+  ASSERT_EQUAL(4001u, calls(operation::gcd));
+
+  cpa::instrumentation::reset();
+  ASSERT_EQUAL(0u, calls(operation::lcm));
+
+  finish.set_value();
+  live.join();
+  }
+
+/*
+ * This test runs first, so that the thread pool is created before the counters, and its workers exit after the counters
+ * would have been destroyed at the end of the program.
+ */
+void test_parallel_algorithms_are_counted()
+  {
+  auto terms = std::vector<cpa::rational>{};
+  for(int index{}; index < 400000; ++index)
+    {
+    terms.push_back(cpa::rational{index % 7 - 3, index % 5 + 2});
+    }
+
+  auto const result = cpa::parallel::sum(terms.begin(), terms.end(), 4);
+
+  ASSERT((result == cpa::sum(terms.begin(), terms.end())));
+  ASSERT(calls(operation::gcd) > 0u);
+  }
+
+void test_constant_evaluation_is_not_counted()
+  {
+  cpa::instrumentation::reset();
+
+  constexpr auto gcd = cpa::gcd(12, 18);
+  constexpr auto value = cpa::rational{6, 8};
+  constexpr auto reduced = value.reduce();
+  static_assert(gcd == 6, "gcd must be usable in constant expressions");
+  static_assert(reduced.denominator() == 4, "reduce must be usable in constant expressions");
+
+  ASSERT(cpa::instrumentation::enabled);
+  ASSERT_EQUAL(0u, calls(operation::gcd));
+  ASSERT_EQUAL(0u, calls(operation::reduce));
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"Parallel algorithms are counted on the threads of the pool",
+             test_parallel_algorithms_are_counted};
+  suite += T{"gcd counts calls, iterations and result magnitudes",
+             test_gcd_counts_calls_iterations_and_magnitudes};
+  suite += T{"Fibonacci operands need more gcd iterations",
+             test_fibonacci_operands_need_more_iterations};
+  suite += T{"lcm counts itself and its gcd",
+             test_lcm_counts_its_gcd};
+  suite += T{"reduce, common and expand are counted",
+             test_rational_operations_are_counted};
+  suite += T{"Batched gcd and reduce count every element",
+             test_batched_operations_are_counted};
+  suite += T{"Counters of all threads are aggregated",
+             test_counters_of_all_threads_are_aggregated};
+  suite += T{"Constant evaluation is not counted",
+             test_constant_evaluation_is_not_counted};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::instrumentation");
+  }
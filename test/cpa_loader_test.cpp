@@ -0,0 +1,129 @@
+// @CMAKE_CUTE_LIBRARY=pthread
+
+#include <loader.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+  {
+  std::string make_text(std::intmax_t const count)
+    {
+    auto text = std::string{};
+
+    for(auto index = std::intmax_t{}; index < count; ++index)
+      {
+      text += std::to_string(index % 2 ? -index : index) + "/" + std::to_string(2 * index + 2) + (index % 7 ? "\n" : "\r\n");
+      }
+
+    return text;
+    }
+
+  void check_values(std::vector<cpa::rational> const & values, std::intmax_t const count)
+    {
+    ASSERT_EQUAL(static_cast<std::size_t>(count), values.size());
+
+    for(auto index = std::intmax_t{}; index < count; ++index)
+      {
+      auto const expected = cpa::rational{index % 2 ? -index : index, 2 * index + 2}.reduce();
+      auto const & actual = values[static_cast<std::size_t>(index)];
+
+      ASSERT_EQUAL(expected.numerator(), actual.numerator());
+      ASSERT_EQUAL(expected.denominator(), actual.denominator());
+      }
+    }
+  }
+
+void test_parse_lines_in_parallel()
+  {
+  auto const text = make_text(200000);
+
+  for(auto threads : {1u, 3u, 8u})
+    {
+    check_values(cpa::parallel::parse(text.data(), text.data() + text.size(), threads), 200000);
+    }
+  }
+
+void test_parse_skips_empty_lines()
+  {
+  auto const text = std::string{"\n1/2\n\r\n-3\n\n5/10"};
+  auto const values = cpa::parallel::parse(text.data(), text.data() + text.size(), 2);
+
+  ASSERT_EQUAL(3u, values.size());
+  ASSERT_EQUAL(1, values[0].numerator());
+  ASSERT_EQUAL(-3, values[1].numerator());
+  ASSERT_EQUAL(1, values[2].numerator());
+  ASSERT_EQUAL(2, values[2].denominator());
+  }
+
+void test_parse_rejects_invalid_lines()
+  {
+  auto text = make_text(100000);
+  text += "1/2 3\n";
+  text += make_text(10);
+
+  ASSERT_THROWS(cpa::parallel::parse(text.data(), text.data() + text.size(), 4), std::domain_error);
+
+  auto const narrow = std::string{"1/2\n300/7\n"};
+  ASSERT_THROWS(cpa::parallel::parse<cpa::basic_rational<std::int8_t>>(narrow.data(), narrow.data() + narrow.size()),
+                std::domain_error);
+  }
+
+void test_load_file()
+  {
+  char path[] = "/tmp/cpa_loader_test_XXXXXX";
+  auto const descriptor = ::mkstemp(path);
+  ASSERT(descriptor >= 0);
+
+  auto const text = make_text(150000);
+  auto const written = ::write(descriptor, text.data(), text.size());
+  ::close(descriptor);
+  ASSERT_EQUAL(static_cast<ssize_t>(text.size()), written);
+
+  auto const values = cpa::parallel::load(path, 4);
+  ::unlink(path);
+
+  check_values(values, 150000);
+  }
+
+void test_load_missing_file()
+  {
+  ASSERT_THROWS(cpa::parallel::load("/nonexistent/cpa_loader_test"), std::system_error);
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"Parse lines of rationals in parallel",
+             test_parse_lines_in_parallel};
+  suite += T{"Parsing skips empty lines",
+             test_parse_skips_empty_lines};
+  suite += T{"Parsing rejects invalid lines",
+             test_parse_rejects_invalid_lines};
+  suite += T{"Load a file of rationals",
+             test_load_file};
+  suite += T{"Loading a missing file throws",
+             test_load_missing_file};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::loader");
+  }
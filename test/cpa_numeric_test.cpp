@@ -5,8 +5,19 @@
 #include <cute/xml_listener.h>
 #include <cute/cute_runner.h>
 
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <sstream>
 #include <stdexcept>
+#include <vector>
+
+namespace
+  {
+  __extension__ typedef unsigned __int128 uint128;
+  }
 
 void test_abs_with_positive_int()
   {
@@ -88,6 +99,330 @@ void test_gcd_with_negative_negative_mixed_ints()
   ASSERT_EQUAL(1, cpa::gcd(-19, -30));
   }
 
+void test_gcd_with_zero_operands()
+  {
+  ASSERT_EQUAL(0, cpa::gcd(0, 0));
+  ASSERT_EQUAL(7, cpa::gcd(0, -7));
+  ASSERT_EQUAL(9, cpa::gcd(9, 0));
+  }
+
+void test_gcd_with_wide_ints()
+  {
+  auto constexpr left = std::uint64_t{3} << 40;
+  auto constexpr right = std::uint64_t{9} << 35;
+
+  ASSERT_EQUAL(std::uint64_t{3} << 35, cpa::gcd(left, right));
+  ASSERT_EQUAL(std::int64_t{6700417}, cpa::gcd(std::int64_t{4294967297}, std::int64_t{-6700417} * 3));
+  }
+
+void test_gcd_with_most_negative_int()
+  {
+  ASSERT_EQUAL(std::int64_t{2}, cpa::gcd(std::numeric_limits<std::int64_t>::min(), std::int64_t{6}));
+  }
+
+void test_gcd_with_mixed_signedness()
+  {
+  ASSERT_EQUAL(2u, cpa::gcd(-4, 6u));
+  ASSERT_EQUAL(2u, cpa::gcd(6u, -4));
+  ASSERT_EQUAL(std::uint64_t{3}, cpa::gcd(std::int32_t{-9}, std::uint64_t{12}));
+  ASSERT_EQUAL(std::uint32_t{1} << 31, cpa::gcd(std::numeric_limits<std::int32_t>::min(), std::uint32_t{0}));
+  static_assert(cpa::gcd(-4, 6u) == 2u, "cpa::gcd must use the magnitude of signed operands");
+  }
+
+void test_gcd_with_narrow_ints()
+  {
+  ASSERT_EQUAL(short{4}, cpa::gcd(short{-12}, short{8}));
+  ASSERT_EQUAL(static_cast<unsigned char>(5), cpa::gcd(static_cast<unsigned char>(250), static_cast<unsigned char>(15)));
+  }
+
+void test_gcd_is_constexpr()
+  {
+  static_assert(cpa::gcd(1071, 462) == 21, "cpa::gcd must be usable in constant expressions");
+  static_assert(cpa::narrowing_gcd{}(1071, 462) == 21, "cpa::narrowing_gcd must be usable in constant expressions");
+  static_assert(cpa::euclidean_gcd{}(1071, 462) == 21, "cpa::euclidean_gcd must be usable in constant expressions");
+  }
+
+void test_gcd_algorithms_agree_on_fibonacci_pairs()
+  {
+  auto previous = std::uint64_t{1};
+  auto current = std::uint64_t{2};
+
+  while(current < (std::uint64_t{1} << 62))
+    {
+    auto const scaled_previous = previous * 6;
+    auto const scaled_current = current * 6;
+
+    ASSERT_EQUAL(std::uint64_t{6}, cpa::binary_gcd{}(scaled_previous, scaled_current));
+    ASSERT_EQUAL(std::uint64_t{6}, cpa::narrowing_gcd{}(scaled_previous, scaled_current));
+    ASSERT_EQUAL(std::uint64_t{6}, cpa::euclidean_gcd{}(scaled_previous, scaled_current));
+
+    auto const next = previous + current;
+    previous = current;
+    current = next;
+    }
+  }
+
+void test_gcd_algorithm_selection()
+  {
+  ASSERT((cpa::is_same_v<cpa::binary_gcd, cpa::gcd_algorithm_t<long>>));
+  ASSERT((cpa::is_same_v<cpa::binary_gcd, cpa::gcd_algorithm_t<unsigned short>>));
+  ASSERT((cpa::is_same_v<cpa::euclidean_gcd, cpa::gcd_algorithm_t<double>>));
+  }
+
+void test_batch_gcd_with_arrays()
+  {
+  auto left = std::vector<std::int64_t>{};
+  auto right = std::vector<std::int64_t>{};
+
+  for(auto index = std::int64_t{}; index < 1000; ++index)
+    {
+    left.push_back((index % 2 ? -1 : 1) * index * 7919 * 6);
+    right.push_back((index * 104729 + 13) * 4);
+    }
+
+  auto result = std::vector<std::int64_t>(left.size());
+  auto end = cpa::gcd(left.cbegin(), left.cend(), right.cbegin(), result.begin());
+
+  ASSERT(end == result.end());
+
+  for(auto index = std::size_t{}; index < left.size(); ++index)
+    {
+    ASSERT_EQUAL(cpa::gcd(left[index], right[index]), result[index]);
+    }
+  }
+
+void test_batch_gcd_with_narrow_lists()
+  {
+  auto const left = std::list<short>{0, 12, -18, 0, 35, 1, 4096};
+  auto const right = std::list<short>{0, 0, 24, -9, 14, 1, 1024};
+  auto result = std::vector<short>{};
+
+  cpa::gcd(left.begin(), left.end(), right.begin(), std::back_inserter(result));
+
+  ASSERT_EQUAL((std::vector<short>{0, 12, 6, 9, 7, 1, 1024}), result);
+  }
+
+void test_batch_lcm_with_arrays()
+  {
+  std::uint32_t const left[] = {4, 6, 0, 21, 7, 9, 10, 16, 25};
+  std::uint32_t const right[] = {6, 4, 0, 6, 0, 9, 15, 48, 30};
+  std::uint32_t result[9] = {};
+
+  cpa::lcm(std::begin(left), std::end(left), std::begin(right), std::begin(result));
+
+  std::uint32_t const expected[] = {12, 12, 0, 42, 0, 9, 30, 48, 150};
+  ASSERT(std::equal(std::begin(expected), std::end(expected), std::begin(result)));
+  }
+
+void test_range_gcd()
+  {
+  auto const values = std::list<long>{-84, 126, 0, 210, -294};
+  ASSERT_EQUAL(42, cpa::gcd(values.begin(), values.end()));
+
+  auto const empty = std::vector<int>{};
+  ASSERT_EQUAL(0, cpa::gcd(empty.begin(), empty.end()));
+
+  auto const zeros = std::vector<int>{0, 0};
+  ASSERT_EQUAL(0, cpa::gcd(zeros.begin(), zeros.end()));
+  }
+
+void test_range_gcd_stops_at_one()
+  {
+  auto input = std::istringstream{"12 18 35 not-a-number"};
+
+  ASSERT_EQUAL(1, cpa::gcd(std::istream_iterator<int>{input}, std::istream_iterator<int>{}));
+  ASSERT(!input.fail());
+  }
+
+void test_range_lcm()
+  {
+  auto const values = std::list<long>{4, -6, 10, 15, -9};
+  ASSERT_EQUAL(180, cpa::lcm(values.begin(), values.end()));
+
+  auto const primes = std::vector<std::uint64_t>{2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47};
+  ASSERT_EQUAL(614889782588491410ull, cpa::lcm(primes.begin(), primes.end()));
+
+  auto const empty = std::vector<int>{};
+  ASSERT_EQUAL(1, cpa::lcm(empty.begin(), empty.end()));
+
+  auto const with_zero = std::vector<int>{4, 0, 6};
+  ASSERT_EQUAL(0, cpa::lcm(with_zero.begin(), with_zero.end()));
+  }
+
+void test_range_lcm_detects_overflow()
+  {
+  auto const primes = std::vector<std::int32_t>{2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
+  ASSERT_THROWS(cpa::lcm(primes.begin(), primes.end()), std::domain_error);
+
+  auto const most_negative = std::vector<std::int32_t>{std::numeric_limits<std::int32_t>::min()};
+  ASSERT_THROWS(cpa::lcm(most_negative.begin(), most_negative.end()), std::domain_error);
+  }
+
+void test_range_lcm_with_wider_result()
+  {
+  auto const primes = std::vector<std::int32_t>{2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
+  ASSERT_EQUAL(6469693230ll, cpa::lcm<std::int64_t>(primes.begin(), primes.end()));
+
+  auto const most_negative = std::vector<std::int32_t>{std::numeric_limits<std::int32_t>::min(), 3};
+  ASSERT_EQUAL(6442450944ll, cpa::lcm<std::int64_t>(most_negative.begin(), most_negative.end()));
+  }
+
+void test_extended_gcd_satisfies_bezouts_identity()
+  {
+  for(int lhs{-60}; lhs <= 60; ++lhs)
+    {
+    for(int rhs{-60}; rhs <= 60; ++rhs)
+      {
+      auto const result = cpa::extended_gcd(lhs, rhs);
+
+      ASSERT_EQUAL(cpa::abs(cpa::gcd(lhs, rhs)), result.gcd);
+      ASSERT_EQUAL(result.gcd, lhs * result.x + rhs * result.y);
+      }
+    }
+
+  auto const result = cpa::extended_gcd(240, 46);
+  ASSERT_EQUAL(2, result.gcd);
+  ASSERT_EQUAL(-9, result.x);
+  ASSERT_EQUAL(47, result.y);
+  }
+
+void test_extended_gcd_with_extreme_64_bit_ints()
+  {
+  auto const minimum = std::numeric_limits<std::int64_t>::min();
+  auto const maximum = std::numeric_limits<std::int64_t>::max();
+
+  auto const coprime = cpa::extended_gcd(maximum, maximum - 1);
+  ASSERT_EQUAL(1, coprime.gcd);
+  ASSERT_EQUAL(1, coprime.x);
+  ASSERT_EQUAL(-1, coprime.y);
+
+  auto const most_negative = cpa::extended_gcd(minimum, std::int64_t{6});
+  ASSERT_EQUAL(2, most_negative.gcd);
+  ASSERT_EQUAL(-1, most_negative.x);
+  ASSERT_EQUAL(-1537228672809129301, most_negative.y);
+  }
+
+void test_extended_gcd_is_constexpr()
+  {
+  constexpr auto result = cpa::extended_gcd(35, -15);
+  static_assert(result.gcd == 5 && 35 * result.x - 15 * result.y == 5, "extended_gcd must be usable in constant expressions");
+
+  ASSERT_EQUAL(5, result.gcd);
+  }
+
+void test_mod_inverse()
+  {
+  ASSERT_EQUAL(4, cpa::mod_inverse(3, 11));
+  ASSERT_EQUAL(7, cpa::mod_inverse(-3, 11));
+  ASSERT_EQUAL(0, cpa::mod_inverse(5, 1));
+  ASSERT_EQUAL(1u, cpa::mod_inverse(1u, 2u));
+  ASSERT_EQUAL(2u, cpa::mod_inverse(-3, 7u));
+  ASSERT_EQUAL(std::uint64_t{5}, cpa::mod_inverse(std::int32_t{-1}, std::uint64_t{6}));
+
+  for(std::uint32_t value{1}; value < 997; ++value)
+    {
+    ASSERT_EQUAL(1u, value * cpa::mod_inverse(value, 997u) % 997u);
+    }
+
+  static_assert(cpa::mod_inverse(3, 11) == 4, "mod_inverse must be usable in constant expressions");
+  }
+
+void test_mod_inverse_with_64_bit_moduli()
+  {
+  auto const modulus = std::uint64_t{18446744073709551557u};
+  auto const value = std::uint64_t{12345678901234567890u};
+  auto const inverse = cpa::mod_inverse(value, modulus);
+
+  ASSERT_EQUAL(1u, static_cast<std::uint64_t>(static_cast<uint128>(value) * inverse % modulus));
+  }
+
+void test_mod_inverse_rejects_invalid_arguments()
+  {
+  ASSERT_THROWS(cpa::mod_inverse(6, 9), std::domain_error);
+  ASSERT_THROWS(cpa::mod_inverse(0, 7), std::domain_error);
+  ASSERT_THROWS(cpa::mod_inverse(3, 0), std::domain_error);
+  ASSERT_THROWS(cpa::mod_inverse(3, -7), std::domain_error);
+  }
+
+void test_batch_mod_inverse()
+  {
+  auto const modulus = std::int64_t{1000000007};
+  auto const values = std::vector<std::int64_t>{1, 2, 3, -4, 1000000006, 123456789, 1000000008, 42};
+  auto inverses = std::vector<std::int64_t>(values.size());
+
+  auto const end = cpa::mod_inverse(values.begin(), values.end(), inverses.begin(), modulus);
+
+  ASSERT(end == inverses.end());
+  for(std::size_t index{}; index < values.size(); ++index)
+    {
+    ASSERT_EQUAL(cpa::mod_inverse(values[index], modulus), inverses[index]);
+    }
+  }
+
+void test_batch_mod_inverse_with_lists()
+  {
+  auto const values = std::list<std::uint64_t>{3, 5, 7, 18446744073709551556u};
+  auto inverses = std::list<std::uint64_t>(values.size());
+  auto const modulus = std::uint64_t{18446744073709551557u};
+
+  cpa::mod_inverse(values.begin(), values.end(), inverses.begin(), modulus);
+
+  auto value = values.begin();
+  for(auto const inverse : inverses)
+    {
+    ASSERT_EQUAL(1u, static_cast<std::uint64_t>(static_cast<uint128>(*value++) * inverse % modulus));
+    }
+  }
+
+void test_batch_mod_inverse_edge_cases()
+  {
+  auto const empty = std::vector<int>{};
+  auto inverses = std::vector<int>(1, -1);
+
+  ASSERT((cpa::mod_inverse(empty.begin(), empty.end(), inverses.begin(), 7) == inverses.begin()));
+  ASSERT_EQUAL(-1, inverses.front());
+
+  auto const single = std::vector<int>{3};
+  cpa::mod_inverse(single.begin(), single.end(), inverses.begin(), 7);
+  ASSERT_EQUAL(5, inverses.front());
+
+  auto const singular = std::vector<int>{3, 6, 5};
+  auto results = std::vector<int>(3);
+  ASSERT_THROWS(cpa::mod_inverse(singular.begin(), singular.end(), results.begin(), 9), std::domain_error);
+  }
+
+void test_batch_mod_inverse_in_place()
+  {
+  auto values = std::vector<int>{3, 5, 7, 11};
+  cpa::mod_inverse(values.begin(), values.end(), values.begin(), 13);
+  ASSERT_EQUAL((std::vector<int>{9, 8, 2, 6}), values);
+
+  auto const modulus = std::uint32_t{65521};
+  auto many = std::vector<std::uint32_t>{};
+  for(std::uint32_t value{1}; value < 1000; ++value)
+    {
+    many.push_back(value * 7919 % modulus);
+    }
+
+  auto const original = many;
+  cpa::mod_inverse(many.begin(), many.end(), many.begin(), modulus);
+
+  for(std::size_t index{}; index < many.size(); ++index)
+    {
+    ASSERT_EQUAL(cpa::mod_inverse(original[index], modulus), many[index]);
+    }
+  }
+
+void test_batch_mod_inverse_with_streams()
+  {
+  auto input = std::istringstream{"3 -5 7"};
+  auto output = std::ostringstream{};
+
+  cpa::mod_inverse(std::istream_iterator<int>{input}, std::istream_iterator<int>{}, std::ostream_iterator<int>{output, " "}, 13);
+
+  ASSERT_EQUAL("9 5 2 ", output.str());
+  }
+
 int main(int argc, char * argv[])
   {
   auto suite = cute::suite{};
@@ -130,6 +465,63 @@ int main(int argc, char * argv[])
   suite += T{"Calculate the Greatest Common Divisor of two negative mixed ints",
              test_gcd_with_negative_negative_mixed_ints};
 
+  suite += T{"Calculate the Greatest Common Divisor with zero operands",
+             test_gcd_with_zero_operands};
+  suite += T{"Calculate the Greatest Common Divisor of two 64-bit ints",
+             test_gcd_with_wide_ints};
+  suite += T{"Calculate the Greatest Common Divisor involving the most negative 64-bit int",
+             test_gcd_with_most_negative_int};
+  suite += T{"Calculate the Greatest Common Divisor of a signed and an unsigned int",
+             test_gcd_with_mixed_signedness};
+  suite += T{"Calculate the Greatest Common Divisor of two narrow ints",
+             test_gcd_with_narrow_ints};
+  suite += T{"Calculate the Greatest Common Divisor in a constant expression",
+             test_gcd_is_constexpr};
+  suite += T{"All GCD algorithms agree on scaled Fibonacci pairs",
+             test_gcd_algorithms_agree_on_fibonacci_pairs};
+  suite += T{"The GCD algorithm is selected per type",
+             test_gcd_algorithm_selection};
+
+  suite += T{"Calculate the Greatest Common Divisors of two arrays of 64-bit ints",
+             test_batch_gcd_with_arrays};
+  suite += T{"Calculate the Greatest Common Divisors of two lists of shorts",
+             test_batch_gcd_with_narrow_lists};
+  suite += T{"Calculate the Least Common Multiples of two arrays of unsigned ints",
+             test_batch_lcm_with_arrays};
+  suite += T{"Calculate the Greatest Common Divisor of a range",
+             test_range_gcd};
+  suite += T{"The Greatest Common Divisor of a range stops at 1",
+             test_range_gcd_stops_at_one};
+  suite += T{"Calculate the Least Common Multiple of a range",
+             test_range_lcm};
+  suite += T{"The Least Common Multiple of a range detects overflow",
+             test_range_lcm_detects_overflow};
+  suite += T{"Calculate the Least Common Multiple of a range in a wider type",
+             test_range_lcm_with_wider_result};
+
+  suite += T{"The extended GCD satisfies Bezout's identity",
+             test_extended_gcd_satisfies_bezouts_identity};
+  suite += T{"Calculate the extended GCD of extreme 64-bit ints",
+             test_extended_gcd_with_extreme_64_bit_ints};
+  suite += T{"Calculate the extended GCD in a constant expression",
+             test_extended_gcd_is_constexpr};
+  suite += T{"Calculate modular inverses",
+             test_mod_inverse};
+  suite += T{"Calculate modular inverses with 64-bit moduli",
+             test_mod_inverse_with_64_bit_moduli};
+  suite += T{"Modular inverses of non-coprime values or invalid moduli throw",
+             test_mod_inverse_rejects_invalid_arguments};
+  suite += T{"Calculate the modular inverses of an array of 64-bit ints",
+             test_batch_mod_inverse};
+  suite += T{"Calculate the modular inverses of a list of unsigned 64-bit ints",
+             test_batch_mod_inverse_with_lists};
+  suite += T{"Calculate the modular inverses of empty, single element and singular ranges",
+             test_batch_mod_inverse_edge_cases};
+  suite += T{"Calculate modular inverses of a range in place",
+             test_batch_mod_inverse_in_place};
+  suite += T{"Calculate modular inverses of a stream",
+             test_batch_mod_inverse_with_streams};
+
   auto file = cute::xml_file_opener{argc, argv};
   auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
 
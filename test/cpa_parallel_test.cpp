@@ -0,0 +1,207 @@
+// @CMAKE_CUTE_LIBRARY=pthread
+
+#include <parallel.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace
+  {
+  std::vector<cpa::rational> make_terms(std::intmax_t const count)
+    {
+    auto terms = std::vector<cpa::rational>{};
+
+    for(auto index = std::intmax_t{}; index < count; ++index)
+      {
+      auto const denominator = std::intmax_t{index % 4 == 0 ? 6 : (index % 4 == 1 ? 10 : (index % 4 == 2 ? -15 : 4))};
+      terms.push_back(cpa::rational{index % 13 - 6, denominator});
+      }
+
+    return terms;
+    }
+
+  std::atomic<int> threads_seen{0};
+
+  struct thread_marker
+    {
+    thread_marker()
+      {
+      ++threads_seen;
+      }
+    };
+
+  void mark_thread()
+    {
+    thread_local thread_marker const marker{};
+    (void)marker;
+    }
+  }
+
+void test_parallel_sum_matches_sequential_sum()
+  {
+  auto const terms = make_terms(100000);
+  auto const expected = cpa::sum(terms.begin(), terms.end());
+
+  for(auto threads : {1u, 2u, 3u, 8u})
+    {
+    auto const result = cpa::parallel::sum(terms.begin(), terms.end(), threads);
+
+    ASSERT_EQUAL(expected.numerator(), result.numerator());
+    ASSERT_EQUAL(expected.denominator(), result.denominator());
+    }
+  }
+
+void test_parallel_sum_of_empty_range()
+  {
+  auto const terms = std::vector<cpa::rational>{};
+  auto const result = cpa::parallel::sum(terms.begin(), terms.end(), 4);
+
+  ASSERT_EQUAL(0, result.numerator());
+  ASSERT_EQUAL(1, result.denominator());
+  }
+
+void test_parallel_sum_reports_overflow()
+  {
+  for(auto count : {std::intmax_t{50}, std::intmax_t{20000}})
+    {
+    auto terms = std::vector<cpa::rational>{};
+
+    for(auto denominator = std::intmax_t{1}; denominator <= count; ++denominator)
+      {
+      terms.push_back(cpa::rational{1, denominator});
+      }
+
+    for(auto threads : {1u, 4u})
+      {
+      ASSERT_THROWS(cpa::parallel::sum(terms.begin(), terms.end(), threads), std::domain_error);
+      }
+    }
+  }
+
+void test_parallel_product_is_deterministic()
+  {
+  auto terms = std::vector<cpa::rational>{};
+
+  for(auto index = std::intmax_t{1}; index <= 50000; ++index)
+    {
+    terms.push_back(cpa::rational{index % 2 ? index : -index, index + 1});
+    }
+
+  auto const single = cpa::parallel::product(terms.begin(), terms.end(), 1);
+  auto const multiple = cpa::parallel::product(terms.begin(), terms.end(), 8);
+
+  ASSERT_EQUAL(1, single.numerator());
+  ASSERT_EQUAL(50001, single.denominator());
+  ASSERT_EQUAL(single.numerator(), multiple.numerator());
+  ASSERT_EQUAL(single.denominator(), multiple.denominator());
+  }
+
+void test_parallel_product_reports_overflow()
+  {
+  auto const terms = std::vector<cpa::basic_rational<int>>(20000, cpa::basic_rational<int>{2});
+
+  ASSERT_THROWS(cpa::parallel::product(terms.begin(), terms.end(), 4), std::domain_error);
+  }
+
+void test_parallel_transform_reduce()
+  {
+  auto const terms = make_terms(30000);
+  auto const square = [](cpa::rational const & value) { return value * value; };
+  auto const add = [](cpa::rational const & lhs, cpa::rational const & rhs) { return lhs + rhs; };
+
+  auto expected = cpa::rational{1, 3};
+  for(auto const & term : terms)
+    {
+    expected = expected + square(term);
+    }
+
+  auto const result = cpa::parallel::transform_reduce(terms.begin(), terms.end(), cpa::rational{1, 3}, add, square, 6);
+
+  ASSERT_EQUAL(expected.reduce().numerator(), result.reduce().numerator());
+  ASSERT_EQUAL(expected.reduce().denominator(), result.reduce().denominator());
+  }
+
+void test_parallel_transform_reduce_propagates_exceptions()
+  {
+  auto const terms = make_terms(30000);
+  auto const invert = [](cpa::rational const & value) { return cpa::rational{1} / value; };
+  auto const add = [](cpa::rational const & lhs, cpa::rational const & rhs) { return lhs + rhs; };
+
+  ASSERT_THROWS(cpa::parallel::transform_reduce(terms.begin(), terms.end(), cpa::rational{}, add, invert, 4), std::domain_error);
+  }
+
+void test_parallel_calls_reuse_threads()
+  {
+  auto const terms = make_terms(70000);
+  auto const add = [](cpa::rational const & lhs, cpa::rational const & rhs) { return lhs + rhs; };
+  auto const marked = [](cpa::rational const & value) { mark_thread(); return value; };
+  auto const expected = cpa::parallel::sum(terms.begin(), terms.end(), 4);
+
+  for(auto call = 0; call < 20; ++call)
+    {
+    auto const result = cpa::parallel::transform_reduce(terms.begin(), terms.end(), cpa::rational{}, add, marked, 4);
+    ASSERT((result == expected));
+    }
+
+  auto const pool_size = cpa::__cpa_thread_pool::instance().reserve(0);
+  ASSERT(static_cast<std::size_t>(threads_seen.load()) <= pool_size + 1);
+  }
+
+void test_nested_parallel_calls()
+  {
+  auto const terms = make_terms(20000);
+  auto const expected = cpa::parallel::sum(terms.begin(), terms.end(), 1);
+  auto const add = [](cpa::rational const & lhs, cpa::rational const & rhs) { return lhs + rhs; };
+  auto const inner = [&](int const value) { return value ? cpa::parallel::sum(terms.begin(), terms.end(), 4) : cpa::rational{}; };
+
+  auto selectors = std::vector<int>(16384);
+  for(std::size_t index{}; index < selectors.size(); index += 2048)
+    {
+    selectors[index] = 1;
+    }
+
+  auto const result = cpa::parallel::transform_reduce(selectors.begin(), selectors.end(), cpa::rational{}, add, inner, 4);
+
+  ASSERT((result == expected * cpa::rational{8}));
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"Parallel sum matches the sequential sum",
+             test_parallel_sum_matches_sequential_sum};
+  suite += T{"Parallel sum of an empty range",
+             test_parallel_sum_of_empty_range};
+  suite += T{"Parallel sum reports overflows",
+             test_parallel_sum_reports_overflow};
+  suite += T{"Parallel product does not depend on the number of threads",
+             test_parallel_product_is_deterministic};
+  suite += T{"Parallel product reports overflows",
+             test_parallel_product_reports_overflow};
+  suite += T{"Parallel transform_reduce",
+             test_parallel_transform_reduce};
+  suite += T{"Parallel transform_reduce propagates exceptions",
+             test_parallel_transform_reduce_propagates_exceptions};
+  suite += T{"Parallel algorithms reuse the threads of the pool",
+             test_parallel_calls_reuse_threads};
+  suite += T{"Parallel algorithms can be nested",
+             test_nested_parallel_calls};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::parallel");
+  }
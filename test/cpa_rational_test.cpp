@@ -5,8 +5,11 @@
 #include <cute/xml_listener.h>
 #include <cute/cute_runner.h>
 
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
+#include <unordered_map>
 
 void test_instantiation_with_single_integral()
   {
@@ -99,8 +102,8 @@ void test_addition_positive_positive_with_same_type_and_denominator()
   auto constexpr r2 = cpa::rational{1, 4};
   auto constexpr r3 = r1 + r2;
 
-  ASSERT_EQUAL(2, r3.numerator());
-  ASSERT_EQUAL(4, r3.denominator());
+  ASSERT_EQUAL(1, r3.numerator());
+  ASSERT_EQUAL(2, r3.denominator());
   }
 
 void test_addition_positive_negative_with_same_type_and_denominator()
@@ -119,8 +122,8 @@ void test_addition_negative_positive_with_same_type_and_denominator()
   auto constexpr r2 = cpa::rational{ 1, 4};
   auto constexpr r3 = r1 + r2;
 
-  ASSERT_EQUAL(-2, r3.numerator());
-  ASSERT_EQUAL( 4, r3.denominator());
+  ASSERT_EQUAL(-1, r3.numerator());
+  ASSERT_EQUAL( 2, r3.denominator());
   }
 
 void test_addition_negative_negative_with_same_type_and_denominator()
@@ -173,6 +176,353 @@ void test_addition_negative_negative_with_same_type_and_different_denominator()
   ASSERT_EQUAL(  8, r3.denominator());
   }
 
+void test_addition_with_large_denominators()
+  {
+  auto constexpr r1 = cpa::rational{1, (std::intmax_t{1} << 40) * 3};
+  auto constexpr r2 = cpa::rational{1, (std::intmax_t{1} << 40) * 5};
+  auto constexpr r3 = r1 + r2;
+
+  ASSERT_EQUAL(1, r3.numerator());
+  ASSERT_EQUAL((std::intmax_t{1} << 37) * 15, r3.denominator());
+  }
+
+void test_addition_with_different_types()
+  {
+  auto constexpr r1 = cpa::basic_rational<int>{1, 6};
+  auto constexpr r2 = cpa::basic_rational<long long>{1, 10};
+  auto constexpr r3 = r1 + r2;
+
+  ASSERT((cpa::is_same_v<cpa::basic_rational<long long> const, decltype(r3)>));
+  ASSERT_EQUAL(4, r3.numerator());
+  ASSERT_EQUAL(15, r3.denominator());
+  }
+
+void test_subtraction_with_same_type_and_different_denominator()
+  {
+  auto constexpr r1 = cpa::rational{5, 6};
+  auto constexpr r2 = cpa::rational{1, 10};
+  auto constexpr r3 = r1 - r2;
+
+  ASSERT_EQUAL(11, r3.numerator());
+  ASSERT_EQUAL(15, r3.denominator());
+  }
+
+void test_subtraction_to_zero()
+  {
+  auto constexpr r1 = cpa::rational{-7, 12};
+  auto constexpr r2 = cpa::rational{-7, 12};
+  auto constexpr r3 = r1 - r2;
+
+  ASSERT_EQUAL(0, r3.numerator());
+  ASSERT_EQUAL(1, r3.denominator());
+  }
+
+void test_negation()
+  {
+  auto constexpr r1 = cpa::rational{3, 8};
+  auto constexpr r2 = -r1;
+
+  ASSERT_EQUAL(-3, r2.numerator());
+  ASSERT_EQUAL( 8, r2.denominator());
+  }
+
+void test_compound_addition_and_subtraction()
+  {
+  auto r1 = cpa::rational{1, 2};
+
+  r1 += cpa::rational{1, 3};
+  ASSERT_EQUAL(5, r1.numerator());
+  ASSERT_EQUAL(6, r1.denominator());
+
+  r1 -= cpa::basic_rational<int>{1, 2};
+  ASSERT_EQUAL(1, r1.numerator());
+  ASSERT_EQUAL(3, r1.denominator());
+  }
+
+void test_multiplication_with_cross_cancellation()
+  {
+  auto constexpr r1 = cpa::rational{4, 9};
+  auto constexpr r2 = cpa::rational{3, 8};
+  auto constexpr r3 = r1 * r2;
+
+  ASSERT_EQUAL(1, r3.numerator());
+  ASSERT_EQUAL(6, r3.denominator());
+  }
+
+void test_multiplication_with_large_values()
+  {
+  auto constexpr big = std::intmax_t{1} << 40;
+  auto constexpr r1 = cpa::rational{big, 3};
+  auto constexpr r2 = cpa::rational{9, big * 5};
+  auto constexpr r3 = r1 * r2;
+
+  ASSERT_EQUAL(3, r3.numerator());
+  ASSERT_EQUAL(5, r3.denominator());
+  }
+
+void test_multiplication_with_different_types()
+  {
+  auto constexpr r1 = cpa::basic_rational<int>{-2, 7};
+  auto constexpr r2 = cpa::basic_rational<long long>{7, 4};
+  auto constexpr r3 = r1 * r2;
+
+  ASSERT((cpa::is_same_v<cpa::basic_rational<long long> const, decltype(r3)>));
+  ASSERT_EQUAL(-1, r3.numerator());
+  ASSERT_EQUAL( 2, r3.denominator());
+  }
+
+void test_multiplication_by_zero()
+  {
+  auto constexpr r1 = cpa::rational{0};
+  auto constexpr r2 = cpa::rational{3, 7};
+  auto constexpr r3 = r1 * r2;
+
+  ASSERT_EQUAL(0, r3.numerator());
+  ASSERT_EQUAL(1, r3.denominator());
+  }
+
+void test_division_with_cross_cancellation()
+  {
+  auto constexpr r1 = cpa::rational{4, 9};
+  auto constexpr r2 = cpa::rational{8, 3};
+  auto constexpr r3 = r1 / r2;
+
+  ASSERT_EQUAL(1, r3.numerator());
+  ASSERT_EQUAL(6, r3.denominator());
+  }
+
+void test_division_by_zero()
+  {
+  ASSERT_THROWS(cpa::rational(1, 2) / cpa::rational(0), std::domain_error);
+  }
+
+void test_compound_multiplication_and_division()
+  {
+  auto r1 = cpa::rational{2, 3};
+
+  r1 *= cpa::rational{9, 4};
+  ASSERT_EQUAL(3, r1.numerator());
+  ASSERT_EQUAL(2, r1.denominator());
+
+  r1 /= cpa::basic_rational<int>{3, 5};
+  ASSERT_EQUAL(5, r1.numerator());
+  ASSERT_EQUAL(2, r1.denominator());
+  }
+
+void test_default_construction_represents_zero()
+  {
+  auto constexpr r1 = cpa::rational{};
+
+  ASSERT_EQUAL(0, r1.numerator());
+  ASSERT_EQUAL(1, r1.denominator());
+  }
+
+void test_manual_normalization_adds_no_state()
+  {
+  ASSERT_EQUAL(2 * sizeof(std::intmax_t), sizeof(cpa::rational));
+  ASSERT(!(cpa::rational{1, 2}.known_canonical()));
+  }
+
+void test_eager_normalization_on_construction()
+  {
+  using rational = cpa::basic_rational<long, cpa::eager_normalization>;
+  auto constexpr r1 = rational{6, -8};
+
+  ASSERT(r1.known_canonical());
+  ASSERT_EQUAL(-3, r1.numerator());
+  ASSERT_EQUAL( 4, r1.denominator());
+  }
+
+void test_eager_normalization_on_arithmetic()
+  {
+  using rational = cpa::basic_rational<long, cpa::eager_normalization>;
+  auto constexpr r1 = rational{1, -6} / rational{-2, 3};
+  auto constexpr r2 = r1.expand(5);
+
+  ASSERT_EQUAL(1, r1.numerator());
+  ASSERT_EQUAL(4, r1.denominator());
+  ASSERT_EQUAL(1, r2.numerator());
+  ASSERT_EQUAL(4, r2.denominator());
+  }
+
+void test_lazy_normalization_defers_reduction()
+  {
+  using rational = cpa::basic_rational<long, cpa::lazy_normalization>;
+  auto r1 = rational{6, 8};
+
+  ASSERT(!r1.known_canonical());
+  ASSERT_EQUAL(6, r1.numerator());
+
+  r1.reduce();
+  ASSERT(r1.known_canonical());
+  ASSERT_EQUAL(3, r1.numerator());
+  ASSERT_EQUAL(4, r1.denominator());
+
+  auto const r2 = r1 + r1;
+  ASSERT(r2.known_canonical());
+  ASSERT_EQUAL(3, r2.numerator());
+  ASSERT_EQUAL(2, r2.denominator());
+  }
+
+void test_lazy_normalization_reduces_above_threshold()
+  {
+  using rational = cpa::basic_rational<std::int64_t, cpa::lazy_normalization>;
+  auto constexpr big = std::int64_t{1} << 40;
+  auto const r1 = rational{big * 3, -big * 2};
+
+  ASSERT(r1.known_canonical());
+  ASSERT_EQUAL(-3, r1.numerator());
+  ASSERT_EQUAL( 2, r1.denominator());
+
+  auto const r2 = rational{4, 6} * rational{5, 7};
+  ASSERT(!r2.known_canonical());
+  }
+
+void test_conversion_between_policies()
+  {
+  auto const r1 = cpa::basic_rational<long, cpa::eager_normalization>{cpa::rational{10, -4}};
+
+  ASSERT_EQUAL(-5, r1.numerator());
+  ASSERT_EQUAL( 2, r1.denominator());
+  }
+
+void test_equality_compares_values()
+  {
+  ASSERT((cpa::rational{2, 4} == cpa::rational{1, 2}));
+  ASSERT((cpa::rational{-1, -2} == cpa::rational{1, 2}));
+  ASSERT((cpa::rational{3, -6} == cpa::rational{-1, 2}));
+  ASSERT((cpa::rational{0, 5} == cpa::rational{0, -3}));
+  ASSERT((cpa::rational{1, 2} != cpa::rational{-1, 2}));
+  ASSERT((cpa::rational{1, 3} != cpa::rational{1, 2}));
+  ASSERT((cpa::rational{7, 3} == cpa::rational{7, 3}));
+  }
+
+void test_equality_with_different_types()
+  {
+  ASSERT((cpa::basic_rational<int>{-2, 4} == cpa::basic_rational<long>{1, -2}));
+  ASSERT((cpa::basic_rational<int>{-1} != cpa::basic_rational<unsigned>{4294967295u}));
+  ASSERT((cpa::basic_rational<std::uint8_t>{200, 100} == cpa::basic_rational<long>{2}));
+  }
+
+void test_hash_uses_canonical_form()
+  {
+  auto const hash = std::hash<cpa::rational>{};
+
+  ASSERT_EQUAL(hash(cpa::rational{1, 2}), hash(cpa::rational{2, 4}));
+  ASSERT_EQUAL(hash(cpa::rational{1, 2}), hash(cpa::rational{-3, -6}));
+  ASSERT_EQUAL(hash(cpa::rational{-1, 2}), hash(cpa::rational{1, -2}));
+  ASSERT_EQUAL(hash(cpa::rational{0, 1}), hash(cpa::rational{0, -7}));
+  ASSERT(hash(cpa::rational{1, 2}) != hash(cpa::rational{2, 1}));
+  ASSERT(hash(cpa::rational{1, 2}) != hash(cpa::rational{-1, 2}));
+  }
+
+void test_equality_and_hash_with_most_negative_denominator()
+  {
+  using rational = cpa::basic_rational<std::int64_t>;
+  auto constexpr minimum = std::numeric_limits<std::int64_t>::min();
+  auto const hash = std::hash<rational>{};
+
+  ASSERT((rational{1, minimum} != rational{1, 3}));
+  ASSERT((rational{1, minimum} != rational{-1, minimum}));
+  ASSERT((rational{2, minimum} == rational{-1, std::int64_t{1} << 62}));
+  ASSERT((rational{minimum, minimum} == rational{1}));
+  ASSERT((rational{0, minimum} == rational{0}));
+  ASSERT_EQUAL(hash(rational{2, minimum}), hash(rational{-1, std::int64_t{1} << 62}));
+  ASSERT(hash(rational{1, minimum}) != hash(rational{-1, minimum}));
+  }
+
+void test_rationals_as_unordered_map_keys()
+  {
+  using key_t = cpa::basic_rational<long, cpa::eager_normalization>;
+
+  auto counts = std::unordered_map<key_t, int>{};
+
+  for(auto denominator = 1l; denominator <= 100; ++denominator)
+    {
+    for(auto numerator = 0l; numerator <= denominator; ++numerator)
+      {
+      ++counts[key_t{numerator, denominator}];
+      }
+    }
+
+  ASSERT_EQUAL(50, (counts[key_t{1, 2}]));
+  ASSERT_EQUAL(33, (counts[key_t{2, 3}]));
+  ASSERT_EQUAL(1, (counts[key_t{99, 100}]));
+  ASSERT_EQUAL(3045u, counts.size());
+  }
+
+void test_ordering_of_rationals()
+  {
+  ASSERT((cpa::rational{1, 3} < cpa::rational{1, 2}));
+  ASSERT((cpa::rational{1, -2} < cpa::rational{1, 3}));
+  ASSERT((cpa::rational{-1, -2} > cpa::rational{1, 3}));
+  ASSERT((cpa::rational{2, 4} <= cpa::rational{1, 2}));
+  ASSERT((cpa::rational{2, 4} >= cpa::rational{-1, -2}));
+  ASSERT((cpa::rational{0, -3} >= cpa::rational{0, 5}));
+  ASSERT(!(cpa::rational{0, -3} < cpa::rational{0, 5}));
+  ASSERT((cpa::rational{-7, 3} < cpa::rational{-2, 1}));
+  }
+
+void test_ordering_near_the_limits_of_the_representation()
+  {
+  auto const max = std::numeric_limits<std::int64_t>::max();
+  auto const min = std::numeric_limits<std::int64_t>::min();
+
+  ASSERT((cpa::basic_rational<std::int64_t>{max - 1, max} < cpa::basic_rational<std::int64_t>{max, max - 1}));
+  ASSERT((cpa::basic_rational<std::int64_t>{max - 2, max - 1} < cpa::basic_rational<std::int64_t>{max - 1, max}));
+  ASSERT((cpa::basic_rational<std::int64_t>{min, max} < cpa::basic_rational<std::int64_t>{-1}));
+  ASSERT((cpa::basic_rational<std::int64_t>{min, 1} < cpa::basic_rational<std::int64_t>{-max, 1}));
+
+#if defined(__SIZEOF_INT128__)
+  using int128 = cpa::__cpa_int128;
+
+  auto const huge = ~(static_cast<cpa::__cpa_uint128>(1) << 127);
+  auto const large = static_cast<int128>(huge);
+
+  ASSERT((cpa::basic_rational<int128>{large - 1, large} > cpa::basic_rational<int128>{large - 2, large - 1}));
+  ASSERT((cpa::basic_rational<int128>{large - 2, large - 1} < cpa::basic_rational<int128>{large - 1, large}));
+  ASSERT((cpa::basic_rational<int128>{-large, large - 1} < cpa::basic_rational<int128>{-large + 1, large}));
+  ASSERT((cpa::basic_rational<int128>{large / 3, large} <= cpa::basic_rational<int128>{large / 3, large}));
+#endif
+  }
+
+void test_ordering_with_different_types()
+  {
+  ASSERT((cpa::basic_rational<int>{-1} < cpa::basic_rational<unsigned>{1}));
+  ASSERT((cpa::basic_rational<unsigned>{4294967295u} > cpa::basic_rational<int>{-1}));
+  ASSERT((cpa::basic_rational<short>{1, 3} < cpa::basic_rational<long long>{1, 2}));
+  }
+
+void test_abs_of_rational()
+  {
+  static_assert(cpa::is_lessthan_comparable_v<cpa::rational>, "rationals must be less-than comparable");
+  static_assert(cpa::is_signed_v<cpa::rational>, "rationals with a signed representation must be signed");
+
+  auto const value = cpa::abs(cpa::rational{3, -4});
+
+  ASSERT((value == cpa::rational{3, 4}));
+  ASSERT((cpa::abs(cpa::rational{3, 4}) == cpa::rational{3, 4}));
+  }
+
+void test_common_and_expand_with_narrow_representations()
+  {
+  auto const third = cpa::basic_rational<std::int8_t>{1, 3};
+  auto const common = third.common(cpa::basic_rational<std::int8_t>{1, 4});
+  auto const expanded = third.expand(std::int8_t{-20});
+
+  ASSERT_EQUAL(4, common.numerator());
+  ASSERT_EQUAL(12, common.denominator());
+  ASSERT_EQUAL(-20, expanded.numerator());
+  ASSERT_EQUAL(-60, expanded.denominator());
+
+  auto const tenth = cpa::basic_rational<std::int16_t>{3, 10};
+  auto const wide = tenth.common(cpa::basic_rational<std::int16_t>{1, 1024});
+
+  ASSERT_EQUAL(1536, wide.numerator());
+  ASSERT_EQUAL(5120, wide.denominator());
+  ASSERT((tenth.expand(std::int16_t{1000}) == tenth));
+  }
+
 int main(int argc, char * argv[])
   {
   auto suite = cute::suite{};
@@ -217,6 +567,71 @@ int main(int argc, char * argv[])
   suite += T{"Add two negative rationals with the same representation but different denominators",
              test_addition_negative_negative_with_same_type_and_different_denominator};
 
+  suite += T{"Add two rationals with large denominators sharing a common factor",
+             test_addition_with_large_denominators};
+  suite += T{"Add two rationals with different representations",
+             test_addition_with_different_types};
+  suite += T{"Subtract two rationals with the same representation but different denominators",
+             test_subtraction_with_same_type_and_different_denominator};
+  suite += T{"Subtract a rational from itself",
+             test_subtraction_to_zero};
+  suite += T{"Negate a rational",
+             test_negation};
+  suite += T{"Add and subtract rationals in place",
+             test_compound_addition_and_subtraction};
+
+  suite += T{"Multiply two rationals with common factors",
+             test_multiplication_with_cross_cancellation};
+  suite += T{"Multiply two rationals whose naive product would overflow",
+             test_multiplication_with_large_values};
+  suite += T{"Multiply two rationals with different representations",
+             test_multiplication_with_different_types};
+  suite += T{"Multiply a rational by zero",
+             test_multiplication_by_zero};
+  suite += T{"Divide two rationals with common factors",
+             test_division_with_cross_cancellation};
+  suite += T{"Divide a rational by zero",
+             test_division_by_zero};
+  suite += T{"Multiply and divide rationals in place",
+             test_compound_multiplication_and_division};
+
+  suite += T{"Default construct a rational",
+             test_default_construction_represents_zero};
+  suite += T{"Manual normalization adds no state to a rational",
+             test_manual_normalization_adds_no_state};
+  suite += T{"Eager normalization canonicalizes on construction",
+             test_eager_normalization_on_construction};
+  suite += T{"Eager normalization keeps the results of arithmetic canonical",
+             test_eager_normalization_on_arithmetic};
+  suite += T{"Lazy normalization defers reduction and remembers canonical forms",
+             test_lazy_normalization_defers_reduction};
+  suite += T{"Lazy normalization reduces results above the threshold",
+             test_lazy_normalization_reduces_above_threshold};
+  suite += T{"Convert a rational to a different normalization policy",
+             test_conversion_between_policies};
+
+  suite += T{"Rationals compare equal iff their values are equal",
+             test_equality_compares_values};
+  suite += T{"Compare rationals with different representations for equality",
+             test_equality_with_different_types};
+  suite += T{"Hash rationals by their canonical form",
+             test_hash_uses_canonical_form};
+  suite += T{"Compare and hash rationals with the most negative denominator",
+             test_equality_and_hash_with_most_negative_denominator};
+  suite += T{"Use rationals as keys of an unordered_map",
+             test_rationals_as_unordered_map_keys};
+
+  suite += T{"Order rationals by their values",
+             test_ordering_of_rationals};
+  suite += T{"Order rationals near the limits of their representation",
+             test_ordering_near_the_limits_of_the_representation};
+  suite += T{"Order rationals with different representations",
+             test_ordering_with_different_types};
+  suite += T{"Calculate the absolute value of a rational",
+             test_abs_of_rational};
+  suite += T{"Expand 8-bit and 16-bit rationals",
+             test_common_and_expand_with_narrow_representations};
+
   auto file = cute::xml_file_opener{argc, argv};
   auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
 
@@ -0,0 +1,230 @@
+#include <rational_vector.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace
+  {
+  __extension__ typedef __int128 int128;
+  __extension__ typedef unsigned __int128 uint128;
+  }
+
+void test_rational_vector_stores_aligned_arrays()
+  {
+  auto values = cpa::rational_vector<std::int64_t>{};
+
+  for(auto index = std::int64_t{1}; index <= 100; ++index)
+    {
+    values.push_back(cpa::basic_rational<std::int64_t>{index, index + 1});
+    }
+
+  ASSERT_EQUAL(100u, values.size());
+  ASSERT_EQUAL(0u, reinterpret_cast<std::uintptr_t>(values.numerators()) % values.alignment);
+  ASSERT_EQUAL(0u, reinterpret_cast<std::uintptr_t>(values.denominators()) % values.alignment);
+  ASSERT_EQUAL(42, values.numerators()[41]);
+  ASSERT_EQUAL(43, values.denominators()[41]);
+  }
+
+void test_rational_vector_proxy_access()
+  {
+  auto values = cpa::rational_vector<int>{};
+  values.push_back(cpa::basic_rational<int>{1, 2});
+  values.push_back(cpa::basic_rational<int>{3, 4});
+
+  values[0] = cpa::basic_rational<int>{5, 6};
+  values[1] = values[0];
+  cpa::basic_rational<int> const r1 = values[1];
+
+  ASSERT_EQUAL(5, values[0].numerator());
+  ASSERT_EQUAL(6, values[0].denominator());
+  ASSERT_EQUAL(5, r1.numerator());
+  ASSERT_EQUAL(6, r1.denominator());
+  }
+
+void test_rational_vector_bulk_reduce()
+  {
+  auto values = cpa::rational_vector<std::int64_t>{};
+
+  for(auto index = std::int64_t{1}; index < 1000; ++index)
+    {
+    values.push_back(cpa::basic_rational<std::int64_t>{index * 6 * (index % 3 ? 1 : -1), index * 4 + 2});
+    }
+
+  values.reduce();
+
+  for(auto index = std::int64_t{1}; index < 1000; ++index)
+    {
+    auto const expected = cpa::basic_rational<std::int64_t>{index * 6 * (index % 3 ? 1 : -1), index * 4 + 2}.reduce();
+    cpa::basic_rational<std::int64_t> const element = values[static_cast<std::size_t>(index - 1)];
+
+    ASSERT_EQUAL(expected.numerator(), element.numerator());
+    ASSERT_EQUAL(expected.denominator(), element.denominator());
+    }
+  }
+
+void test_rational_vector_add_and_scale()
+  {
+  auto values = cpa::rational_vector<int>{};
+  values.push_back(cpa::basic_rational<int>{1, 2});
+  values.push_back(cpa::basic_rational<int>{-2, 3});
+
+  values.add(cpa::basic_rational<int>{1, 6}).scale(cpa::basic_rational<int>{3, -2});
+
+  ASSERT_EQUAL(-1, values[0].numerator());
+  ASSERT_EQUAL(1, values[0].denominator());
+  ASSERT_EQUAL(3, values[1].numerator());
+  ASSERT_EQUAL(4, values[1].denominator());
+  }
+
+void test_rational_vector_common_denominator()
+  {
+  auto values = cpa::rational_vector<int>{};
+  values.push_back(cpa::basic_rational<int>{1, 2});
+  values.push_back(cpa::basic_rational<int>{1, -3});
+  values.push_back(cpa::basic_rational<int>{5, 4});
+
+  values.unify_denominators();
+
+  ASSERT(values.has_common_denominator());
+  ASSERT_EQUAL(12, values.common_denominator());
+  ASSERT_EQUAL(6, values[0].numerator());
+  ASSERT_EQUAL(-4, values[1].numerator());
+  ASSERT_EQUAL(15, values[2].numerator());
+
+  values.add(cpa::basic_rational<int>{1, 12});
+  ASSERT_EQUAL(12, values.common_denominator());
+  ASSERT_EQUAL(7, values[0].numerator());
+
+  values.add(cpa::basic_rational<int>{1, 8});
+  ASSERT_EQUAL(24, values.common_denominator());
+  ASSERT_EQUAL(17, values[0].numerator());
+
+  values.scale(cpa::basic_rational<int>{2, 5});
+  ASSERT_EQUAL(120, values.common_denominator());
+  ASSERT_EQUAL(34, values[0].numerator());
+  }
+
+void test_rational_vector_most_negative_denominator()
+  {
+  using rational = cpa::basic_rational<std::int64_t>;
+  auto constexpr minimum = std::numeric_limits<std::int64_t>::min();
+
+  auto values = cpa::rational_vector<std::int64_t>{};
+  values.push_back(rational{2, minimum});
+  values.push_back(rational{1, 2});
+
+  values.unify_denominators();
+
+  ASSERT_EQUAL(std::int64_t{1} << 62, values.common_denominator());
+  ASSERT_EQUAL(-1, values[0].numerator());
+  ASSERT_EQUAL(std::int64_t{1} << 61, values[1].numerator());
+
+  values.add(rational{minimum, minimum});
+  ASSERT_EQUAL(std::int64_t{1} << 62, values.common_denominator());
+  ASSERT_EQUAL((std::int64_t{1} << 62) - 1, values[0].numerator());
+
+  auto factors = cpa::rational_vector<std::int64_t>{};
+  factors.push_back(rational{3});
+  factors.scale(rational{-2, minimum});
+  ASSERT_EQUAL(3, factors[0].numerator());
+  ASSERT_EQUAL(std::int64_t{1} << 62, factors[0].denominator());
+
+  ASSERT_THROWS(values.add(rational{1, minimum}), std::domain_error);
+  ASSERT_THROWS(factors.scale(rational{1, minimum}), std::domain_error);
+
+  factors.push_back(rational{1, minimum});
+  ASSERT_THROWS(factors.unify_denominators(), std::domain_error);
+  }
+
+void test_rational_vector_add_vectors_with_common_denominators()
+  {
+  auto lhs = cpa::rational_vector<int>{};
+  auto rhs = cpa::rational_vector<int>{};
+  lhs.push_back(cpa::basic_rational<int>{1, 4});
+  lhs.push_back(cpa::basic_rational<int>{3, 4});
+  rhs.push_back(cpa::basic_rational<int>{1, 6});
+  rhs.push_back(cpa::basic_rational<int>{-1, 6});
+  lhs.unify_denominators();
+  rhs.unify_denominators();
+
+  lhs.add(rhs);
+
+  ASSERT(lhs.has_common_denominator());
+  ASSERT_EQUAL(12, lhs.common_denominator());
+  ASSERT_EQUAL(5, lhs[0].numerator());
+  ASSERT_EQUAL(7, lhs[1].numerator());
+
+  rhs.push_back(cpa::basic_rational<int>{1, 5});
+  ASSERT(!rhs.has_common_denominator());
+  ASSERT_THROWS(lhs.add(rhs), std::domain_error);
+  }
+
+void test_rational_vector_compare()
+  {
+  auto values = cpa::rational_vector<std::int64_t>{};
+  values.push_back(cpa::basic_rational<std::int64_t>{1, 3});
+  values.push_back(cpa::basic_rational<std::int64_t>{2, 4});
+  values.push_back(cpa::basic_rational<std::int64_t>{-5, -6});
+  values.push_back(cpa::basic_rational<std::int64_t>{-9223372036854775807, 2});
+
+  auto order = std::vector<int>(values.size());
+  values.compare(cpa::basic_rational<std::int64_t>{-1, -2}, order.begin());
+
+  ASSERT_EQUAL((std::vector<int>{-1, 0, 1, -1}), order);
+  }
+
+void test_rational_vector_compare_without_wider_type()
+  {
+  auto const maximum = static_cast<int128>(~uint128{0} >> 1);
+
+  auto values = cpa::rational_vector<int128>{};
+  values.push_back(cpa::basic_rational<int128>{maximum - 2, maximum - 1});
+  values.push_back(cpa::basic_rational<int128>{maximum, maximum - 1});
+  values.push_back(cpa::basic_rational<int128>{-maximum, maximum - 2});
+  values.push_back(cpa::basic_rational<int128>{maximum - 1, maximum});
+
+  auto order = std::vector<int>(values.size());
+  values.compare(cpa::basic_rational<int128>{maximum - 1, maximum}, order.begin());
+
+  ASSERT_EQUAL((std::vector<int>{-1, 1, -1, 0}), order);
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"rational_vector stores numerators and denominators in aligned arrays",
+             test_rational_vector_stores_aligned_arrays};
+  suite += T{"Access rational_vector elements through proxies",
+             test_rational_vector_proxy_access};
+  suite += T{"Reduce all elements of a rational_vector",
+             test_rational_vector_bulk_reduce};
+  suite += T{"Add a scalar to and scale all elements of a rational_vector",
+             test_rational_vector_add_and_scale};
+  suite += T{"Record a common denominator in a rational_vector",
+             test_rational_vector_common_denominator};
+  suite += T{"Expand rational_vector elements with the most negative denominator",
+             test_rational_vector_most_negative_denominator};
+  suite += T{"Add rational_vectors with common denominators",
+             test_rational_vector_add_vectors_with_common_denominators};
+  suite += T{"Compare all elements of a rational_vector to a scalar",
+             test_rational_vector_compare};
+  suite += T{"rational_vector compares 128-bit elements exactly",
+             test_rational_vector_compare_without_wider_type};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::rational_vector");
+  }
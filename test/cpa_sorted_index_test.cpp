@@ -0,0 +1,114 @@
+#include <sorted_index.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace
+  {
+  std::vector<cpa::rational> make_values()
+    {
+    auto values = std::vector<cpa::rational>{};
+
+    for(auto denominator = std::intmax_t{1}; denominator <= 40; ++denominator)
+      {
+      for(auto numerator = -denominator; numerator <= denominator; ++numerator)
+        {
+        values.push_back(cpa::rational{numerator, denominator});
+        }
+      }
+
+    return values;
+    }
+  }
+
+void test_sorted_index_is_sorted()
+  {
+  auto const values = make_values();
+  auto const index = cpa::sorted_index<std::intmax_t>{values.begin(), values.end()};
+
+  ASSERT_EQUAL(values.size(), index.size());
+
+  for(std::size_t position{1}; position < index.size(); ++position)
+    {
+    ASSERT((index[position - 1] <= index[position]));
+    }
+  }
+
+void test_sorted_index_lower_and_upper_bound()
+  {
+  auto const values = make_values();
+  auto const index = cpa::sorted_index<std::intmax_t>{values.begin(), values.end()};
+
+  auto const keys = std::vector<cpa::rational>{cpa::rational{1, 2}, cpa::rational{-1}, cpa::rational{1}, cpa::rational{7, 41},
+                                               cpa::rational{-100}, cpa::rational{100}, cpa::rational{3, -6}};
+
+  for(auto const & key : keys)
+    {
+    auto const lower = index.lower_bound(key);
+    auto const upper = index.upper_bound(key);
+    auto const expected_lower = std::count_if(values.begin(), values.end(), [&](cpa::rational const & value)
+                                                                                { return value < key; });
+    auto const expected_upper = std::count_if(values.begin(), values.end(), [&](cpa::rational const & value)
+                                                                                { return value <= key; });
+
+    ASSERT_EQUAL(expected_lower, lower - index.begin());
+    ASSERT_EQUAL(expected_upper, upper - index.begin());
+    }
+  }
+
+void test_sorted_index_lookup_among_equal_keys()
+  {
+  auto const base = std::intmax_t{1} << 62;
+  auto values = std::vector<cpa::rational>{};
+
+  for(auto offset = std::intmax_t{}; offset < 100; offset += 2)
+    {
+    values.push_back(cpa::rational{base + offset, base});
+    }
+
+  auto const index = cpa::sorted_index<std::intmax_t>{values.begin(), values.end()};
+
+  ASSERT_EQUAL(21, index.lower_bound(cpa::rational{base + 41, base}) - index.begin());
+  ASSERT_EQUAL(21, index.lower_bound(cpa::rational{base + 42, base}) - index.begin());
+  ASSERT_EQUAL(22, index.upper_bound(cpa::rational{base + 42, base}) - index.begin());
+  ASSERT((index.find(cpa::rational{base + 41, base}) == index.end()));
+  ASSERT((*index.find(cpa::rational{base + 42, base}) == cpa::rational{base + 42, base}));
+  }
+
+void test_empty_sorted_index()
+  {
+  auto const index = cpa::sorted_index<int>{};
+
+  ASSERT(index.empty());
+  ASSERT((index.lower_bound(cpa::basic_rational<int>{1, 2}) == index.end()));
+  ASSERT((index.find(cpa::basic_rational<int>{1, 2}) == index.end()));
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"A sorted_index holds its elements in ascending order",
+             test_sorted_index_is_sorted};
+  suite += T{"Find the lower and upper bounds of keys in a sorted_index",
+             test_sorted_index_lower_and_upper_bound};
+  suite += T{"Find keys among elements with equal doubles in a sorted_index",
+             test_sorted_index_lookup_among_equal_keys};
+  suite += T{"Look up keys in an empty sorted_index",
+             test_empty_sorted_index};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::sorted_index");
+  }
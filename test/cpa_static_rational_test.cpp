@@ -0,0 +1,155 @@
+#include <static_rational.h>
+
+#include <cute/cute.h>
+#include <cute/ide_listener.h>
+#include <cute/xml_listener.h>
+#include <cute/cute_runner.h>
+
+#include <cstdint>
+#include <ratio>
+#include <stdexcept>
+
+void test_static_rational_is_reduced_at_compile_time()
+  {
+  using r1 = cpa::static_rational<6, -8>;
+
+  static_assert(r1::num == -3, "numerator of 6/-8 must be -3");
+  static_assert(r1::den == 4, "denominator of 6/-8 must be 4");
+  static_assert(cpa::is_same_v<r1::type, cpa::static_rational<-3, 4>>, "6/-8 must be canonicalized to -3/4");
+  static_assert(cpa::static_rational<0, -5>::den == 1, "0/-5 must be canonicalized to 0/1");
+
+  ASSERT_EQUAL(-3, r1::numerator());
+  ASSERT_EQUAL(4, r1::denominator());
+  }
+
+void test_static_rational_interoperates_with_std_ratio()
+  {
+  static_assert(cpa::is_same_v<cpa::static_rational_from_ratio<std::milli>, cpa::static_rational<1, 1000>>,
+                "std::milli must map to 1/1000");
+  static_assert(std::ratio_equal<cpa::static_rational<10, 4>::ratio, std::ratio<5, 2>>::value,
+                "10/4 must map to std::ratio<5, 2>");
+  }
+
+void test_static_rational_arithmetic_at_compile_time()
+  {
+  constexpr auto third = cpa::static_rational<1, 3>{};
+  constexpr auto sixth = cpa::static_rational<1, 6>{};
+
+  static_assert(third + sixth == cpa::static_rational<1, 2>{}, "1/3 + 1/6 must be 1/2");
+  static_assert(third - sixth == sixth, "1/3 - 1/6 must be 1/6");
+  static_assert(third * sixth == cpa::static_rational<1, 18>{}, "1/3 * 1/6 must be 1/18");
+  static_assert(third / sixth == cpa::static_rational<2>{}, "1/3 / 1/6 must be 2");
+  static_assert(-third / -sixth == cpa::static_rational<2>{}, "-1/3 / -1/6 must be 2");
+  static_assert(third != sixth, "1/3 must not be equal to 1/6");
+  }
+
+void test_static_rational_converts_to_basic_rational()
+  {
+  auto const r1 = static_cast<cpa::rational>(cpa::static_rational<-4, 6>{});
+  auto const r2 = static_cast<cpa::basic_rational<int, cpa::lazy_normalization>>(cpa::static_rational<3, 9>{});
+
+  ASSERT_EQUAL(-2, r1.numerator());
+  ASSERT_EQUAL(3, r1.denominator());
+  ASSERT(r2.known_canonical());
+  ASSERT_EQUAL(1, r2.numerator());
+  ASSERT_EQUAL(3, r2.denominator());
+  }
+
+void test_multiply_rational_by_static_rational()
+  {
+  auto const r1 = cpa::rational{3, 500} * cpa::static_rational<250, 9>{};
+  auto const r2 = cpa::static_rational<-1, 1024>{} * cpa::rational{96, 7};
+  auto const r3 = cpa::rational{7, 11} * cpa::static_rational<0>{};
+
+  ASSERT_EQUAL(1, r1.numerator());
+  ASSERT_EQUAL(6, r1.denominator());
+  ASSERT_EQUAL(-3, r2.numerator());
+  ASSERT_EQUAL(224, r2.denominator());
+  ASSERT_EQUAL(0, r3.numerator());
+  ASSERT_EQUAL(1, r3.denominator());
+  }
+
+void test_divide_rational_by_static_rational()
+  {
+  auto const r1 = cpa::rational{3, 8} / cpa::static_rational<-9, 4>{};
+  auto const r2 = cpa::static_rational<1, 1000>{} / cpa::rational{1, 250};
+
+  ASSERT_EQUAL(-1, r1.numerator());
+  ASSERT_EQUAL(6, r1.denominator());
+  ASSERT_EQUAL(1, r2.numerator());
+  ASSERT_EQUAL(4, r2.denominator());
+  ASSERT_THROWS((cpa::static_rational<1, 2>{} / cpa::rational{0}), std::domain_error);
+  }
+
+void test_add_static_rational_to_rational()
+  {
+  auto const r1 = cpa::rational{1, 6} + cpa::static_rational<1, 10>{};
+  auto const r2 = cpa::rational{1, 7} + cpa::static_rational<1, 3>{};
+  auto const r3 = cpa::rational{5, 12} - cpa::static_rational<1, 12>{};
+  auto const r4 = cpa::static_rational<1>{} - cpa::rational{1, 4};
+
+  ASSERT_EQUAL(4, r1.numerator());
+  ASSERT_EQUAL(15, r1.denominator());
+  ASSERT_EQUAL(10, r2.numerator());
+  ASSERT_EQUAL(21, r2.denominator());
+  ASSERT_EQUAL(1, r3.numerator());
+  ASSERT_EQUAL(3, r3.denominator());
+  ASSERT_EQUAL(3, r4.numerator());
+  ASSERT_EQUAL(4, r4.denominator());
+  }
+
+void test_static_rational_arithmetic_matches_runtime_arithmetic()
+  {
+  using value_t = cpa::basic_rational<std::int64_t, cpa::eager_normalization>;
+
+  for(auto numerator = std::int64_t{-40}; numerator <= 40; ++numerator)
+    {
+    for(auto denominator = std::int64_t{1}; denominator <= 40; ++denominator)
+      {
+      auto const value = value_t{numerator, denominator};
+      auto const constant = static_cast<value_t>(cpa::static_rational<-12, 35>{});
+
+      auto const sum = value + cpa::static_rational<-12, 35>{};
+      auto const product = value * cpa::static_rational<-12, 35>{};
+      auto const quotient = value / cpa::static_rational<-12, 35>{};
+
+      ASSERT_EQUAL((value + constant).numerator(), sum.numerator());
+      ASSERT_EQUAL((value + constant).denominator(), sum.denominator());
+      ASSERT_EQUAL((value * constant).numerator(), product.numerator());
+      ASSERT_EQUAL((value * constant).denominator(), product.denominator());
+      ASSERT_EQUAL((value / constant).numerator(), quotient.numerator());
+      ASSERT_EQUAL((value / constant).denominator(), quotient.denominator());
+      }
+    }
+  }
+
+int main(int argc, char * argv[])
+  {
+  auto suite = cute::suite{};
+
+  using T = cute::test;
+
+  suite += T{"static_rational is reduced at compile time",
+             test_static_rational_is_reduced_at_compile_time};
+  suite += T{"static_rational interoperates with std::ratio",
+             test_static_rational_interoperates_with_std_ratio};
+  suite += T{"Arithmetic on static_rational at compile time",
+             test_static_rational_arithmetic_at_compile_time};
+  suite += T{"Convert static_rational to basic_rational",
+             test_static_rational_converts_to_basic_rational};
+  suite += T{"Multiply rational by static_rational",
+             test_multiply_rational_by_static_rational};
+  suite += T{"Divide rational by static_rational",
+             test_divide_rational_by_static_rational};
+  suite += T{"Add static_rational to rational",
+             test_add_static_rational_to_rational};
+  suite += T{"Arithmetic with static_rational matches runtime arithmetic",
+             test_static_rational_arithmetic_matches_runtime_arithmetic};
+
+  auto file = cute::xml_file_opener{argc, argv};
+  auto listener = cute::xml_listener<cute::ide_listener<>>{file.out};
+
+  auto runner = cute::makeRunner(listener, argc, argv);
+
+  return !runner(suite, "CPA::static_rational");
+  }
@@ -0,0 +1,40 @@
+#include <loader.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+
+/*
+ * Load a file containing one rational number per line and report the number of values and the achieved throughput.
+ *
+ * Usage: cpa_load <file> [threads]
+ */
+int main(int argc, char * argv[])
+  {
+  if(argc < 2 || argc > 3)
+    {
+    std::fprintf(stderr, "usage: %s <file> [threads]\n", argv[0]);
+    return EXIT_FAILURE;
+    }
+
+  auto const threads = argc == 3 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10))
+                                 : cpa::parallel::__cpa_default_threads();
+
+  try
+    {
+    auto const start = std::chrono::steady_clock::now();
+    auto const values = cpa::parallel::load(argv[1], threads);
+    auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("values:     %zu\n", values.size());
+    std::printf("threads:    %u\n", threads);
+    std::printf("seconds:    %.6f\n", elapsed);
+    std::printf("values/s:   %.0f\n", elapsed > 0 ? static_cast<double>(values.size()) / elapsed : 0.0);
+    }
+  catch(std::exception const & error)
+    {
+    std::fprintf(stderr, "%s: %s\n", argv[1], error.what());
+    return EXIT_FAILURE;
+    }
+  }